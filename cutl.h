@@ -31,17 +31,110 @@
 #define CUTL_H
 
 
+// Some features (parallel execution, isolation, timing...) rely on POSIX
+// functions that glibc hides when compiling with a strict standard such as
+// '-std=c99'. Request them here, which only works when CutL is included
+// before any system header. Otherwise, define _DEFAULT_SOURCE yourself or
+// those features are disabled (see the feature test below).
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+    #define _DEFAULT_SOURCE
+#endif
+
+
 #include <stdio.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <setjmp.h>
+#include <math.h>
+#include <float.h>
+#include <errno.h>
+
+
+// POSIX systems get process-based features. On other platforms, or when the
+// system headers hide the POSIX extensions CutL needs (a header included
+// before CutL with a strict '-std=c99' and no _DEFAULT_SOURCE), they fall
+// back to the plain sequential behaviour.
+#if defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <signal.h>
+    #include <netdb.h>
+
+    #if defined(_POSIX_VERSION) && _POSIX_VERSION >= 200112L \
+        && defined(MAP_ANONYMOUS) && defined(SA_RESTART) && defined(AI_PASSIVE)
+        #define _CUTL_POSIX 1
+    #else
+        #define _CUTL_POSIX 0
+
+        #if defined(__GNUC__) || defined(__clang__)
+            #pragma message("CutL: POSIX extensions are hidden, define _DEFAULT_SOURCE before including any header to run tests in parallel or isolated")
+        #endif
+    #endif
+#else
+    #define _CUTL_POSIX 0
+#endif
+
+#if _CUTL_POSIX
+    #include <time.h>
+    #include <sys/resource.h>
+    #include <sys/types.h>
+    #include <sys/wait.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <poll.h>
+    #include <fcntl.h>
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <sys/time.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+
+    #if defined(__linux__)
+        #include <sys/syscall.h>
+    #endif
+#else
+    #include <time.h>
+#endif
+
+
+// CPU event counters (CUTL_FLAG_PERF) are only available on Linux
+#if _CUTL_POSIX && defined(__linux__) && defined(SYS_perf_event_open)
+    #include <linux/perf_event.h>
+
+    #define _CUTL_PERF 1
+#else
+    #define _CUTL_PERF 0
+#endif
 
 
 #define CUTL_VERSION    "3.4.0"
 
 
+// Allocation tracking is opt-in: define CUTL_TRACK_ALLOC before including
+// this header. malloc, calloc, realloc, free and the aligned allocators
+// are then replaced by ones that count what each test allocates, and
+// forward to glibc. With CUTL_ALLOC_WRAP, they are defined as __wrap_malloc
+// and so on instead, for linking with
+// '-Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc,--wrap=free' where
+// replacing them is not possible. Blocks from aligned allocators are not
+// counted then.
+#if defined(CUTL_TRACK_ALLOC) && (defined(CUTL_ALLOC_WRAP) || defined(__GLIBC__))
+    #define _CUTL_TRACK_ALLOC 1
+
+    #if defined(__GLIBC__)
+        #include <malloc.h>
+    #endif
+#else
+    #define _CUTL_TRACK_ALLOC 0
+#endif
+
+
 
 // Mark CutL functions that may not be used as such. This helps reduce
 // compilation noise and allows the programmer to use '-Werror' without
@@ -63,29 +156,142 @@
 #endif
 
 
+// Functions called back by code built with -fsanitize-coverage must not
+// be instrumented themselves, or they would call back into themselves.
+#if defined(__clang__)
+    #define __CUTL_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && __GNUC__ >= 12
+    #define __CUTL_NO_COVERAGE __attribute__((no_sanitize_coverage))
+#else
+    #define __CUTL_NO_COVERAGE
+#endif
+
+
+// Thread-local storage, which C only has since C11. Without it, threads
+// cannot be told apart and only the thread running the tests can use the
+// CUTL_THREAD_ASSERT* macros.
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+    #define _CUTL_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+    #define _CUTL_THREAD_LOCAL __thread
+#else
+    #define _CUTL_THREAD_LOCAL
+#endif
+
+
+// Functions only called when a test fails. Compilers keep the calls to them
+// out of the way of the code that checks the assertions.
+#if defined(__GNUC__) || defined(__clang__)
+    #define __CUTL_COLD __attribute__((cold))
+#else
+    #define __CUTL_COLD
+#endif
+
+
+// Split mode
+//
+// By default, every file that includes this header gets a whole copy of
+// CutL of its own, all of it static. With tests spread over many files,
+// CUTL_SPLIT can be defined in all of them (e.g. with -DCUTL_SPLIT), and
+// CUTL_IMPLEMENTATION in a file of its own, with no tests, before including
+// it. That file then holds the only copy of CutL, which the rest share
+// through declarations and the macros alone, so tests from any of them can
+// run together: a single CUTL_MAIN() runs the CUTL_TEST tests of all files
+// (see CUTL_TEST). They must all be built with the same options, such as
+// CUTL_TRACK_ALLOC.
+#if defined(CUTL_IMPLEMENTATION) && !defined(CUTL_SPLIT)
+    #define CUTL_SPLIT
+#endif
+
+#if defined(CUTL_SPLIT)
+    #define _CUTL_LINKAGE
+#else
+    #define _CUTL_LINKAGE static
+#endif
+
+#if !defined(CUTL_SPLIT) || defined(CUTL_IMPLEMENTATION)
+    #define _CUTL_IMPLEMENT 1       // Whether this file has the implementation
+#else
+    #define _CUTL_IMPLEMENT 0
+#endif
+
+
 
 // The following methods MUST be implemented in the test file
 // ----------------------------------------------------------
 
-static void CUTL_BEFORE_ALL();  // Executes when BEGIN_TEST is called
-static void CUTL_AFTER_ALL();   // Executes when END_TEST is called
-static void CUTL_BEFORE_EACH(); // Executes before each test
-static void CUTL_AFTER_EACH();  // Executes after each test
+// In split mode, the file defining CUTL_IMPLEMENTATION only holds CutL. The
+// *_EACH ones of a file that only runs registered tests are called through
+// the suites (see CUTL_TEST), so they may not be used in it.
+#if !defined(CUTL_IMPLEMENTATION)
+static void CUTL_BEFORE_ALL();                       // Executes when BEGIN_TEST is called
+static void CUTL_AFTER_ALL();                        // Executes when END_TEST is called
+__CUTL_DECL_UNUSED(static void CUTL_BEFORE_EACH());  // Executes before each test
+__CUTL_DECL_UNUSED(static void CUTL_AFTER_EACH());   // Executes after each test
+#endif
 
 
 // CuTL Configurations
 // -------------------
 
 #define CUTL_FLAG_STOP_AT_FAIL  0x00000001  // Stop execution upon test failure
-
-
-__CUTL_DECL_UNUSED(static void cutl_config(int flags));
+#define CUTL_FLAG_PARALLEL      0x00000002  // Run tests on a pool of worker processes
+#define CUTL_FLAG_ISOLATE       0x00000004  // Run each test in a fork of the state after CUTL_BEFORE_ALL
+#define CUTL_FLAG_TIMING        0x00000008  // Time each test and report the slowest ones
+#define CUTL_FLAG_QUIET         0x00000010  // Only report failures, errors and the summary
+#define CUTL_FLAG_SUMMARY_ONLY  0x00000020  // Only report the summary
+#define CUTL_FLAG_PERF          0x00000040  // Count CPU events (cycles, cache misses...) of each test
+
+#define CUTL_OUTPUT_JUNIT       0           // JUnit XML (also CUTL_JUNIT_FILE)
+#define CUTL_OUTPUT_JSON        1           // JSON Lines (also CUTL_JSON_FILE)
+
+#define CUTL_REMOTE_COORDINATOR 1           // Hands the tests out (also CUTL_COORDINATOR)
+#define CUTL_REMOTE_WORKER      2           // Runs the tests handed out (also CUTL_WORKER)
+
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config(int flags));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_report_file(const char *path));   // Where to report (default: stdout)
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_output(int format, const char *path));  // Machine-readable results
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_workers(unsigned int n));   // Workers for CUTL_FLAG_PARALLEL (0: one per CPU)
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_slowest(unsigned int n));   // Slowest tests reported by CUTL_FLAG_TIMING
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_bench(unsigned int samples, unsigned int sample_ms));  // See CUTL_BENCH
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_baseline(const char *path, double tolerance, double sigmas));  // Benchmark regressions
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_timeout(unsigned int test_ms, unsigned int total_ms));  // 0: no limit
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_next_timeout(unsigned int ms));   // Overrides it for the next test
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_property(unsigned int cases, uint64_t seed));  // See CUTL_PROPERTY
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_cache(const char *path, uint64_t deps));  // Skips tests that passed before
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_shard(unsigned int index, unsigned int count, const char *timings));  // Runs a part of the tests
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_config_remote(int role, const char *address));  // Runs the tests on several machines
 
 
 // Other CutL functions
 // --------------------
 
-__CUTL_DECL_UNUSED(static int  cutl_failed());          // Returns the number of failed tests
+// Record of a case file (see CUTL_TEST_CASES), viewed where it is in the file
+typedef struct cutl_case {
+    const char *data;       // Not NUL-terminated
+    size_t      size;
+    size_t      index;      // Position among the records of the file
+    size_t      offset;     // Position in the file, in bytes
+} cutl_case_t;
+
+// Buffer made by cutl_gen_bytes
+typedef struct cutl_bytes {
+    const uint8_t *data;
+    size_t         size;
+} cutl_bytes_t;
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int  cutl_failed());          // Returns the number of failed tests
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void cutl_args(int argc, char **argv));  // Parses command line options (see below)
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void *cutl_arena_alloc(size_t size));    // Memory freed at once after each test
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *cutl_case_field(const cutl_case_t *record, unsigned int i, size_t *size));
+
+// Generators of the arguments of CUTL_PROPERTY
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE long long    cutl_gen_int(long long min, long long max));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE double       cutl_gen_double(double min, double max));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE float        cutl_gen_float(float min, float max));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char  *cutl_gen_string(size_t max_len));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE cutl_bytes_t cutl_gen_bytes(size_t max_len));
 
 
 // CutL macros
@@ -94,9 +300,23 @@ __CUTL_DECL_UNUSED(static int  cutl_failed());          // Returns the number of
 // macro  CUTL_BEGIN_TEST()
 // macro  CUTL_END_TEST()
 // macro  CUTL_TEST_FUNCTION(func, ...)
+// macro  CUTL_BENCH(func, ...)
+// macro  CUTL_DO_NOT_OPTIMIZE(value)
+// macro  CUTL_STRESS(func, threads, iterations, arg)
+// macro  CUTL_STRESS_SWEEP(func, threads, iterations, arg)
+// macro  CUTL_TEST_CASES(func, path)
+// macro  CUTL_PROPERTY(func, gen...)
+// macro  CUTL_FUZZ(func, dir)
+
+// macro  CUTL_TEST(name, tags...)    Defines and registers a test
+// macro  CUTL_RUN_REGISTERED()       Runs the registered tests, file by file
+// macro  CUTL_MAIN()                 Defines a main() that runs the registered tests
 
 // macro  CUTL_REPORT_ERROR(msg)
 
+// macro  ASSERT_NO_ALLOC { ... }         Fails if the block allocates (CUTL_TRACK_ALLOC)
+// macro  ASSERT_ALLOC_BYTES_LE(n) { ... }    Fails if the block allocates more than n bytes
+
 
 // CutL assertions
 // ---------------
@@ -122,6 +342,22 @@ __CUTL_DECL_UNUSED(static int  cutl_failed());          // Returns the number of
 // macro  ASSERT_EQ_STR(v1, v2)
 // macro  ASSERT_EQ_PTR(v1, v2)
 // macro  ASSERT_EQ_ARRAY(a1, a2, n, type)
+// macro  ASSERT_EQ_MEM(p1, p2, nbytes)
+// macro  ASSERT_MATCHES_SNAPSHOT(buf, len, name)   Equal to the golden file name, next to the file tested
+
+// macro  ASSERT_NEAR(v1, v2, tol)              |v1 - v2| <= tol
+// macro  ASSERT_NEAR_REL(v1, v2, tol)          |v1 - v2| <= tol * max(|v1|, |v2|)
+// macro  ASSERT_ULP_LE(v1, v2, ulps)           At most ulps doubles apart
+// macro  ASSERT_ULP_LE_FLOAT(v1, v2, ulps)     At most ulps floats apart
+// macro  ASSERT_NEAR_ARRAY(a1, a2, n, tol)     The same, element by element, for arrays of doubles
+// macro  ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol)
+// macro  ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps)
+
+/* Array checks have a _FLOAT variant for arrays of floats (e.g.
+ * ASSERT_NEAR_ARRAY_FLOAT). NaN matches NaN and infinities match
+ * themselves, anything else compared with them fails. Failed array checks
+ * report how many elements are out of tolerance, the largest error and a
+ * histogram of the errors. */
 
 // macro  ASSERT_NEQ_UINT(v1, v2)
 // macro  ASSERT_NEQ_INT(v1, v2)
@@ -132,6 +368,11 @@ __CUTL_DECL_UNUSED(static int  cutl_failed());          // Returns the number of
 // macro  ASSERT_NEQ_STR(v1, v2)
 // macro  ASSERT_NEQ_PTR(v1, v2)
 
+/* Every assertion has a THREAD_ASSERT* variant (e.g. THREAD_ASSERT_EQ_INT)
+ * that can be used from any thread started by the test, or from functions
+ * called by it. On failure, it leaves the test function if called from the
+ * thread running the test, or ends the calling thread otherwise. */
+
 
 
 // ==========================================================================
@@ -147,366 +388,9308 @@ __CUTL_DECL_UNUSED(static int  cutl_failed());          // Returns the number of
 
 // Configs
 
-static bool _cutl_stop_at_fail = false;
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE bool         _cutl_stop_at_fail = false;
+_CUTL_LINKAGE bool         _cutl_parallel     = false;
+_CUTL_LINKAGE bool         _cutl_isolate      = false;
+_CUTL_LINKAGE bool         _cutl_timing       = false;
+_CUTL_LINKAGE bool         _cutl_perf         = false;
+_CUTL_LINKAGE bool         _cutl_measure      = false;     // Whether tests are timed, to report or output
+_CUTL_LINKAGE unsigned int _cutl_n_workers    = 0;
+#endif
+
+// Control of test failures
+
+#define _CUTL_MAX_LEN_FUNC_NAME 128
+#define _CUTL_MAX_LEN_MSG       512     // Room for the windows of ASSERT_EQ_ARRAY
+
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE char *_cutl_current_file = NULL;    // Name of the file being tested
+_CUTL_LINKAGE char *_cutl_current_func = NULL;    // Name of the function being tested
+_CUTL_LINKAGE char *_cutl_current_args = NULL;    // Params given to it, as written
+_CUTL_LINKAGE int   _cutl_current_line = -1;      // Line in the file where the function being tested was called
+_CUTL_LINKAGE unsigned int _cutl_current_call = 0;  // Times that call was reached before
+
+_CUTL_LINKAGE unsigned int _cutl_n_tests_passed;   // Number of tests passed
+_CUTL_LINKAGE unsigned int _cutl_n_tests_failed;   // Number of tests failed
+_CUTL_LINKAGE unsigned int _cutl_n_tests_skipped;  // Number of tests not run for the total timeout
+
+_CUTL_LINKAGE unsigned long long _cutl_n_cases_passed;     // Of CUTL_TEST_CASES
+_CUTL_LINKAGE unsigned long long _cutl_n_cases_failed;
+#else
+extern char              *_cutl_current_file;
+extern unsigned int       _cutl_n_tests_passed;
+extern unsigned int       _cutl_n_tests_failed;
+extern unsigned int       _cutl_n_tests_skipped;
+extern unsigned long long _cutl_n_cases_passed;
+extern unsigned long long _cutl_n_cases_failed;
+#endif
+
+// Jumps out of the test function. Those of POSIX systems may be taken from
+// the timer signal handler (see _CUTL_TIMEOUT_HANDLER).
+#if _CUTL_POSIX
+    typedef sigjmp_buf _cutl_jmp_buf_t;
+
+    #define _CUTL_SETJMP(env)   sigsetjmp(env, 0)
+    #define _CUTL_LONGJMP(env)  siglongjmp(env, 1)
+#else
+    typedef jmp_buf _cutl_jmp_buf_t;
+
+    #define _CUTL_SETJMP(env)   setjmp(env)
+    #define _CUTL_LONGJMP(env)  longjmp(env, 1)
+#endif
+
+// Context of the running test
+//
+// What assertions record about the test. Threads started by the test share
+// it with the thread running it, so the first failure is claimed atomically
+// and the rest are only counted.
+typedef struct _cutl_context {
+    int          status;            // _CUTL_SUCCESS, _CUTL_FAILURE or _CUTL_ERROR
+    int          claimed;           // Taken by the first failure, which fills the fields below
+    int          failure_line;
+    char         failure_msg[_CUTL_MAX_LEN_MSG];
+    unsigned int n_more_failures;   // Failures registered after the first one
+    bool         in_body;           // Whether the test function is running
+    _cutl_jmp_buf_t exit;           // Where CUTL_THREAD_ASSERT* leave the test function
+} _cutl_context_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_context_t _cutl_context;
+
+// Bound to the thread running the tests, NULL in any other thread
+_CUTL_LINKAGE _CUTL_THREAD_LOCAL _cutl_context_t *_cutl_thread_context = NULL;
+#else
+extern _cutl_context_t _cutl_context;
+#endif
+
+// Logging and report settings
+//
+// Reports are formatted into a buffer that is written to the report file
+// in large blocks, or after every line when it is a terminal. Lines to the
+// standard output go through its own buffer instead, as the tests may print
+// to it too.
+
+#define _CUTL_REPORT_BUFFER_SIZE    65536
+#define _CUTL_MAX_LEN_REPORT        2048    // Longest report line
+
+#define _CUTL_VERBOSITY_SUMMARY     0       // Only the summary
+#define _CUTL_VERBOSITY_FAILURES    1       // Failures and errors too
+#define _CUTL_VERBOSITY_ALL         2       // Everything
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE FILE       *_cutl_report_file        = NULL;
+_CUTL_LINKAGE const char *_cutl_report_path        = NULL;
+_CUTL_LINKAGE int         _cutl_verbosity          = _CUTL_VERBOSITY_ALL;
+_CUTL_LINKAGE bool        _cutl_report_interactive = false;
+_CUTL_LINKAGE bool        _cutl_report_color       = false;
+_CUTL_LINKAGE bool        _cutl_report_atexit      = false;
+_CUTL_LINKAGE size_t      _cutl_report_used        = 0;
+_CUTL_LINKAGE char        _cutl_report_buffer[_CUTL_REPORT_BUFFER_SIZE];
+#else
+extern FILE *_cutl_report_file;
+#endif
+
+
+// Time spent by a test (CUTL_FLAG_TIMING), in nanoseconds
+typedef struct _cutl_timing {
+    uint64_t wall_ns;       // Wall time of the test function
+    uint64_t user_ns;       // CPU time of the test function in user mode
+    uint64_t sys_ns;        // CPU time of the test function in kernel mode
+    uint64_t setup_ns;      // Wall time of CUTL_BEFORE_EACH
+    uint64_t teardown_ns;   // Wall time of CUTL_AFTER_EACH
+} _cutl_timing_t;
+
+
+// Statistics of a benchmark (CUTL_BENCH), in nanoseconds per operation
+typedef struct _cutl_bench {
+    uint32_t samples;       // 0 if the test was not a benchmark
+    uint64_t iterations;    // Iterations per sample
+    double   min_ns;
+    double   median_ns;
+    double   mean_ns;
+    double   stddev_ns;
+    double   p99_ns;
+    double   mad_ns;        // Median absolute deviation, scaled to estimate the stddev
+} _cutl_bench_t;
+
+
+// Measures of a stress test (CUTL_STRESS), one round per number of threads
+
+#define _CUTL_MAX_STRESS_ROUNDS 16
+
+typedef struct _cutl_stress {
+    uint32_t rounds;                // 0 if the test was not a stress test
+    uint64_t iterations;            // Calls per thread
+    struct {
+        uint32_t threads;
+        double   ops_per_s;         // Of all the threads together
+        double   min_ops_per_s;     // Of the slowest thread
+        double   max_ops_per_s;     // Of the fastest thread
+    } round[_CUTL_MAX_STRESS_ROUNDS];
+} _cutl_stress_t;
+
+
+// Allocations made during a test (CUTL_TRACK_ALLOC), from CUTL_BEFORE_EACH
+// to CUTL_AFTER_EACH. All sizes are as requested. Blocks allocated before
+// the test are not counted when it frees them.
+typedef struct _cutl_alloc {
+    uint64_t count;         // Calls to malloc, calloc, realloc and the aligned allocators
+    uint64_t bytes;         // Bytes requested by them
+    int64_t  in_use;        // Blocks of the test still in use
+    int64_t  in_use_bytes;  // Bytes of them
+    int64_t  peak_bytes;    // Most bytes of the test in use at once
+} _cutl_alloc_t;
+
+
+// CPU events counted during a test (CUTL_FLAG_PERF). Benchmarks count
+// them per operation, over their samples only.
+
+#define _CUTL_N_PERF            7
+#define _CUTL_PERF_HARDWARE     5       // Events before this one need a hardware PMU
+#define _CUTL_PERF_TASK_CLOCK   5       // Counted in nanoseconds
+
+typedef struct _cutl_perf {
+    uint32_t counted;               // Bit mask of the events counted, 0 if none
+    double   value[_CUTL_N_PERF];   // Indexed as _cutl_perf_events
+} _cutl_perf_t;
+
+
+// Test arena (cutl_arena_alloc)
+//
+// Memory is handed out from chunks by bumping an offset, and all of it is
+// taken back at once after each test. Chunks are kept from one test to the
+// next, merged into a single one when a test needed several.
+
+#define _CUTL_ARENA_ALIGN       16
+#define _CUTL_ARENA_MIN_CHUNK   (64 * 1024)
+#define _CUTL_ARENA_MAX_KEPT    (64 * 1024 * 1024)  // Largest chunk kept between tests
+
+typedef struct _cutl_arena_chunk {
+    struct _cutl_arena_chunk *next;     // Chunk filled before this one
+    size_t                    size;
+    size_t                    used;
+} _cutl_arena_chunk_t;
+
+// Chunk headers take a multiple of the alignment, so that data stays aligned
+#define _CUTL_ARENA_HEADER \
+    ((sizeof(_cutl_arena_chunk_t) + _CUTL_ARENA_ALIGN - 1) & ~(size_t)(_CUTL_ARENA_ALIGN - 1))
+
+// A point of the arena to go back to
+typedef struct _cutl_arena_mark {
+    _cutl_arena_chunk_t *chunk;
+    size_t               used;
+} _cutl_arena_mark_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_arena_chunk_t *_cutl_arena      = NULL;    // Chunk in use, with the previous ones after it
+_CUTL_LINKAGE int                  _cutl_arena_lock = 0;
+#endif
+
+
+// Cases run by a test (CUTL_TEST_CASES, CUTL_PROPERTY)
+typedef struct _cutl_cases {
+    uint64_t total;         // 0 if the test did not run cases
+    uint64_t failed;
+} _cutl_cases_t;
+
+
+// Result of a test, as it travels from the process that ran it to the
+// process that reports it
+typedef struct _cutl_result {
+    unsigned long index;                            // Position of the test in the run
+    const char   *file;                             // File where the test was called
+    const char   *func;                             // Name of the test function
+    const char   *args;                             // Params given to it, as written
+    int           line;                             // Line where the test was called
+    unsigned int  call;                             // Times that call was reached before, e.g. in a loop
+    int           status;                           // _CUTL_SUCCESS, _CUTL_FAILURE or _CUTL_ERROR
+    int           failure_line;
+    char          failure_msg[_CUTL_MAX_LEN_MSG];
+    unsigned int  n_more_failures;                  // Failures after the reported one
+    _cutl_timing_t timing;
+    _cutl_bench_t  bench;
+    _cutl_stress_t stress;
+    _cutl_alloc_t  alloc;
+    _cutl_perf_t   perf;
+    _cutl_cases_t  cases;
+    uint64_t       cache_key;                       // 0 if its result is not cached
+    bool           cached;                          // Whether it passed in a previous run
+    bool           skipped;                         // Whether the total timeout left it out (an error)
+} _cutl_result_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE unsigned long _cutl_test_index;      // Index of the next test in program order
+#else
+extern unsigned long _cutl_test_index;
+#endif
+
+
+// Machine-readable outputs
+//
+// Besides the text report, results can be streamed to other formats as
+// they are reported. Writers keep nothing but counters in memory, so the
+// size of the run does not matter.
+
+#define _CUTL_N_OUTPUTS 2
+
+typedef struct _cutl_output {
+    const char  *env;           // Environment variable with the path
+    const char  *path;          // Path set with cutl_config_output()
+    FILE        *file;          // NULL if not enabled
+    long         header_pos;    // Where the header to complete at the end is
+    unsigned int n_passed;
+    unsigned int n_failed;
+    unsigned int n_errors;
+    void       (*begin)(struct _cutl_output *output, const char *suite);
+    void       (*test)(struct _cutl_output *output, const _cutl_result_t *result);
+    void       (*end)(struct _cutl_output *output, const char *suite, uint64_t wall_ns);
+} _cutl_output_t;
+
+
+// Timing (CUTL_FLAG_TIMING)
+
+#define _CUTL_DEFAULT_SLOWEST 10
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE uint64_t _cutl_mark_setup;           // Timestamps of the test being run
+_CUTL_LINKAGE uint64_t _cutl_mark_body;
+_CUTL_LINKAGE uint64_t _cutl_mark_teardown;
+_CUTL_LINKAGE uint64_t _cutl_mark_user;
+_CUTL_LINKAGE uint64_t _cutl_mark_sys;
+_CUTL_LINKAGE uint64_t _cutl_run_start;            // Timestamp of CUTL_BEGIN_TEST
+_CUTL_LINKAGE uint64_t _cutl_tests_wall_ns;        // Wall time of all the tests
+
+_CUTL_LINKAGE unsigned int    _cutl_n_slowest = _CUTL_DEFAULT_SLOWEST;
+_CUTL_LINKAGE unsigned int    _cutl_slowest_size = 0;
+_CUTL_LINKAGE _cutl_result_t *_cutl_slowest = NULL;    // Sorted from slowest to fastest
+#else
+extern uint64_t _cutl_run_start;
+#endif
+
+
+// Benchmarks (CUTL_BENCH)
+//
+// A benchmark runs its function in batches. The first batches calibrate
+// how many iterations fit in the target time of a sample, the next ones
+// warm up caches and branch predictors, and the rest are the samples.
+
+#define _CUTL_DEFAULT_BENCH_SAMPLES     30
+#define _CUTL_DEFAULT_BENCH_SAMPLE_MS   10
+
+#define _CUTL_BENCH_IDLE        0
+#define _CUTL_BENCH_CALIBRATE   1
+#define _CUTL_BENCH_WARMUP      2
+#define _CUTL_BENCH_SAMPLE      3
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE unsigned int _cutl_bench_samples   = _CUTL_DEFAULT_BENCH_SAMPLES;
+_CUTL_LINKAGE unsigned int _cutl_bench_sample_ms = _CUTL_DEFAULT_BENCH_SAMPLE_MS;
+
+_CUTL_LINKAGE int           _cutl_bench_phase;
+_CUTL_LINKAGE unsigned int  _cutl_bench_done;      // Batches run in the current phase
+_CUTL_LINKAGE uint64_t      _cutl_bench_started;   // Timestamp of the current batch
+_CUTL_LINKAGE double       *_cutl_bench_times = NULL;  // ns/op of each sample
+_CUTL_LINKAGE _cutl_bench_t _cutl_bench_stats;     // Statistics of the current test
+_CUTL_LINKAGE _cutl_arena_mark_t _cutl_bench_arena;    // Arena in use before the first batch
+#endif
+
+
+// Stress tests (CUTL_STRESS)
+//
+// Every thread of a round is pinned to a CPU and waits for the rest at a
+// barrier, so that all of them start calling the function at once.
+
+typedef struct _cutl_stress_thread {
+    void       (*func)(void *arg);
+    void        *arg;
+    uint64_t     iterations;
+    int          cpu;               // -1 if not pinned
+    uint64_t     start_ns;
+    uint64_t     end_ns;
+} _cutl_stress_thread_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_stress_t _cutl_stress_stats;       // Measures of the current test
+#if _CUTL_POSIX
+_CUTL_LINKAGE int            _cutl_stress_arrived;     // Threads waiting at the barrier
+_CUTL_LINKAGE int            _cutl_stress_go;          // Set to release them
+#endif
+#endif
+
+
+// Test cases (CUTL_TEST_CASES)
+//
+// The case file stays mapped while its cases run. Failures registered
+// meanwhile tell which case they come from.
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE const char    *_cutl_cases_data   = NULL;
+_CUTL_LINKAGE size_t         _cutl_cases_size   = 0;
+_CUTL_LINKAGE cutl_case_t   *_cutl_case_current = NULL;
+_CUTL_LINKAGE _cutl_cases_t  _cutl_cases_stats;    // Cases of the current test
+#endif
+
+
+// Property-based tests (CUTL_PROPERTY)
+//
+// Generators turn choices, numbers drawn from a PRNG, into the arguments
+// of the property. Each run records its choices, so that a failing run can
+// be replayed from them. Shrinking then looks for simpler choices that
+// still fail, with fewer or smaller numbers, and replays the simplest.
+
+#define _CUTL_PROPERTY_CASES        10000       // Default cases per property
+#define _CUTL_PROPERTY_MAX_RUNS     100000      // Most runs spent shrinking
+#define _CUTL_PROPERTY_CHUNK        8           // Most choices removed at once
+
+#define _CUTL_PROPERTY_GENERATING   0           // Running random cases
+#define _CUTL_PROPERTY_SHRINKING    1           // Shrinking a failing case
+#define _CUTL_PROPERTY_REPLAYING    2           // Replaying the simplest one
+
+#define _CUTL_PROPERTY_DELETE       0           // Shrink by removing choices
+#define _CUTL_PROPERTY_LOWER        1           // Shrink by making them smaller
+#define _CUTL_PROPERTY_MOVE         2           // Shrink by moving amounts between them
+
+typedef struct _cutl_property {
+    bool        active;         // Whether generators record their choices
+    const char *func;
+    uint64_t    seed;           // Of this property, derived from that of the run
+    uint64_t    rng[4];         // State of xoshiro256**
+    int         phase;
+    uint64_t    cases;          // Run so far
+    uint64_t    runs;           // Spent shrinking
+    uint64_t    shrinks;        // Simpler failing cases found
+
+    uint64_t   *drawn;          // Choices of the current run
+    uint64_t   *input;          // Choices it replays, if any
+    uint64_t   *best;           // Simplest ones that failed
+    size_t      n_drawn;
+    size_t      n_input;
+    size_t      n_best;
+    size_t      capacity;       // Of each one of the three
+    bool        replay;
+    bool        ran;            // Whether a run was set up
+
+    int         pass;           // Shrinking state
+    bool        improved;       // Whether the pass found a simpler case
+    bool        searching;      // Whether a choice is being lowered
+    size_t      chunk;
+    size_t      index;          // Choice being shrunk
+    size_t      other;          // Where its amount is moved, or 1 once lowered
+    size_t      search_len;
+    uint64_t    lo, mid, hi;    // Bounds of the search
+
+    bool                 describe;  // Whether generators write what they return
+    char                 args[_CUTL_MAX_LEN_MSG];
+    _cutl_arena_chunk_t *scratch;   // Memory of generated strings, reused by every run
+} _cutl_property_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE unsigned int     _cutl_property_cases = _CUTL_PROPERTY_CASES;
+_CUTL_LINKAGE uint64_t         _cutl_property_seed  = 0;   // Of the run, 0 until chosen
+_CUTL_LINKAGE _cutl_property_t _cutl_property;
+#endif
+
+
+// Fuzzing (CUTL_FUZZ)
+//
+// Programs built with -fsanitize-coverage=trace-pc-guard (clang) or
+// -fsanitize-coverage=trace-pc (gcc) call CutL back on every edge or block
+// of their code. While a fuzz target runs, those calls are counted into a
+// map. Inputs that take new edges, or take them a new number of times,
+// join the corpus and are mutated in turn.
+
+#define _CUTL_FUZZ_MAP_SIZE     65536       // Edges counted, a power of 2
+#define _CUTL_FUZZ_TIME         60          // Default seconds per target
+#define _CUTL_FUZZ_MAX_LEN      4096        // Default longest input made
+
+typedef struct _cutl_fuzz_input {
+    uint8_t    *data;
+    size_t      size;
+    const char *name;       // Of its file, if it was read from one
+} _cutl_fuzz_input_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE bool          _cutl_fuzz         = false;    // Whether to fuzz (--fuzz), or only replay corpora
+_CUTL_LINKAGE unsigned int  _cutl_fuzz_time    = _CUTL_FUZZ_TIME;     // 0 for no limit
+_CUTL_LINKAGE uint64_t      _cutl_fuzz_runs    = 0;                   // 0 for no limit
+_CUTL_LINKAGE size_t        _cutl_fuzz_max_len = _CUTL_FUZZ_MAX_LEN;
+_CUTL_LINKAGE unsigned int  _cutl_fuzz_run_ms  = 0;        // Timeout of each run
+
+_CUTL_LINKAGE volatile bool _cutl_fuzz_tracing = false;    // Whether the target is running
+_CUTL_LINKAGE uint64_t      _cutl_fuzz_map[_CUTL_FUZZ_MAP_SIZE / 8];  // Counts, one byte per edge
+_CUTL_LINKAGE uintptr_t     _cutl_fuzz_prev    = 0;        // Previous block (trace-pc)
+_CUTL_LINKAGE uint32_t      _cutl_fuzz_guards  = 0;        // Edges numbered (trace-pc-guard)
+_CUTL_LINKAGE char          _cutl_fuzz_dir[1024];
+_CUTL_LINKAGE const char   *_cutl_fuzz_input   = NULL;     // Corpus file running, told in failures
+
+#if _CUTL_POSIX
+_CUTL_LINKAGE uint8_t       _cutl_fuzz_seen[_CUTL_FUZZ_MAP_SIZE];     // Buckets of counts seen per edge
+_CUTL_LINKAGE uint64_t      _cutl_fuzz_rng[4];
+
+_CUTL_LINKAGE _cutl_fuzz_input_t *_cutl_fuzz_corpus   = NULL;
+_CUTL_LINKAGE size_t              _cutl_fuzz_n_corpus = 0;
+_CUTL_LINKAGE size_t              _cutl_fuzz_capacity = 0;
+
+_CUTL_LINKAGE const uint8_t *_cutl_fuzz_data  = NULL;      // Input running, saved if it crashes
+_CUTL_LINKAGE size_t         _cutl_fuzz_size  = 0;
+#endif
+#endif
+
+
+// Snapshots (ASSERT_MATCHES_SNAPSHOT)
+//
+// Golden files are looked for next to the file being tested, and mapped
+// to be compared where they are, however large they are.
+
+#define _CUTL_SNAPSHOT_CONTEXT  32      // Bytes shown before the first difference
+#define _CUTL_SNAPSHOT_SHOWN    64      // Bytes shown in all of each line
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE bool _cutl_snapshot_update = false;  // Whether to rewrite them (--update-snapshots)
+#endif
+
+
+// Benchmark baselines
+//
+// A baseline file keeps the results of a previous run of the benchmarks,
+// one line per benchmark:
+//
+//     <samples> <TAB> <median ns/op> <TAB> <MAD ns/op> <TAB> <key>
+//
+// where the key is the file, the function and the params as written, so
+// that moving a benchmark around its file keeps its baseline. Calls in a
+// loop are told apart by the times they were reached before, which is
+// added to the key from the second one on (see _CUTL_BASELINE_KEY).
+
+#define _CUTL_DEFAULT_BASELINE_TOLERANCE    0.10
+#define _CUTL_DEFAULT_BASELINE_SIGMAS       3.0
+#define _CUTL_BASELINE_HEADER               "# CutL benchmark baseline v1"
+
+typedef struct _cutl_baseline_entry {
+    char    *key;           // <file> <TAB> <func> <TAB> <params> [<TAB> <call>]
+    uint32_t samples;
+    double   median_ns;
+    double   mad_ns;
+} _cutl_baseline_entry_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE const char             *_cutl_baseline_path      = NULL;
+_CUTL_LINKAGE double                  _cutl_baseline_tolerance = _CUTL_DEFAULT_BASELINE_TOLERANCE;
+_CUTL_LINKAGE double                  _cutl_baseline_sigmas    = _CUTL_DEFAULT_BASELINE_SIGMAS;
+_CUTL_LINKAGE bool                    _cutl_baseline_update    = false;
+_CUTL_LINKAGE bool                    _cutl_baseline_loaded    = false;
+_CUTL_LINKAGE bool                    _cutl_baseline_changed   = false;
+_CUTL_LINKAGE _cutl_baseline_entry_t *_cutl_baseline           = NULL;
+_CUTL_LINKAGE size_t                  _cutl_baseline_size      = 0;
+_CUTL_LINKAGE size_t                  _cutl_baseline_capacity  = 0;
+#endif
+
+
+// Result cache (cutl_config_cache)
+//
+// The cache file keeps the keys of the tests that passed, one per line in
+// hex, appended by every run under a lock. A key hashes the call of a test
+// (see _CUTL_TEST_KEY) with what it depends on, so a test whose key is
+// there would pass again.
+
+#define _CUTL_CACHE_HEADER      "# CutL result cache v1\n"
+#define _CUTL_CACHE_LINE        17          // 16 hex digits and a newline
+#define _CUTL_CACHE_MAX_KEYS    65536       // The oldest half goes past this
+
+// Tests whose result may change with nothing else changing
+#define _CUTL_CACHE_UNCACHED    "bench,stress,property,cases,fuzz"
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE const char  *_cutl_cache_path     = NULL;
+_CUTL_LINKAGE uint64_t     _cutl_cache_deps     = 0;       // 0 for the hash of the program
+_CUTL_LINKAGE uint64_t    *_cutl_cache_keys     = NULL;    // Read from the file, sorted
+_CUTL_LINKAGE size_t       _cutl_cache_n_keys   = 0;
+_CUTL_LINKAGE uint64_t    *_cutl_cache_new      = NULL;    // Of the tests passed in this run
+_CUTL_LINKAGE size_t       _cutl_cache_n_new    = 0;
+_CUTL_LINKAGE size_t       _cutl_cache_capacity = 0;
+_CUTL_LINKAGE uint64_t    *_cutl_cache_failed   = NULL;    // Of the tests failed in this run
+_CUTL_LINKAGE size_t       _cutl_cache_n_failed = 0;
+_CUTL_LINKAGE size_t       _cutl_cache_failed_capacity = 0;
+_CUTL_LINKAGE uint64_t     _cutl_cache_key      = 0;       // Of the test being run
+_CUTL_LINKAGE unsigned int _cutl_n_tests_cached = 0;
+#endif
+
+
+// Sharding (cutl_config_shard)
+//
+// A timings file keeps how long every test took the last time it ran, one
+// line per test:
+//
+//     <ns> <TAB> <key>
+//
+// where the key tells the call of the test apart (see _CUTL_TEST_KEY).
+// All the shards read the same file and make the same assignment from it.
+
+#define _CUTL_TIMINGS_HEADER    "# CutL test timings v2\n"
+
+typedef struct _cutl_timing_entry {
+    char    *key;           // See _CUTL_TEST_KEY
+    uint64_t ns;
+    size_t   order;         // Line in the file, the last one of a test counts
+    unsigned shard;
+} _cutl_timing_entry_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE unsigned int          _cutl_shard_index     = 0;
+_CUTL_LINKAGE unsigned int          _cutl_shard_count     = 0;     // 0 or 1 for no sharding
+_CUTL_LINKAGE const char           *_cutl_timings_path    = NULL;
+_CUTL_LINKAGE bool                  _cutl_shard_loaded    = false;
+_CUTL_LINKAGE _cutl_timing_entry_t *_cutl_timings         = NULL;  // Read from the file, sorted by key
+_CUTL_LINKAGE size_t                _cutl_timings_size    = 0;
+_CUTL_LINKAGE _cutl_timing_entry_t *_cutl_timings_new     = NULL;  // Measured in this run
+_CUTL_LINKAGE size_t                _cutl_timings_n_new   = 0;
+_CUTL_LINKAGE size_t                _cutl_timings_capacity = 0;
+#endif
+
+
+// Suites
+//
+// The tests registered from a file form its suite, which runs the special
+// functions of that file around them. In split mode, the suites of many
+// files can run from a single CUTL_MAIN(). Files whose results were
+// reported get one too, to sum them up per file.
+
+typedef struct _cutl_suite {
+    const char         *file;
+    void              (*before_all)(void);   // NULL if no test of the file was registered
+    void              (*after_all)(void);
+    void              (*before_each)(void);
+    void              (*after_each)(void);
+    bool                started;            // Whether its CUTL_BEFORE_ALL has run
+    unsigned int        n_passed;
+    unsigned int        n_failed;
+    struct _cutl_suite *next;
+} _cutl_suite_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_suite_t *_cutl_suites      = NULL;   // In the order they were first seen
+_CUTL_LINKAGE _cutl_suite_t *_cutl_suites_tail = NULL;
+#endif
+
+
+// Registered tests
+//
+// Tests defined with CUTL_TEST are added to this list by a constructor
+// before main() runs, in the same order as they are defined. Those of
+// each file are kept together.
+
+typedef struct _cutl_test_desc {
+    const char             *name;
+    const char             *tags;   // As written in CUTL_TEST, separated by commas
+    const char             *file;
+    int                     line;
+    void                  (*func)(void);
+    _cutl_suite_t          *suite;  // That of the file
+    struct _cutl_test_desc *next;
+} _cutl_test_desc_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_test_desc_t *_cutl_registry      = NULL;
+_CUTL_LINKAGE _cutl_test_desc_t *_cutl_registry_tail = NULL;
+_CUTL_LINKAGE unsigned int       _cutl_registry_size = 0;
+#else
+extern _cutl_test_desc_t *_cutl_registry;
+#endif
+
+// Test selection (see cutl_args)
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE const char *_cutl_filter = NULL;     // Globs over test names
+_CUTL_LINKAGE const char *_cutl_tags   = NULL;     // Tags to run
+#endif
+
+
+// Parallel execution
+//
+// Every worker is a fork of the main process taken right after
+// CUTL_BEFORE_ALL, so all of them walk the very same sequence of
+// CUTL_TEST_FUNCTION calls. Upon reaching a test, a worker tries to claim
+// its index from a counter in shared memory: the first one to get there
+// runs it and the rest skip it. Idle workers thus keep taking tests from
+// the busy ones. Results are written to a private file per worker and
+// merged back in program order by the main process in CUTL_END_TEST.
+
+typedef struct _cutl_pool {
+    unsigned long  next;        // Index of the next test to be claimed
+    int            stop;        // Set when a worker asks the rest to stop
+    _cutl_result_t running[];   // Test each worker is running (used on crashes)
+} _cutl_pool_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_pool_t *_cutl_pool        = NULL;
+_CUTL_LINKAGE int           _cutl_worker_id   = -1;    // -1 in the main process
+_CUTL_LINKAGE FILE        **_cutl_worker_out  = NULL;  // Results file of each worker
+#if _CUTL_POSIX
+_CUTL_LINKAGE unsigned int  _cutl_pool_size   = 0;
+_CUTL_LINKAGE pid_t        *_cutl_worker_pids = NULL;
+#endif
+#endif
+
+
+// Distributed execution (cutl_config_remote)
+//
+// A coordinator walks the tests like the main process of the pool does,
+// without running them, and hands their indexes out in batches to the
+// workers that connect to it, from this or other machines. Workers run
+// the very same program, so an index is all they need to know which test
+// to run, and send every result back to be reported in program order.
+//
+// Every message is a header followed by its payload, in the byte order of
+// the machines, which must be the same:
+//
+//     HELLO   uint64 hash of the program, uint32 size of a result
+//     CLAIM   uint64 index the worker has reached
+//     RESULT  the result, with the unused end of its message left out
+//     BYE
+//     BATCH   uint64 first index, uint64 count (0: no tests left)
+//
+// The coordinator sends BATCH, as the answer to CLAIM, and workers the
+// rest. A batch only has indexes the worker has not gone past yet.
+
+#define _CUTL_REMOTE_ADDRESS        "127.0.0.1:7357"
+#define _CUTL_REMOTE_MAX_BATCH      64
+#define _CUTL_REMOTE_CONNECT_MS     10000   // How long workers wait for the coordinator
+
+#define _CUTL_MSG_HELLO     1
+#define _CUTL_MSG_CLAIM     2
+#define _CUTL_MSG_BATCH     3
+#define _CUTL_MSG_RESULT    4
+#define _CUTL_MSG_BYE       5
+
+#define _CUTL_REMOTE_QUEUED 0               // Waiting for a worker
+#define _CUTL_REMOTE_SENT   1               // In the batch of a worker
+#define _CUTL_REMOTE_DONE   2               // Its result, if any, is in
+
+typedef struct _cutl_msg_header {
+    uint32_t type;
+    uint32_t length;                        // Of the payload
+} _cutl_msg_header_t;
+
+// A test as the coordinator saw it
+typedef struct _cutl_remote_test {
+    const char     *file;
+    const char     *func;
+    const char     *args;
+    int             line;
+    unsigned int    call;
+    int             state;
+    _cutl_result_t *result;                 // Received, waiting for those before it
+} _cutl_remote_test_t;
+
+// A worker as the coordinator sees it
+typedef struct _cutl_remote_client {
+    unsigned long first;                    // Its batch
+    unsigned long end;
+    unsigned long next;                     // Index after its last result
+    bool          hello;
+    bool          bye;
+    size_t        received;                 // Bytes of the messages in the buffer
+    char          buffer[sizeof(_cutl_msg_header_t) + sizeof(_cutl_result_t)];
+} _cutl_remote_client_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE int                  _cutl_remote_role      = 0;     // CUTL_REMOTE_COORDINATOR, CUTL_REMOTE_WORKER or 0
+_CUTL_LINKAGE const char          *_cutl_remote_address   = NULL;
+#if _CUTL_POSIX
+_CUTL_LINKAGE int                  _cutl_remote_fd        = -1;    // Listening socket, or connection to the coordinator
+_CUTL_LINKAGE _cutl_remote_test_t *_cutl_remote_tests     = NULL;  // Coordinator only, by index
+_CUTL_LINKAGE size_t               _cutl_remote_capacity  = 0;
+_CUTL_LINKAGE size_t               _cutl_remote_n_queued  = 0;
+_CUTL_LINKAGE unsigned long        _cutl_remote_cursor    = 0;     // No test before it is queued
+_CUTL_LINKAGE unsigned int         _cutl_remote_n_clients = 0;     // Connected workers
+_CUTL_LINKAGE unsigned int         _cutl_remote_n_workers = 0;     // Workers that ran tests for the run
+_CUTL_LINKAGE unsigned long        _cutl_remote_first     = 0;     // Batch of a worker
+_CUTL_LINKAGE unsigned long        _cutl_remote_end       = 0;
+_CUTL_LINKAGE bool                 _cutl_remote_drained   = false; // The coordinator has no more tests
+_CUTL_LINKAGE unsigned int         _cutl_remote_n_run     = 0;     // Tests a worker ran
+#endif
+#endif
+
+
+// Isolated execution
+//
+// The child that runs an isolated test sends its result through a pipe to
+// the process that forked it, and then exits.
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE int _cutl_isolated_fd = -1;      // Write end of the pipe in the child
+#endif
+
+
+// Timeouts
+//
+// Isolated tests are watched by the process that forked them, which kills
+// them once their time is up. Tests that run in process are interrupted by
+// a timer signal, whose handler leaves the test function like a failed
+// CUTL_THREAD_ASSERT* would. It only takes note of it: the error is
+// registered once out of the handler.
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE unsigned int _cutl_timeout_ms       = 0;     // Per test, 0 for none
+_CUTL_LINKAGE unsigned int _cutl_timeout_total_ms = 0;     // Whole run, 0 for none
+_CUTL_LINKAGE unsigned int _cutl_timeout_next_ms  = 0;     // Override for the next test only
+_CUTL_LINKAGE unsigned int _cutl_timeout_test_ms  = 0;     // Time the running test has
+_CUTL_LINKAGE char         _cutl_timeout_msg[_CUTL_MAX_LEN_MSG];
+
+#if _CUTL_POSIX
+_CUTL_LINKAGE pthread_t    _cutl_test_thread;              // Thread that runs the tests
+_CUTL_LINKAGE volatile sig_atomic_t _cutl_timeout_expired = 0;
+_CUTL_LINKAGE int          _cutl_timeout_fd = -1;          // Where the handler reports, if it ends the run
+_CUTL_LINKAGE size_t       _cutl_timeout_len = 0;
+_CUTL_LINKAGE char         _cutl_timeout_report[3 * _CUTL_MAX_LEN_MSG];
+#endif
+#endif
+
+
+// Allocation tracking (CUTL_TRACK_ALLOC)
+//
+// Counters are shared by all threads. CutL pauses them on the thread that
+// runs the tests while it allocates for itself. Blocks in use are kept in
+// an open-addressing hash set, under a spin lock, with the test that
+// allocated them. Its table comes straight from the real allocator.
+
+#define _CUTL_ALLOC_EMPTY       ((uintptr_t)0)      // Slot never used
+#define _CUTL_ALLOC_REMOVED     ((uintptr_t)1)      // Slot of a block freed
+
+typedef struct _cutl_alloc_block {
+    uintptr_t ptr;          // Or _CUTL_ALLOC_EMPTY, _CUTL_ALLOC_REMOVED
+    size_t    size;         // Requested
+    uint64_t  test;         // _cutl_alloc_test when it was allocated
+} _cutl_alloc_block_t;
+
+typedef struct _cutl_alloc_scope {
+    bool     done;          // Whether the block has run
+    uint64_t count;         // Counters when it started
+    uint64_t bytes;
+} _cutl_alloc_scope_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE _cutl_alloc_t                _cutl_alloc;
+_CUTL_LINKAGE _CUTL_THREAD_LOCAL volatile unsigned _cutl_alloc_paused = 0;    // volatile, or it would be moved past malloc()
+
+#if _CUTL_TRACK_ALLOC
+_CUTL_LINKAGE uint64_t             _cutl_alloc_test     = 0;       // Changes with every test
+_CUTL_LINKAGE _cutl_alloc_block_t *_cutl_alloc_blocks   = NULL;
+_CUTL_LINKAGE size_t               _cutl_alloc_capacity = 0;       // A power of 2
+_CUTL_LINKAGE size_t               _cutl_alloc_n_live   = 0;
+_CUTL_LINKAGE size_t               _cutl_alloc_n_used   = 0;       // Live and removed slots
+_CUTL_LINKAGE bool                 _cutl_alloc_lock     = false;
+#endif
+#endif
+
+
+// CPU event counters (CUTL_FLAG_PERF)
+//
+// Counters are opened by the process that runs the tests, and count its
+// threads in user mode only, which is all that unprivileged processes may
+// count. Every reading tells for how long the counter was enabled and for
+// how long it actually ran, as the kernel takes turns when there are more
+// events than hardware counters, so that counts can be scaled up.
+
+typedef struct _cutl_perf_reading {
+    uint64_t value;
+    uint64_t enabled;
+    uint64_t running;
+} _cutl_perf_reading_t;
+
+#if _CUTL_IMPLEMENT
+_CUTL_LINKAGE const struct {
+    const char *name;       // As reported
+    const char *key;        // In machine-readable outputs
+} _cutl_perf_events[_CUTL_N_PERF] = {
+    { "cycles",        "cycles"        },
+    { "instructions",  "instructions"  },
+    { "branch-misses", "branch_misses" },
+    { "L1d-misses",    "l1d_misses"    },
+    { "LLC-misses",    "llc_misses"    },
+    { "task-clock",    "task_clock_ns" },
+    { "page-faults",   "page_faults"   },
+};
+
+_CUTL_LINKAGE uint32_t             _cutl_perf_open = 0;    // Bit mask of the events being counted
+#if _CUTL_PERF
+_CUTL_LINKAGE long                 _cutl_perf_pid  = 0;    // Process they count
+_CUTL_LINKAGE int                  _cutl_perf_fd[_CUTL_N_PERF];
+#endif
+_CUTL_LINKAGE _cutl_perf_reading_t _cutl_perf_mark[_CUTL_N_PERF];          // When the test function started
+_CUTL_LINKAGE _cutl_perf_reading_t _cutl_perf_bench_mark[_CUTL_N_PERF];    // When the benchmark batch started
+_CUTL_LINKAGE _cutl_perf_t         _cutl_perf_stats;       // Counts of the current test
+_CUTL_LINKAGE _cutl_perf_t         _cutl_perf_bench;       // Counts of the samples of its benchmark
+#endif
+
+
+
+
+// ==========================================================================
+// Private functions declarations
+// ==========================================================================
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_OPEN(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_FLUSH(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_LINE(int verbosity, const char *color, const char *tag, const char *format, va_list args));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_SUCCESS(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_FAILURE(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_INFO(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_DEBUG(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_ERROR(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_BENCH(const char *msg, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_STRESS(const char *msg, ...));
+
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE __CUTL_COLD void _CUTL_REGISTER_TEST_FAILURE(const int line, const char *msg));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REGISTER_TEST_ERROR(const int line, const char *msg));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REGISTER_TEST_STATUS(int status, int line, const char *msg));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_THREAD_EXIT(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_TEST_RESULT(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_BENCH_STATS(const _cutl_result_t *result, const char *note));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_RECORD_TEST_RESULT(const _cutl_result_t *result));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_TEST_START(const char *file, const char *func, const char *args, const char *tags,
+                                                       const int line, unsigned int call));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int  _CUTL_TEST_KEY(char *buffer, size_t size, const char *file, int line, const char *func,
+                                                     const char *args, unsigned int call));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TEST_FINISH(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TEST_BODY_START(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TEST_BODY_END(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_TEST_FORK(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_NOW_NS(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_CPU_NS(uint64_t *user_ns, uint64_t *sys_ns));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_DURATION(double ns, char *buffer, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TRACK_SLOWEST(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_TIMING_SUMMARY(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_OUTPUT_OPEN(const char *suite));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_OUTPUT_TEST(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_OUTPUT_CLOSE(const char *suite));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_WRITE_ESCAPED(FILE *file, const char *str, bool xml));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JUNIT_BEGIN(_cutl_output_t *output, const char *suite));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JUNIT_TEST(_cutl_output_t *output, const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JUNIT_END(_cutl_output_t *output, const char *suite, uint64_t wall_ns));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JSON_BEGIN(_cutl_output_t *output, const char *suite));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JSON_TEST(_cutl_output_t *output, const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_JSON_END(_cutl_output_t *output, const char *suite, uint64_t wall_ns));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_STRESS(void (*func)(void *), unsigned int threads, uint64_t iterations, bool sweep, void *arg));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_STRESS_RUN(void (*func)(void *), unsigned int threads, uint64_t iterations, bool sweep, void *arg));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void  *_CUTL_STRESS_THREAD(void *data));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int    _CUTL_STRESS_CPUS(int *cpus, int max));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_REPORT_STRESS_STATS(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_RATE(double per_s, char *buffer, size_t size));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int  _CUTL_FORMAT_SNAPSHOT_LINE(char *buffer, size_t size, const char *label, const char *data, size_t data_size, size_t from));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_WRITE_SNAPSHOT(const char *path, const void *data, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_CHECK_SNAPSHOT(int line, const char *assertion, const void *data, size_t size, const char *name));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_SOURCE_PATH(const char *path, char *buffer, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_MAP_FILE(FILE *file, size_t *size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_UNMAP_FILE(const char *data, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_CASES_MAP(const char *path));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_CASES_UNMAP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TEST_CASES(void (*func)(const cutl_case_t *), const char *path));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_CASES_SUMMARY(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_RANDOM(uint64_t state[4]));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_SPLITMIX(uint64_t *state));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_PROPERTY_SETUP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_PROPERTY_DRAW(uint64_t bound));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool     _CUTL_PROPERTY_MORE(size_t len, size_t max_len));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void    *_CUTL_PROPERTY_ALLOC(size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_PROPERTY_DESCRIBE(const char *format, ...));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_PROPERTY_START(const char *func, const char *generators));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool     _CUTL_PROPERTY_SHRINK(bool accepted));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_PROPERTY_REPORT(bool failed));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool     _CUTL_PROPERTY_NEXT(void));
+
+#if _CUTL_POSIX
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool   _CUTL_FUZZ_RUN(void (*func)(const uint8_t *, size_t), const uint8_t *data, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool   _CUTL_FUZZ_COVERAGE(size_t *edges));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE size_t _CUTL_FUZZ_MUTATE(uint8_t *data, size_t size, size_t max_len));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool   _CUTL_FUZZ_SAVE(const char *prefix, const uint8_t *data, size_t size, char *path, size_t path_size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_FUZZ_CRASH(int signal));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool   _CUTL_FUZZ_LOAD(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_FUZZ_FREE(void));
+#endif
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void   _CUTL_FUZZ(void (*func)(const uint8_t *, size_t), const char *dir));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_BENCH_NEXT(uint64_t *iterations));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_BENCH_STATS(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int  _CUTL_BASELINE_KEY(char *buffer, size_t size, const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE _cutl_baseline_entry_t *_CUTL_BASELINE_ENTRY(const char *key, bool create));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_BASELINE_LOAD(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_BASELINE_CHECK(_cutl_result_t *result, char *note, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_BASELINE_SAVE(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_HASH(const void *data, size_t size, uint64_t hash));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_PROGRAM_HASH(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_CACHE_SETUP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE uint64_t _CUTL_CACHE_KEY(const char *key, const char *tags));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool     _CUTL_CACHE_HIT(uint64_t key));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_CACHE_ADD(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool     _CUTL_CACHE_WRITE(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void     _CUTL_CACHE_SAVE(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_SHARD_SETUP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_SHARD_MINE(const char *key));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMINGS_ADD(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_TIMINGS_WRITE(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMINGS_SAVE(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REGISTER_TEST(_cutl_test_desc_t *test));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_GLOB_MATCH(const char *pattern, const char *pattern_end, const char *str));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_LIST_MATCH(const char *list, const char *tags, bool globs));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_TEST_SELECTED(const char *func, const char *tags));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE _cutl_suite_t *_CUTL_SUITE_OF(const char *file));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_SUITE_START(const _cutl_test_desc_t *first, const char *runner));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_SUITE_END(_cutl_suite_t *suite));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_SUITE_SUMMARY(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_CRASH_RESULT(_cutl_result_t *result, int wait_status));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMEOUT_SETUP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMEOUT_PREPARE(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMEOUT_ARM(unsigned int ms));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMEOUT_HANDLER(int signal));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_TIMEOUT_REGISTER(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REPORT_TIMEOUT_SUMMARY(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_SKIPPED(char *buffer, size_t size));
+
+#if _CUTL_TRACK_ALLOC
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_ALLOC_RECORD(void *ptr, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_FREE_RECORD(void *ptr));
+#endif
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_ALLOC_RESET(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE _cutl_alloc_scope_t _CUTL_ALLOC_SCOPE_START(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_ALLOC_SCOPE_CHECK(const _cutl_alloc_scope_t *scope, uint64_t max_count,
+                                                              uint64_t max_bytes, int line, const char *assertion));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_BYTES(double bytes, char *buffer, size_t size));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_PERF_SETUP(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_PERF_OPEN(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_PERF_READ(_cutl_perf_reading_t *readings));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_PERF_ADD(_cutl_perf_t *perf, const _cutl_perf_reading_t *start,
+                                                     const _cutl_perf_reading_t *end));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_PERF(const _cutl_perf_t *perf, char *buffer, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_COUNT(double count, char *buffer, size_t size));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE size_t _CUTL_MEM_MISMATCH(const void *p1, const void *p2, size_t nbytes));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE __CUTL_COLD void _CUTL_REGISTER_MISMATCH(int line, const char *assertion, const char *unit,
+                                                                          const char *name1, const void *p1,
+                                                                          const char *name2, const void *p2,
+                                                                          size_t elem_size, int kind, size_t index, size_t n));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE int    _CUTL_FORMAT_WINDOW(char *buffer, size_t size, const char *name, int width,
+                                                            const void *p, size_t elem_size, int kind,
+                                                            size_t index, size_t n));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE double _CUTL_NEAR_ERROR(int kind, bool single, double v1, double v2));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE const char *_CUTL_FORMAT_NEAR_ERROR(int kind, double error, char *buffer, size_t size));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool   _CUTL_CHECK_NEAR(int line, const char *assertion, int kind, bool single,
+                                                         const void *p1, const void *p2, size_t n, bool array, double tol));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_ARENA_MARK(_cutl_arena_mark_t *mark));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_ARENA_RELEASE(const _cutl_arena_mark_t *mark));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_ARENA_RESET(void));
+
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_POOL_START(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_POOL_END(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_POOL_WRITE(FILE *file, const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REMOTE_START(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REMOTE_ADD(const char *file, const char *func, const char *args, int line,
+                                                       unsigned int call));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE bool _CUTL_REMOTE_CLAIM(unsigned long index));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REMOTE_SEND_RESULT(const _cutl_result_t *result));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REMOTE_END(void));
+__CUTL_DECL_UNUSED(_CUTL_LINKAGE void _CUTL_REMOTE_EXIT(void));
+
+
+
+// What follows, up to the macros for testing, is the implementation. Only
+// the file defining CUTL_IMPLEMENTATION gets it in split mode.
+#if _CUTL_IMPLEMENT
+
+
+// Available outputs, indexed by CUTL_OUTPUT_*
+_CUTL_LINKAGE _cutl_output_t _cutl_outputs[_CUTL_N_OUTPUTS] = {
+    { "CUTL_JUNIT_FILE", NULL, NULL, 0, 0, 0, 0, _CUTL_JUNIT_BEGIN, _CUTL_JUNIT_TEST, _CUTL_JUNIT_END },
+    { "CUTL_JSON_FILE",  NULL, NULL, 0, 0, 0, 0, _CUTL_JSON_BEGIN,  _CUTL_JSON_TEST,  _CUTL_JSON_END  },
+};
+
+
+
+// ==========================================================================
+// Configs
+// ==========================================================================
+
+/**
+ * Sets CuTL configurations. The function receives a series of flags that can
+ * be combined with the OR operator. Current available flags are:
+ * 
+ *   - CUTL_FLAG_STOP_AT_FAIL : If provided, the execution will be aborted
+ *         upon test failure.
+ *
+ *   - CUTL_FLAG_PARALLEL : If provided, tests are spread across a pool of
+ *         worker processes (see cutl_config_workers). Tests must not depend
+ *         on the side effects of previous tests. Only available on POSIX
+ *         systems; elsewhere tests run sequentially.
+ *
+ *   - CUTL_FLAG_TIMING : If provided, the wall and CPU time of each test
+ *         and of its CUTL_BEFORE_EACH/CUTL_AFTER_EACH are shown along with
+ *         its result, and the slowest tests are listed at the end.
+ *
+ *   - CUTL_FLAG_QUIET : If provided, passed tests are not reported, only
+ *         failures, errors and the summary.
+ *
+ *   - CUTL_FLAG_SUMMARY_ONLY : If provided, only the summary is reported.
+ *
+ *   The CUTL_VERBOSITY environment variable ("all", "failures" or
+ *   "summary") takes precedence over the last two flags.
+ *
+ *   - CUTL_FLAG_ISOLATE : If provided, the process stays as a fork server
+ *         once CUTL_BEFORE_ALL has run, and every test runs in a
+ *         copy-on-write child of it. All tests start from the very same
+ *         state, and a crash or an abort() only ends the test that caused
+ *         it, which is reported as an error. Only available on POSIX systems.
+ *
+ *   - CUTL_FLAG_PERF : If provided, the CPU events of each test function
+ *         are counted and shown along with its result: cycles,
+ *         instructions, branch misses, and L1 data and last level cache
+ *         misses. Benchmarks show them per operation instead. Where the
+ *         hardware counters cannot be used, e.g. in most containers, the
+ *         task clock and page faults are counted instead. Threads started
+ *         by the test are counted once they end. Only available on Linux,
+ *         and the CUTL_PERF environment variable (1 or 0) takes precedence.
+ */
+void cutl_config(int flags) {
+    _cutl_stop_at_fail = (bool)(flags & CUTL_FLAG_STOP_AT_FAIL);
+    _cutl_parallel     = (bool)(flags & CUTL_FLAG_PARALLEL);
+    _cutl_isolate      = (bool)(flags & CUTL_FLAG_ISOLATE);
+    _cutl_timing       = (bool)(flags & CUTL_FLAG_TIMING);
+    _cutl_perf         = (bool)(flags & CUTL_FLAG_PERF);
+
+    _cutl_verbosity = (flags & CUTL_FLAG_SUMMARY_ONLY) ? _CUTL_VERBOSITY_SUMMARY
+                    : (flags & CUTL_FLAG_QUIET)        ? _CUTL_VERBOSITY_FAILURES
+                    :                                    _CUTL_VERBOSITY_ALL;
+}
+
+
+/**
+ * Sets the file where the reports are written. It must be called before
+ * CUTL_BEGIN_TEST. The CUTL_REPORT_FILE environment variable, if set,
+ * takes precedence.
+ */
+void cutl_config_report_file(const char *path) {
+    _cutl_report_path = path;
+}
+
+
+/**
+ * Writes the results of the tests to a file as they are reported, in one
+ * of these formats:
+ *
+ *   - CUTL_OUTPUT_JUNIT : JUnit XML, with one <testcase> per test.
+ *   - CUTL_OUTPUT_JSON  : JSON Lines, with one object per test and a last
+ *         one with the summary.
+ *
+ * Both include the timing of each test. It must be called before
+ * CUTL_BEGIN_TEST, and the CUTL_JUNIT_FILE and CUTL_JSON_FILE environment
+ * variables take precedence.
+ */
+void cutl_config_output(int format, const char *path) {
+    if (format >= 0 && format < _CUTL_N_OUTPUTS) {
+        _cutl_outputs[format].path = path;
+    }
+}
+
+
+/**
+ * Sets the number of worker processes used by CUTL_FLAG_PARALLEL. If 0
+ * (default), one worker per online CPU is used. The CUTL_WORKERS
+ * environment variable, if set, takes precedence.
+ */
+void cutl_config_workers(unsigned int n) {
+    _cutl_n_workers = n;
+}
+
+
+/**
+ * Sets how many of the slowest tests are listed at the end of the run
+ * when CUTL_FLAG_TIMING is provided. The default is 10.
+ */
+void cutl_config_slowest(unsigned int n) {
+    _cutl_n_slowest = n;
+}
+
+
+/**
+ * Sets how benchmarks are measured: the number of samples taken and the
+ * time each sample should last, in milliseconds. Zero keeps the current
+ * value. The defaults are 30 samples of 10 ms.
+ */
+void cutl_config_bench(unsigned int samples, unsigned int sample_ms) {
+    if (samples > 0) {
+        _cutl_bench_samples = samples;
+    }
+
+    if (sample_ms > 0) {
+        _cutl_bench_sample_ms = sample_ms;
+    }
+}
+
+
+/**
+ * Compares the benchmarks against the baseline stored in a file. A
+ * benchmark fails when its median is slower than in the baseline by more
+ * than the tolerance (e.g. 0.10 for 10%) and by more than the given number
+ * of standard errors of the difference (e.g. 3), so that noise alone does
+ * not fail it. With 0 sigmas, only the tolerance is checked.
+ *
+ * If the CUTL_BASELINE_UPDATE environment variable is set to 1, nothing
+ * fails and the file is rewritten with the results of the run. The
+ * CUTL_BASELINE environment variable, if set, takes precedence over path.
+ */
+void cutl_config_baseline(const char *path, double tolerance, double sigmas) {
+    _cutl_baseline_path      = path;
+    _cutl_baseline_tolerance = tolerance;
+    _cutl_baseline_sigmas    = sigmas;
+}
+
+
+/**
+ * Sets how long, in milliseconds, each test and the whole run may last.
+ * A test that takes longer, including CUTL_BEFORE_EACH and CUTL_AFTER_EACH,
+ * is stopped and reported as an error. Once the whole run is over time,
+ * the test running is stopped and the rest are not run. Zero means no
+ * limit, which is the default.
+ *
+ * Isolated tests (CUTL_FLAG_ISOLATE) are killed, which is always safe.
+ * Otherwise the test function is interrupted by a signal, and whatever it
+ * was doing is left half done. A test stuck in CUTL_BEFORE_EACH or
+ * CUTL_AFTER_EACH cannot be left, so the run ends there. Only available on
+ * POSIX systems.
+ *
+ * The CUTL_TIMEOUT and CUTL_TOTAL_TIMEOUT environment variables, if set,
+ * take precedence.
+ */
+void cutl_config_timeout(unsigned int test_ms, unsigned int total_ms) {
+    _cutl_timeout_ms       = test_ms;
+    _cutl_timeout_total_ms = total_ms;
+}
+
+
+/**
+ * Sets how many random cases every CUTL_PROPERTY runs, 10000 by default,
+ * and the seed they are made from. A seed of 0, the default, makes up a
+ * new one for every run, which is told when a property fails. The
+ * CUTL_PROPERTY_CASES and CUTL_SEED environment variables, if set, take
+ * precedence.
+ */
+void cutl_config_property(unsigned int cases, uint64_t seed) {
+    _cutl_property_cases = cases;
+    _cutl_property_seed  = seed;
+}
+
+
+/**
+ * Keeps the results of the tests in a cache file, so that tests that
+ * passed before are not run again while nothing they depend on changes.
+ * They are reported as passed, marked as cached. Failed tests always run:
+ * every call of a test is kept apart, even one made in a loop, and one
+ * that failed anywhere in a run is not kept.
+ *
+ * What a test depends on is told by deps, a hash of anything the tests
+ * use, such as data files or libraries. With 0, it is the test program
+ * itself (only on Linux), so rebuilding it with any change runs all its
+ * tests again. Benchmarks, stress tests, properties, case files and fuzz
+ * targets are never cached.
+ *
+ * Several programs, or runs of them, may share the same file. The
+ * CUTL_CACHE environment variable, if set, takes precedence over path.
+ */
+void cutl_config_cache(const char *path, uint64_t deps) {
+    _cutl_cache_path = path;
+    _cutl_cache_deps = deps;
+}
+
+
+/**
+ * Runs only one of count shards of the tests, the one with the given
+ * index, from 0 to count - 1. Every test belongs to a single shard, so
+ * running all of them, on as many processes or machines, runs every test
+ * once. Tests are spread by a hash of their call (see _CUTL_TEST_KEY),
+ * which does not change from run to run.
+ *
+ * If timings names a file with the durations of the tests, those found in
+ * it are spread so that every shard takes about the same time, longest
+ * first. Every shard must read the same file. The durations of the tests
+ * run are kept in it when not sharding, and in <timings>.<index> by every
+ * shard, so the files of all the shards put together (e.g. with cat) make
+ * the timings file of the next run. The
+ * CUTL_SHARD_INDEX, CUTL_SHARD_COUNT and CUTL_TIMINGS environment
+ * variables, if set, take precedence.
+ */
+void cutl_config_shard(unsigned int index, unsigned int count, const char *timings) {
+    _cutl_shard_index   = index;
+    _cutl_shard_count   = count;
+    _cutl_timings_path  = timings;
+    _cutl_shard_loaded  = false;
+}
+
+
+/**
+ * Runs the tests on workers, which may be on other machines. Given
+ * CUTL_REMOTE_COORDINATOR, this process does not run the tests, but waits
+ * for workers at the address and hands the tests out to them, reporting
+ * their results and the summary of the run as usual. Given
+ * CUTL_REMOTE_WORKER, it connects to the coordinator at the address, runs
+ * the tests it is given and sends their results back to it.
+ *
+ * The address is "HOST:PORT" or "unix:PATH" (default: 127.0.0.1:7357 for
+ * the coordinator). Workers must run the same build of the program, with
+ * the same options as the coordinator. Those lost while running a test
+ * leave it as an error, and the rest of their tests to the others, or to
+ * workers that connect later on. The CUTL_COORDINATOR and CUTL_WORKER
+ * environment variables, set to an address, take precedence.
+ */
+void cutl_config_remote(int role, const char *address) {
+    _cutl_remote_role    = role;
+    _cutl_remote_address = address;
+}
+
+
+/**
+ * Sets the timeout of the next test, in place of the one set with
+ * cutl_config_timeout(). Zero means no limit.
+ */
+void cutl_config_next_timeout(unsigned int ms) {
+    _cutl_timeout_next_ms = ms + 1;     // 0 is kept for no override
+}
+
+
+
+// ==========================================================================
+// REPORTS
+// ==========================================================================
+
+
+#define _CUTL_ANSI_RESET "\033[0m"
+#define _CUTL_ANSI_RED   "\033[31m"
+#define _CUTL_ANSI_GREEN "\033[32m"
+#define _CUTL_ANSI_BLUE  "\033[34m"
+#define _CUTL_ANSI_CYAN  "\033[36m"
+
+#define _CUTL_RGB_SUCCESS _CUTL_ANSI_GREEN
+#define _CUTL_RGB_FAILURE _CUTL_ANSI_RED
+#define _CUTL_RGB_INFO    _CUTL_ANSI_RESET
+#define _CUTL_RGB_DEBUG   _CUTL_ANSI_BLUE
+#define _CUTL_RGB_ERROR   _CUTL_ANSI_RED
+#define _CUTL_RGB_BENCH   _CUTL_ANSI_CYAN
+
+
+
+/**
+ * Opens the report file and decides how to write to it. The file set with
+ * cutl_config_report_file(), or in the CUTL_REPORT_FILE environment
+ * variable, is used if possible, or the standard output otherwise.
+ */
+void _CUTL_REPORT_OPEN(void) {
+    const char *path      = getenv("CUTL_REPORT_FILE");
+    const char *verbosity = getenv("CUTL_VERBOSITY");
+
+    if (path == NULL || *path == '\0') {
+        path = _cutl_report_path;
+    }
+
+    if (path != NULL && (_cutl_report_file = fopen(path, "w")) == NULL) {
+        fprintf(stderr, "CutL: could not open %s, reporting to stdout\n", path);
+    }
+
+    if (_cutl_report_file == NULL) {
+        _cutl_report_file = stdout;
+    }
+
+    if (verbosity != NULL) {
+        if (strcmp(verbosity, "all") == 0)      _cutl_verbosity = _CUTL_VERBOSITY_ALL;
+        if (strcmp(verbosity, "failures") == 0) _cutl_verbosity = _CUTL_VERBOSITY_FAILURES;
+        if (strcmp(verbosity, "summary") == 0)  _cutl_verbosity = _CUTL_VERBOSITY_SUMMARY;
+    }
+
+#if _CUTL_POSIX
+    _cutl_report_interactive = isatty(fileno(_cutl_report_file));
+#else
+    _cutl_report_interactive = (_cutl_report_file == stdout);
+#endif
+
+    _cutl_report_color = _cutl_report_interactive && getenv("NO_COLOR") == NULL;
+
+    // Whatever is still buffered when the program exits
+    if (!_cutl_report_atexit) {
+        _cutl_report_atexit = true;
+        atexit(_CUTL_REPORT_FLUSH);
+    }
+}
+
+
+/**
+ * Writes the buffered reports to the report file. Anything the program
+ * printed through the same FILE is flushed first, so it never comes out
+ * after reports made later than it.
+ */
+void _CUTL_REPORT_FLUSH(void) {
+    size_t written = 0;
+
+    if (_cutl_report_file == NULL) {
+        return;
+    }
+
+    fflush(_cutl_report_file);
+
+#if _CUTL_POSIX
+    while (written < _cutl_report_used) {
+        ssize_t n = write(fileno(_cutl_report_file), _cutl_report_buffer + written, _cutl_report_used - written);
+
+        if (n <= 0) {
+            break;
+        }
+
+        written += (size_t)n;
+    }
+#else
+    fwrite(_cutl_report_buffer, 1, _cutl_report_used, _cutl_report_file);
+    fflush(_cutl_report_file);
+#endif
+
+    (void)written;
+    _cutl_report_used = 0;
+}
+
+
+/**
+ * Formats a report line into the report buffer, if the verbosity allows
+ * it. The buffer is flushed when it cannot hold the line, and after every
+ * line when reporting to a terminal, so progress can be followed. Lines to
+ * the standard output are handed to its FILE at once, so they keep their
+ * place among what the tests and the hooks print.
+ */
+void _CUTL_REPORT_LINE(int verbosity, const char *color, const char *tag, const char *format, va_list args) {
+    size_t available;
+    int    len;
+
+    if (verbosity > _cutl_verbosity) {
+        return;
+    }
+
+    if (_cutl_report_file == NULL) {
+        _CUTL_REPORT_OPEN();
+    }
+
+    // Worst case of a line: color, tag, message and reset
+    if (_CUTL_REPORT_BUFFER_SIZE - _cutl_report_used < 64 + _CUTL_MAX_LEN_REPORT) {
+        _CUTL_REPORT_FLUSH();
+    }
+
+    available = _CUTL_REPORT_BUFFER_SIZE - _cutl_report_used;
+
+    len = snprintf(_cutl_report_buffer + _cutl_report_used, available, "%s%s",
+        _cutl_report_color ? color : "", tag);
+    _cutl_report_used += (size_t)len;
+
+    len = vsnprintf(_cutl_report_buffer + _cutl_report_used, _CUTL_MAX_LEN_REPORT, format, args);
+    _cutl_report_used += (len < 0) ? 0 : ((size_t)len < _CUTL_MAX_LEN_REPORT) ? (size_t)len : _CUTL_MAX_LEN_REPORT - 1;
+
+    available = _CUTL_REPORT_BUFFER_SIZE - _cutl_report_used;
+
+    len = snprintf(_cutl_report_buffer + _cutl_report_used, available, "%s\n",
+        _cutl_report_color ? _CUTL_ANSI_RESET : "");
+    _cutl_report_used += (size_t)len;
+
+    if (_cutl_report_file == stdout) {
+        fwrite(_cutl_report_buffer, 1, _cutl_report_used, stdout);
+        _cutl_report_used = 0;
+    }
+
+    if (_cutl_report_interactive) {
+        _CUTL_REPORT_FLUSH();
+    }
+}
+
+
+/**
+ * Reports successfull test
+ */
+__CUTL_UNUSED void _CUTL_REPORT_SUCCESS(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_ALL, _CUTL_RGB_SUCCESS, "====[PASSED]==== ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports failed test
+ */
+__CUTL_UNUSED void _CUTL_REPORT_FAILURE(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_FAILURES, _CUTL_RGB_FAILURE, "====[FAILED]==== ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports some information
+ */
+__CUTL_UNUSED void _CUTL_REPORT_INFO(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_SUMMARY, _CUTL_RGB_INFO, "=====[INFO]===== ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports some debug information
+ */
+__CUTL_UNUSED void _CUTL_REPORT_DEBUG(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_ALL, _CUTL_RGB_DEBUG, "====[DEBUG]====  ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports an unexpected error (not test failure)
+ */
+__CUTL_UNUSED void _CUTL_REPORT_ERROR(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_FAILURES, _CUTL_RGB_ERROR, "====[ERROR]====  ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports the measures of a benchmark
+ */
+__CUTL_UNUSED void _CUTL_REPORT_BENCH(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_ALL, _CUTL_RGB_BENCH, "====[BENCH]====  ", format, args);
+    va_end(args);
+}
+
+
+/**
+ * Reports the measures of a stress test
+ */
+__CUTL_UNUSED void _CUTL_REPORT_STRESS(const char *format, ...) {
+    va_list args;
+
+    va_start(args, format);
+    _CUTL_REPORT_LINE(_CUTL_VERBOSITY_ALL, _CUTL_RGB_BENCH, "====[STRESS]==== ", format, args);
+    va_end(args);
+}
+
+
+
+// ==========================================================================
+// MANAGING TESTS RESULTS
+// ==========================================================================
+
+
+/**
+ * Registers a test failure, but does not handle it
+ */
+void _CUTL_REGISTER_TEST_FAILURE(const int line, const char *msg) {
+    _CUTL_REGISTER_TEST_STATUS(_CUTL_FAILURE, line, msg);
+}
+
+
+/**
+ * Registers a test error
+ */
+void _CUTL_REGISTER_TEST_ERROR(const int line, const char *msg) {
+    _CUTL_REGISTER_TEST_STATUS(_CUTL_ERROR, line, msg);
+}
+
+
+/**
+ * Registers a failure or error in the context of the running test, from
+ * any thread. The first one is kept and the rest are only counted.
+ */
+void _CUTL_REGISTER_TEST_STATUS(int status, int line, const char *msg) {
+    _cutl_context_t *context = &_cutl_context;
+    size_t           len;
+
+    if (__atomic_exchange_n(&context->claimed, 1, __ATOMIC_ACQ_REL)) {
+        __atomic_fetch_add(&context->n_more_failures, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    context->failure_line = line;
+
+    if (_cutl_case_current != NULL) {
+        snprintf(context->failure_msg, _CUTL_MAX_LEN_MSG, "Case %zu at offset %zu: %s",
+            _cutl_case_current->index, _cutl_case_current->offset, msg);
+    }
+    else if (_cutl_fuzz_input != NULL) {
+        snprintf(context->failure_msg, _CUTL_MAX_LEN_MSG, "Input %.256s/%s: %s", _cutl_fuzz_dir, _cutl_fuzz_input, msg);
+    }
+    else {
+        len = strlen(msg);
+        len = (len < _CUTL_MAX_LEN_MSG) ? len : _CUTL_MAX_LEN_MSG - 1;
+
+        memcpy(context->failure_msg, msg, len);
+        context->failure_msg[len] = '\0';
+    }
+
+    __atomic_store_n(&context->status, status, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * Leaves the test function after a failed CUTL_THREAD_ASSERT*. The thread
+ * running the test jumps back to CutL, any other thread is ended.
+ */
+void _CUTL_THREAD_EXIT(void) {
+    if (_cutl_thread_context != NULL) {
+        if (_cutl_thread_context->in_body) {
+            _CUTL_LONGJMP(_cutl_thread_context->exit);
+        }
+
+        _CUTL_REPORT_ERROR("%s l:%d (%s)\n\tThread assertion failed outside of the test function",
+            _cutl_current_file, _cutl_current_line, _cutl_current_func);
+        _CUTL_REPORT_FLUSH();
+        abort();
+    }
+
+#if _CUTL_POSIX
+    pthread_exit(NULL);
+#else
+    abort();
+#endif
+}
+
+
+/**
+ * Reports whether if a test failed or was successful
+ */
+void _CUTL_REPORT_TEST_RESULT(const _cutl_result_t *result) {
+    char           timing[160] = "";
+    char           baseline[64] = "";
+    char           more[48] = "";
+    char           alloc[96] = "";
+    char           perf[256] = "";
+    char           cases[64] = "";
+    _cutl_result_t checked;
+    _cutl_suite_t *suite;
+
+    // Benchmarks may turn out to be regressions
+    if (result->bench.samples > 0 && result->status == _CUTL_SUCCESS) {
+        checked = *result;
+        _CUTL_BASELINE_CHECK(&checked, baseline, sizeof(baseline));
+        result = &checked;
+    }
+
+    if (_cutl_timing) {
+        char wall[16], user[16], sys[16], setup[16], teardown[16];
+
+        snprintf(timing, sizeof(timing), " [wall %s | user %s | sys %s | setup %s | teardown %s]",
+            _CUTL_FORMAT_DURATION(result->timing.wall_ns, wall, sizeof(wall)),
+            _CUTL_FORMAT_DURATION(result->timing.user_ns, user, sizeof(user)),
+            _CUTL_FORMAT_DURATION(result->timing.sys_ns, sys, sizeof(sys)),
+            _CUTL_FORMAT_DURATION(result->timing.setup_ns, setup, sizeof(setup)),
+            _CUTL_FORMAT_DURATION(result->timing.teardown_ns, teardown, sizeof(teardown))
+        );
+
+        _CUTL_TRACK_SLOWEST(result);
+    }
+
+    if (_CUTL_TRACK_ALLOC) {
+        char bytes[16], peak[16];
+
+        snprintf(alloc, sizeof(alloc), " [allocs %llu | %s | peak %s]",
+            (unsigned long long)result->alloc.count,
+            _CUTL_FORMAT_BYTES((double)result->alloc.bytes, bytes, sizeof(bytes)),
+            _CUTL_FORMAT_BYTES((double)result->alloc.peak_bytes, peak, sizeof(peak))
+        );
+    }
+
+    // Those of benchmarks are reported per operation along with their stats
+    if (result->perf.counted != 0 && result->bench.samples == 0) {
+        char counts[240];
+
+        snprintf(perf, sizeof(perf), " [%s]", _CUTL_FORMAT_PERF(&result->perf, counts, sizeof(counts)));
+    }
+
+    if (result->cases.total > 0) {
+        if (result->cases.failed > 0) {
+            snprintf(cases, sizeof(cases), " [%llu of %llu cases failed]",
+                (unsigned long long)result->cases.failed, (unsigned long long)result->cases.total);
+        }
+        else {
+            snprintf(cases, sizeof(cases), " [%llu cases]", (unsigned long long)result->cases.total);
+        }
+
+        _cutl_n_cases_passed += result->cases.total - result->cases.failed;
+        _cutl_n_cases_failed += result->cases.failed;
+    }
+
+    _CUTL_OUTPUT_TEST(result);
+    _CUTL_CACHE_ADD(result);
+    _CUTL_TIMINGS_ADD(result);
+
+    if (result->n_more_failures > 0) {
+        snprintf(more, sizeof(more), " (and %u more)", result->n_more_failures);
+    }
+
+    if ((suite = _CUTL_SUITE_OF(result->file)) != NULL) {
+        if (result->status == _CUTL_SUCCESS) {
+            suite->n_passed++;
+        }
+        else {
+            suite->n_failed++;
+        }
+    }
+
+    // Only counted, the summary tells how many were left out
+    if (result->skipped) {
+        _cutl_n_tests_skipped++;
+        return;
+    }
+
+    switch (result->status) {
+        case _CUTL_SUCCESS:
+            _cutl_n_tests_passed++;
+            _CUTL_REPORT_SUCCESS("%s l:%d (%s)%s%s%s%s%s",
+                result->file, result->line, result->func, result->cached ? " [cached]" : "",
+                cases, timing, alloc, perf
+            );
+
+            _CUTL_REPORT_BENCH_STATS(result, baseline);
+            _CUTL_REPORT_STRESS_STATS(result);
+
+            break;
+
+        case _CUTL_FAILURE:
+            _cutl_n_tests_failed++;
+            _CUTL_REPORT_FAILURE("%s l:%d (%s)%s%s%s%s\n\tFailure in line %d: %s%s",
+                result->file, result->line, result->func, cases, timing, alloc, perf,
+                result->failure_line, result->failure_msg, more
+            );
+
+            _CUTL_REPORT_BENCH_STATS(result, baseline);
+
+            if (_cutl_stop_at_fail) {
+                _CUTL_REPORT_INFO("Ending execution...");
+                exit(EXIT_FAILURE);
+            }
+
+            break;
+
+        case _CUTL_ERROR:
+            _cutl_n_tests_failed++;
+            _CUTL_REPORT_ERROR("%s l:%d (%s)%s%s%s%s\n\tError in line %d: %s%s",
+                result->file, result->line, result->func, cases, timing, alloc, perf,
+                result->failure_line, result->failure_msg, more
+            );
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+
+/**
+ * Reports the statistics of a benchmark, if the test was one
+ */
+void _CUTL_REPORT_BENCH_STATS(const _cutl_result_t *result, const char *note) {
+    char mean[16], min[16], median[16], stddev[16], p99[16];
+
+    if (result->bench.samples == 0) {
+        return;
+    }
+
+    _CUTL_REPORT_BENCH("%s/op | min %s | median %s | mean %s +- %s | p99 %s | %u x %llu iterations%s",
+        _CUTL_FORMAT_DURATION(result->bench.mean_ns, mean, sizeof(mean)),
+        _CUTL_FORMAT_DURATION(result->bench.min_ns, min, sizeof(min)),
+        _CUTL_FORMAT_DURATION(result->bench.median_ns, median, sizeof(median)),
+        mean,
+        _CUTL_FORMAT_DURATION(result->bench.stddev_ns, stddev, sizeof(stddev)),
+        _CUTL_FORMAT_DURATION(result->bench.p99_ns, p99, sizeof(p99)),
+        result->bench.samples, (unsigned long long)result->bench.iterations, note
+    );
+
+    if (result->perf.counted != 0) {
+        char counts[240];
+
+        _CUTL_REPORT_BENCH("per op: %s", _CUTL_FORMAT_PERF(&result->perf, counts, sizeof(counts)));
+    }
+}
+
+
+/**
+ * Hands the result of a test over to whoever has to report it. Workers
+ * store it for the main process, or send it to the coordinator, while the
+ * main process reports it right away.
+ */
+void _CUTL_RECORD_TEST_RESULT(const _cutl_result_t *result) {
+    if (_cutl_remote_role == CUTL_REMOTE_WORKER) {
+        _CUTL_REMOTE_SEND_RESULT(result);
+        return;
+    }
+
+    if (_cutl_worker_id < 0) {
+        _CUTL_REPORT_TEST_RESULT(result);
+        return;
+    }
+
+    _CUTL_POOL_WRITE(_cutl_worker_out[_cutl_worker_id], result);
+
+    __atomic_store_n(&_cutl_pool->running[_cutl_worker_id].status, -1, __ATOMIC_RELEASE);
+
+    if (result->status != _CUTL_SUCCESS && _cutl_stop_at_fail) {
+        __atomic_store_n(&_cutl_pool->stop, 1, __ATOMIC_RELAXED);
+    }
+}
+
+
+
+// ==========================================================================
+// RUNNING TESTS
+// ==========================================================================
+
+
+/**
+ * Writes the key that tells a call of a test apart from the rest in the
+ * cache and timings files:
+ *
+ *     <file> <TAB> <line> <TAB> <func> <TAB> <params> <TAB> <call>
+ *
+ * Params are as written, so the same call in a loop is told apart by the
+ * times it was reached before. Returns the length of the key, which is
+ * cut off at size - 1.
+ */
+int _CUTL_TEST_KEY(char *buffer, size_t size, const char *file, int line, const char *func,
+                   const char *args, unsigned int call) {
+    return snprintf(buffer, size, "%s\t%d\t%s\t%s\t%u", file, line, func, (args != NULL) ? args : "", call);
+}
+
+
+/**
+ * Prepares the next test in program order. Returns whether this process
+ * has to run it.
+ */
+bool _CUTL_TEST_START(const char *file, const char *func, const char *args, const char *tags,
+                      const int line, unsigned int call) {
+    unsigned long index;
+    unsigned int  timeout = _cutl_timeout_ms;
+    bool          total   = false;
+    bool          expired = false;
+    bool          keyed;
+    char          key[2 * _CUTL_MAX_LEN_MSG];
+
+    if (_cutl_timeout_next_ms > 0) {
+        timeout = _cutl_timeout_next_ms - 1;
+        _cutl_timeout_next_ms = 0;
+    }
+
+    if (!_CUTL_TEST_SELECTED(func, tags)) {
+        return false;
+    }
+
+    if (!_cutl_shard_loaded) {
+        _CUTL_SHARD_SETUP();
+    }
+
+    // The key is only written when sharding or the cache need it
+    keyed = (_cutl_shard_count > 1 || _cutl_cache_path != NULL);
+
+    if (keyed) {
+        _CUTL_TEST_KEY(key, sizeof(key), file, line, func, args, call);
+
+        if (!_CUTL_SHARD_MINE(key)) {
+            return false;
+        }
+    }
+
+    index = _cutl_test_index++;
+
+    // The coordinator only takes note of the tests to hand them out
+    if (_cutl_remote_role == CUTL_REMOTE_COORDINATOR) {
+        _CUTL_REMOTE_ADD(file, func, args, line, call);
+        return false;
+    }
+
+    // What is left of the time of the whole run bounds that of the test
+    if (_cutl_timeout_total_ms > 0) {
+        uint64_t elapsed_ms = (_CUTL_NOW_NS() - _cutl_run_start) / 1000000u;
+
+        if (elapsed_ms >= _cutl_timeout_total_ms) {
+            expired = true;
+        }
+        else if (timeout == 0 || _cutl_timeout_total_ms - elapsed_ms < timeout) {
+            timeout = (unsigned int)(_cutl_timeout_total_ms - elapsed_ms);
+            total   = true;
+        }
+    }
+
+    // Fuzzing goes on for as long as it was told, each run having the timeout
+    if (_cutl_fuzz && tags != NULL && _CUTL_LIST_MATCH("fuzz", tags, false)) {
+        _cutl_fuzz_run_ms = timeout;
+        timeout = 0;
+
+        snprintf(_cutl_timeout_msg, _CUTL_MAX_LEN_MSG, "Run timed out after %u ms", _cutl_fuzz_run_ms);
+    }
+
+    _cutl_timeout_test_ms = timeout;
+
+    if (timeout > 0) {
+        snprintf(_cutl_timeout_msg, _CUTL_MAX_LEN_MSG, "Test timed out after %u ms%s",
+            timeout, total ? " (total timeout of the run)" : "");
+    }
+
+    _cutl_current_file = (char *)file;
+    _cutl_current_func = (char *)func;
+    _cutl_current_args = (char *)args;
+    _cutl_current_line = line;
+    _cutl_current_call = call;
+
+    if (_cutl_remote_role == CUTL_REMOTE_WORKER && !_CUTL_REMOTE_CLAIM(index)) {
+        return false;
+    }
+
+    if (_cutl_pool != NULL) {
+        _cutl_result_t *running;
+
+        // The main process only collects results
+        if (_cutl_worker_id < 0) {
+            return false;
+        }
+
+        if (__atomic_load_n(&_cutl_pool->stop, __ATOMIC_RELAXED)) {
+            return false;
+        }
+
+        if (!__atomic_compare_exchange_n(&_cutl_pool->next, &index, index + 1,
+                false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return false;
+        }
+
+        running = &_cutl_pool->running[_cutl_worker_id];
+        running->index = index;
+        running->file  = _cutl_current_file;
+        running->func  = func;
+        running->args  = args;
+        running->line  = line;
+        running->call  = call;
+
+        __atomic_store_n(&running->status, _CUTL_SUCCESS, __ATOMIC_RELEASE);
+    }
+
+    // Tests past the total timeout are not run, and count as errors.
+    // Tests that passed before with nothing changed are not run again.
+    _cutl_cache_key = (expired || !keyed) ? 0 : _CUTL_CACHE_KEY(key, tags);
+
+    if (expired || _CUTL_CACHE_HIT(_cutl_cache_key)) {
+        _cutl_result_t result;
+
+        memset(&result, 0, sizeof(result));
+        result.index  = index;
+        result.file   = _cutl_current_file;
+        result.func   = func;
+        result.args   = args;
+        result.line   = line;
+        result.call   = call;
+        result.status = expired ? _CUTL_ERROR : _CUTL_SUCCESS;
+        result.cached = !expired;
+
+        if (expired) {
+            result.skipped      = true;
+            result.failure_line = line;
+            snprintf(result.failure_msg, _CUTL_MAX_LEN_MSG, "Not run, the run went over its total timeout of %u ms",
+                _cutl_timeout_total_ms);
+        }
+
+        _CUTL_RECORD_TEST_RESULT(&result);
+        return false;
+    }
+
+    if (_cutl_isolate && !_CUTL_TEST_FORK()) {
+        return false;
+    }
+
+    // Isolated tests are watched by their parent instead
+    if (_cutl_isolated_fd < 0 && _cutl_timeout_test_ms > 0) {
+        _CUTL_TIMEOUT_PREPARE();
+        _CUTL_TIMEOUT_ARM(_cutl_timeout_test_ms);
+    }
+
+    _CUTL_PERF_OPEN();
+
+    _cutl_thread_context = &_cutl_context;
+
+    _CUTL_ALLOC_RESET();
+
+    if (_cutl_measure) {
+        _cutl_mark_setup = _CUTL_NOW_NS();
+    }
+
+    return true;
+}
+
+
+/**
+ * Called right before the test function, once CUTL_BEFORE_EACH is done
+ */
+void _CUTL_TEST_BODY_START(void) {
+    _cutl_context.status          = _CUTL_SUCCESS;
+    _cutl_context.claimed         = 0;
+    _cutl_context.n_more_failures = 0;
+    _cutl_context.in_body         = true;
+
+    _cutl_bench_phase = _CUTL_BENCH_IDLE;
+    _cutl_bench_stats.samples = 0;
+    _cutl_stress_stats.rounds = 0;
+    _cutl_cases_stats.total   = 0;
+    _cutl_cases_stats.failed  = 0;
+
+    if (_cutl_measure) {
+        _CUTL_CPU_NS(&_cutl_mark_user, &_cutl_mark_sys);
+        _cutl_mark_body = _CUTL_NOW_NS();
+    }
+
+    if (_cutl_perf_open != 0) {
+        memset(&_cutl_perf_stats, 0, sizeof(_cutl_perf_stats));
+        _cutl_perf_stats.counted = _cutl_perf_open;
+        _cutl_perf_bench = _cutl_perf_stats;
+
+        _CUTL_PERF_READ(_cutl_perf_mark);
+    }
+}
+
+
+/**
+ * Called right after the test function, before CUTL_AFTER_EACH
+ */
+void _CUTL_TEST_BODY_END(void) {
+    _CUTL_TIMEOUT_REGISTER();
+
+    if (_cutl_perf_open != 0) {
+        _cutl_perf_reading_t end[_CUTL_N_PERF];
+
+        _CUTL_PERF_READ(end);
+        _CUTL_PERF_ADD(&_cutl_perf_stats, _cutl_perf_mark, end);
+    }
+
+    _cutl_context.in_body = false;
+
+    // A case that did not return, ended by a THREAD_ASSERT* or an error
+    if (_cutl_case_current != NULL) {
+        _cutl_cases_stats.total++;
+        _cutl_cases_stats.failed++;
+        _cutl_case_current = NULL;
+    }
+
+    _CUTL_CASES_UNMAP();
+
+    if (_cutl_measure) {
+        uint64_t user_ns, sys_ns;
+
+        _cutl_mark_teardown = _CUTL_NOW_NS();
+        _CUTL_CPU_NS(&user_ns, &sys_ns);
+
+        _cutl_mark_user = user_ns - _cutl_mark_user;
+        _cutl_mark_sys  = sys_ns - _cutl_mark_sys;
+    }
+}
+
+
+/**
+ * Collects the result of the test that has just run
+ */
+void _CUTL_TEST_FINISH(void) {
+    _cutl_result_t result;
+
+    _CUTL_TIMEOUT_ARM(0);
+    _CUTL_ARENA_RESET();
+
+    result.alloc = _cutl_alloc;
+
+    if (_CUTL_TRACK_ALLOC && result.alloc.in_use > 0
+            && __atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE) == _CUTL_SUCCESS) {
+        char msg[_CUTL_MAX_LEN_MSG];
+
+        snprintf(msg, sizeof(msg), "Leaked %lld allocations (%lld bytes) by the end of CUTL_AFTER_EACH",
+            (long long)result.alloc.in_use, (long long)result.alloc.in_use_bytes);
+
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, msg);
+    }
+
+    result.index        = _cutl_test_index - 1;
+    result.file         = _cutl_current_file;
+    result.func         = _cutl_current_func;
+    result.args         = _cutl_current_args;
+    result.line         = _cutl_current_line;
+    result.call         = _cutl_current_call;
+    result.status       = __atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE);
+    result.failure_line = _cutl_context.failure_line;
+
+    result.n_more_failures = __atomic_load_n(&_cutl_context.n_more_failures, __ATOMIC_RELAXED);
+
+    if (result.status == _CUTL_SUCCESS) {
+        result.failure_msg[0] = '\0';
+    }
+    else {
+        memcpy(result.failure_msg, _cutl_context.failure_msg, _CUTL_MAX_LEN_MSG);
+    }
+
+    if (_cutl_measure) {
+        result.timing.wall_ns     = _cutl_mark_teardown - _cutl_mark_body;
+        result.timing.user_ns     = _cutl_mark_user;
+        result.timing.sys_ns      = _cutl_mark_sys;
+        result.timing.setup_ns    = _cutl_mark_body - _cutl_mark_setup;
+        result.timing.teardown_ns = _CUTL_NOW_NS() - _cutl_mark_teardown;
+    }
+    else {
+        memset(&result.timing, 0, sizeof(result.timing));
+    }
+
+    result.bench  = _cutl_bench_stats;
+    result.stress = _cutl_stress_stats;
+    result.cases  = _cutl_cases_stats;
+
+    result.cache_key = _cutl_cache_key;
+    result.cached    = false;
+    result.skipped   = false;
+
+    if (_cutl_perf_open == 0) {
+        memset(&result.perf, 0, sizeof(result.perf));
+    }
+    else if (result.bench.samples > 0) {
+        int i;
+
+        result.perf = _cutl_perf_bench;
+
+        for (i = 0; i < _CUTL_N_PERF; i++) {
+            result.perf.value[i] /= (double)result.bench.samples * (double)result.bench.iterations;
+        }
+    }
+    else {
+        result.perf = _cutl_perf_stats;
+    }
+
+#if _CUTL_POSIX
+    if (_cutl_isolated_fd >= 0) {
+        const char *data = (const char *)&result;
+        size_t      sent = 0;
+
+        while (sent < sizeof(result)) {
+            ssize_t n = write(_cutl_isolated_fd, data + sent, sizeof(result) - sent);
+
+            if (n <= 0) {
+                break;
+            }
+
+            sent += (size_t)n;
+        }
+
+        _CUTL_REPORT_FLUSH();
+        fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+#endif
+
+    _CUTL_RECORD_TEST_RESULT(&result);
+}
+
+
+#if _CUTL_POSIX
+
+/**
+ * Turns the result of a test whose process did not finish properly into
+ * an error, explaining how the process ended.
+ */
+void _CUTL_CRASH_RESULT(_cutl_result_t *result, int wait_status) {
+    result->status       = _CUTL_ERROR;
+    result->failure_line = result->line;
+
+    result->n_more_failures = 0;
+
+    if (WIFSIGNALED(wait_status)) {
+        snprintf(result->failure_msg, _CUTL_MAX_LEN_MSG,
+            "Test terminated by signal %d (%s)",
+            WTERMSIG(wait_status), strsignal(WTERMSIG(wait_status)));
+    }
+    else {
+        snprintf(result->failure_msg, _CUTL_MAX_LEN_MSG,
+            "Test exited with status %d before finishing", WEXITSTATUS(wait_status));
+    }
+}
+
+
+/**
+ * Runs the current test in a child process. The child returns true and
+ * goes on to run the test, while the parent waits for its result, records
+ * it and returns false.
+ */
+bool _CUTL_TEST_FORK(void) {
+    _cutl_result_t result;
+    size_t         received = 0;
+    int            fds[2];
+    int            status = 0;
+    bool           timed_out = false;
+    uint64_t       deadline;
+    pid_t          pid;
+
+    if (pipe(fds) != 0) {
+        _CUTL_REPORT_INFO("Could not isolate %s, running it in process", _cutl_current_func);
+        return true;
+    }
+
+    // Buffered output would be written by both processes otherwise
+    _CUTL_REPORT_FLUSH();
+    fflush(NULL);
+
+    pid = fork();
+
+    if (pid == 0) {
+        close(fds[0]);
+        _cutl_isolated_fd = fds[1];
+        return true;
+    }
+
+    close(fds[1]);
+
+    if (pid < 0) {
+        close(fds[0]);
+        _CUTL_REPORT_INFO("Could not isolate %s, running it in process", _cutl_current_func);
+        return true;
+    }
+
+    deadline = _CUTL_NOW_NS() + (uint64_t)_cutl_timeout_test_ms * 1000000u;
+
+    while (received < sizeof(result)) {
+        ssize_t n;
+
+        if (_cutl_timeout_test_ms > 0) {
+            struct pollfd fd  = { fds[0], POLLIN, 0 };
+            uint64_t      now = _CUTL_NOW_NS();
+
+            if (now >= deadline || poll(&fd, 1, (int)((deadline - now + 999999u) / 1000000u)) == 0) {
+                timed_out = true;
+                kill(pid, SIGKILL);
+                break;
+            }
+        }
+
+        n = read(fds[0], (char *)&result + received, sizeof(result) - received);
+
+        if (n <= 0) {
+            break;
+        }
+
+        received += (size_t)n;
+    }
+
+    close(fds[0]);
+    waitpid(pid, &status, 0);
+
+    if (timed_out) {
+        memset(&result, 0, sizeof(result));
+
+        result.index        = _cutl_test_index - 1;
+        result.file         = _cutl_current_file;
+        result.func         = _cutl_current_func;
+        result.args         = _cutl_current_args;
+        result.line         = _cutl_current_line;
+        result.call         = _cutl_current_call;
+        result.status       = _CUTL_ERROR;
+        result.failure_line = _cutl_current_line;
+
+        memcpy(result.failure_msg, _cutl_timeout_msg, _CUTL_MAX_LEN_MSG);
+    }
+    else if (received < sizeof(result)) {
+        memset(&result, 0, sizeof(result));
+
+        result.index = _cutl_test_index - 1;
+        result.file  = _cutl_current_file;
+        result.func  = _cutl_current_func;
+        result.args  = _cutl_current_args;
+        result.line  = _cutl_current_line;
+        result.call  = _cutl_current_call;
+
+        _CUTL_CRASH_RESULT(&result, status);
+    }
+
+    _CUTL_RECORD_TEST_RESULT(&result);
+
+    return false;
+}
+
+#else
+
+bool _CUTL_TEST_FORK(void) { return true; }
+void _CUTL_CRASH_RESULT(_cutl_result_t *result, int wait_status) { (void)result; (void)wait_status; }
+
+#endif /* _CUTL_POSIX */
+
+
+#if _CUTL_POSIX && (defined(__GNUC__) || defined(__clang__))
+
+/**
+ * Forks the pool of workers if running in parallel mode. Each worker goes
+ * on with the program, while the main process only keeps track of it.
+ */
+void _CUTL_POOL_START(void) {
+    const char  *env = getenv("CUTL_WORKERS");
+    unsigned int n   = _cutl_n_workers;
+    unsigned int w;
+
+    // Remote runs hand the tests out to their own workers
+    if (!_cutl_parallel || _cutl_remote_role != 0) {
+        return;
+    }
+
+    if (env != NULL && *env != '\0') {
+        n = (unsigned int)strtoul(env, NULL, 10);
+    }
+
+    if (n == 0) {
+        long n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n = (n_cpus > 0) ? (unsigned int)n_cpus : 1;
+    }
+
+    if (n < 2) {
+        return;
+    }
+
+    _cutl_pool = mmap(NULL, sizeof(_cutl_pool_t) + n * sizeof(_cutl_result_t),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    _cutl_worker_out  = calloc(n, sizeof(FILE *));
+    _cutl_worker_pids = calloc(n, sizeof(pid_t));
+
+    if (_cutl_pool == MAP_FAILED || _cutl_worker_out == NULL || _cutl_worker_pids == NULL) {
+        _CUTL_REPORT_INFO("Could not set up the worker pool, running sequentially");
+        _cutl_pool = NULL;
+        return;
+    }
+
+    _cutl_pool->next = _cutl_test_index;
+    _cutl_pool->stop = 0;
+    _cutl_pool_size  = n;
+
+    // Buffered output would be written once per process otherwise
+    _CUTL_REPORT_FLUSH();
+    fflush(NULL);
+
+    for (w = 0; w < n; w++) {
+        _cutl_pool->running[w].status = -1;
+        _cutl_worker_out[w]  = tmpfile();
+        _cutl_worker_pids[w] = (_cutl_worker_out[w] != NULL) ? fork() : -1;
+
+        if (_cutl_worker_pids[w] == 0) {
+            _cutl_worker_id = (int)w;
+            return;
+        }
+
+        if (_cutl_worker_pids[w] < 0) {
+            // Nobody will run this slot, the rest of workers are enough
+            _CUTL_REPORT_INFO("Could not start worker %u", w);
+        }
+    }
+}
+
+
+/**
+ * Stores a result in the file of a worker. It is written at once, with no
+ * buffering, so that a crash later on cannot take it away.
+ */
+void _CUTL_POOL_WRITE(FILE *file, const _cutl_result_t *result) {
+    const char *data = (const char *)result;
+    size_t      left = sizeof(*result);
+    int         fd   = fileno(file);
+
+    while (left > 0) {
+        ssize_t n = write(fd, data, left);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return;
+        }
+
+        data += n;
+        left -= (size_t)n;
+    }
+}
+
+
+/**
+ * Waits for every worker and reports their results in program order. The
+ * workers themselves never return from here.
+ */
+void _CUTL_POOL_END(void) {
+    _cutl_result_t *heads;
+    bool           *alive;
+    unsigned int    w;
+
+    if (_cutl_pool == NULL) {
+        return;
+    }
+
+    if (_cutl_worker_id >= 0) {
+        _CUTL_REPORT_FLUSH();
+        fflush(NULL);
+        _exit(EXIT_SUCCESS);
+    }
+
+    heads = malloc(_cutl_pool_size * sizeof(_cutl_result_t));
+    alive = malloc(_cutl_pool_size * sizeof(bool));
+
+    for (w = 0; w < _cutl_pool_size; w++) {
+        int status = 0;
+
+        alive[w] = false;
+
+        if (_cutl_worker_pids[w] <= 0) {
+            continue;
+        }
+
+        waitpid(_cutl_worker_pids[w], &status, 0);
+
+        // A worker that dies takes down the test it was running with it. A
+        // result it was writing then is cut off, and dropped.
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            _cutl_result_t *crash = &_cutl_pool->running[w];
+            int             fd    = fileno(_cutl_worker_out[w]);
+            off_t           end   = lseek(fd, 0, SEEK_END);
+
+            if (end > 0 && end % (off_t)sizeof(*crash) != 0) {
+                end -= end % (off_t)sizeof(*crash);
+
+                if (ftruncate(fd, end) != 0) {
+                    _CUTL_REPORT_ERROR("Could not drop the last result of worker %u", w);
+                }
+            }
+
+            if (crash->status == -1) {
+                _CUTL_REPORT_ERROR("Worker %u died outside of any test", w);
+            }
+            else {
+                _CUTL_CRASH_RESULT(crash, status);
+
+                lseek(fd, end, SEEK_SET);
+                _CUTL_POOL_WRITE(_cutl_worker_out[w], crash);
+            }
+        }
+
+        rewind(_cutl_worker_out[w]);
+        alive[w] = (fread(&heads[w], sizeof(heads[w]), 1, _cutl_worker_out[w]) == 1);
+    }
+
+    // Each file is sorted by index, so merging their heads keeps the order
+    for (;;) {
+        unsigned int first = _cutl_pool_size;
+
+        for (w = 0; w < _cutl_pool_size; w++) {
+            if (alive[w] && (first == _cutl_pool_size || heads[w].index < heads[first].index)) {
+                first = w;
+            }
+        }
+
+        if (first == _cutl_pool_size) {
+            break;
+        }
+
+        _CUTL_REPORT_TEST_RESULT(&heads[first]);
+
+        alive[first] = (fread(&heads[first], sizeof(heads[first]), 1, _cutl_worker_out[first]) == 1);
+    }
+
+    for (w = 0; w < _cutl_pool_size; w++) {
+        if (_cutl_worker_out[w] != NULL) {
+            fclose(_cutl_worker_out[w]);
+        }
+    }
+
+    munmap(_cutl_pool, sizeof(_cutl_pool_t) + _cutl_pool_size * sizeof(_cutl_result_t));
+    free(_cutl_worker_out);
+    free(_cutl_worker_pids);
+    free(heads);
+    free(alive);
+
+    _cutl_pool        = NULL;
+    _cutl_worker_out  = NULL;
+    _cutl_worker_pids = NULL;
+}
+
+#else
+
+void _CUTL_POOL_START(void) {}
+void _CUTL_POOL_END(void) {}
+void _CUTL_POOL_WRITE(FILE *file, const _cutl_result_t *result) { (void)file; (void)result; }
+
+#endif /* _CUTL_POSIX */
+
+
+// ==========================================================================
+// DISTRIBUTED EXECUTION
+// ==========================================================================
+
+
+#if _CUTL_POSIX
+
+#if defined(MSG_NOSIGNAL)
+    #define _CUTL_SEND_FLAGS MSG_NOSIGNAL
+#else
+    #define _CUTL_SEND_FLAGS 0
+#endif
+
+
+/**
+ * Sets up a connection for small messages that wait for an answer, and
+ * to report errors rather than raising SIGPIPE when the peer is gone.
+ */
+static void _cutl_remote_tune(int fd) {
+    int one = 1;
+
+    // Fails on Unix sockets, which have no delay anyway
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+#if defined(SO_NOSIGPIPE)
+    setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+}
+
+
+/**
+ * Opens a socket listening at the address, or connected to it. Returns
+ * -1 if not possible.
+ */
+static int _cutl_remote_socket(const char *address, bool listening) {
+    struct addrinfo  hints, *list, *info;
+    const char      *port = strrchr(address, ':');
+    char             host[256];
+    int              fd   = -1;
+    int              one  = 1;
+
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un un;
+
+        memset(&un, 0, sizeof(un));
+        un.sun_family = AF_UNIX;
+
+        if (strlen(address + 5) >= sizeof(un.sun_path) || (fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+            return -1;
+        }
+
+        strcpy(un.sun_path, address + 5);
+
+        // A coordinator that did not finish leaves it behind
+        if (listening) {
+            unlink(un.sun_path);
+        }
+
+        if (listening ? (bind(fd, (struct sockaddr *)&un, sizeof(un)) != 0 || listen(fd, SOMAXCONN) != 0)
+                      : (connect(fd, (struct sockaddr *)&un, sizeof(un)) != 0)) {
+            close(fd);
+            return -1;
+        }
+
+        return fd;
+    }
+
+    if (port == NULL || (size_t)(port - address) >= sizeof(host)) {
+        return -1;
+    }
+
+    memcpy(host, address, (size_t)(port - address));
+    host[port - address] = '\0';
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags    = listening ? AI_PASSIVE : 0;
+
+    // An empty host listens on every interface
+    if (getaddrinfo((*host != '\0') ? host : NULL, port + 1, &hints, &list) != 0) {
+        return -1;
+    }
+
+    for (info = list; info != NULL; info = info->ai_next) {
+        if ((fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol)) < 0) {
+            continue;
+        }
+
+        if (listening) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        }
+
+        if (listening ? (bind(fd, info->ai_addr, info->ai_addrlen) == 0 && listen(fd, SOMAXCONN) == 0)
+                      : (connect(fd, info->ai_addr, info->ai_addrlen) == 0)) {
+            break;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(list);
+
+    return fd;
+}
+
+
+/**
+ * Sends a message with its payload. Returns false if the peer is gone.
+ */
+static bool _cutl_remote_send(int fd, uint32_t type, const void *payload, size_t length) {
+    char               message[sizeof(_cutl_msg_header_t) + sizeof(_cutl_result_t)];
+    _cutl_msg_header_t header;
+    size_t             size = sizeof(header) + length;
+    size_t             sent = 0;
+
+    header.type   = type;
+    header.length = (uint32_t)length;
+
+    memcpy(message, &header, sizeof(header));
+
+    if (length > 0) {
+        memcpy(message + sizeof(header), payload, length);
+    }
+
+    while (sent < size) {
+        ssize_t n = send(fd, message + sent, size - sent, _CUTL_SEND_FLAGS);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        sent += (size_t)n;
+    }
+
+    return true;
+}
+
+
+/**
+ * Receives exactly size bytes. Returns false if the peer is gone.
+ */
+static bool _cutl_remote_receive(int fd, void *data, size_t size) {
+    size_t received = 0;
+
+    while (received < size) {
+        ssize_t n = recv(fd, (char *)data + received, size - received, 0);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+
+        if (n <= 0) {
+            return false;
+        }
+
+        received += (size_t)n;
+    }
+
+    return true;
+}
+
+
+/**
+ * Leaves a worker that lost its coordinator, whose results have no one to
+ * be reported to
+ */
+static void _cutl_remote_lost(void) {
+    if (_cutl_remote_end == 0 && !_cutl_remote_drained) {
+        _CUTL_REPORT_ERROR("Turned away by the coordinator at %s, which may run another build of the program",
+            _cutl_remote_address);
+    }
+    else {
+        _CUTL_REPORT_ERROR("Lost the coordinator at %s", _cutl_remote_address);
+    }
+
+    _CUTL_REPORT_FLUSH();
+    exit(EXIT_FAILURE);
+}
+
+
+/**
+ * Starts the coordinator listening for workers, or connects the worker to
+ * its coordinator, as configured
+ */
+void _CUTL_REMOTE_START(void) {
+    char     hello[sizeof(uint64_t) + sizeof(uint32_t)];
+    uint64_t hash = _CUTL_PROGRAM_HASH();
+    uint32_t size = sizeof(_cutl_result_t);
+    uint64_t deadline;
+
+    if (getenv("CUTL_COORDINATOR") != NULL) {
+        _cutl_remote_role    = CUTL_REMOTE_COORDINATOR;
+        _cutl_remote_address = getenv("CUTL_COORDINATOR");
+    }
+    else if (getenv("CUTL_WORKER") != NULL && *getenv("CUTL_WORKER") != '\0') {
+        _cutl_remote_role    = CUTL_REMOTE_WORKER;
+        _cutl_remote_address = getenv("CUTL_WORKER");
+    }
+
+    if (_cutl_remote_role == 0) {
+        return;
+    }
+
+    if (_cutl_remote_address == NULL || *_cutl_remote_address == '\0') {
+        if (_cutl_remote_role == CUTL_REMOTE_WORKER) {
+            _CUTL_REPORT_ERROR("Workers need the address of the coordinator");
+            _CUTL_REPORT_FLUSH();
+            exit(EXIT_FAILURE);
+        }
+
+        _cutl_remote_address = _CUTL_REMOTE_ADDRESS;
+    }
+
+    if (_cutl_remote_role == CUTL_REMOTE_COORDINATOR) {
+        if ((_cutl_remote_fd = _cutl_remote_socket(_cutl_remote_address, true)) < 0) {
+            _CUTL_REPORT_ERROR("Could not listen for workers at %s", _cutl_remote_address);
+            _CUTL_REPORT_FLUSH();
+            exit(EXIT_FAILURE);
+        }
+
+        _cutl_remote_n_workers = 0;
+
+        _CUTL_REPORT_INFO("Waiting for workers at %s", _cutl_remote_address);
+        return;
+    }
+
+    // The coordinator may not be up yet
+    deadline = _CUTL_NOW_NS() + (uint64_t)_CUTL_REMOTE_CONNECT_MS * 1000000u;
+
+    while ((_cutl_remote_fd = _cutl_remote_socket(_cutl_remote_address, false)) < 0) {
+        if (_CUTL_NOW_NS() >= deadline) {
+            _CUTL_REPORT_ERROR("Could not connect to the coordinator at %s", _cutl_remote_address);
+            _CUTL_REPORT_FLUSH();
+            exit(EXIT_FAILURE);
+        }
+
+        poll(NULL, 0, 100);
+    }
+
+    _cutl_remote_tune(_cutl_remote_fd);
+
+    memcpy(hello, &hash, sizeof(hash));
+    memcpy(hello + sizeof(hash), &size, sizeof(size));
+
+    if (!_cutl_remote_send(_cutl_remote_fd, _CUTL_MSG_HELLO, hello, sizeof(hello))) {
+        _cutl_remote_lost();
+    }
+
+    _cutl_remote_first   = 0;
+    _cutl_remote_end     = 0;
+    _cutl_remote_drained = false;
+    _cutl_remote_n_run   = 0;
+}
+
+
+/**
+ * Takes note of a test in the coordinator, to be handed out later
+ */
+void _CUTL_REMOTE_ADD(const char *file, const char *func, const char *args, int line, unsigned int call) {
+    unsigned long        index = _cutl_test_index - 1;
+    _cutl_remote_test_t *test;
+
+    if (index >= _cutl_remote_capacity) {
+        size_t               capacity = (_cutl_remote_capacity > 0) ? 2 * _cutl_remote_capacity : 256;
+        _cutl_remote_test_t *tests;
+
+        _cutl_alloc_paused++;
+        tests = realloc(_cutl_remote_tests, capacity * sizeof(*tests));
+        _cutl_alloc_paused--;
+
+        if (tests == NULL) {
+            _CUTL_REPORT_ERROR("Could not keep the tests to hand out");
+            _CUTL_REPORT_FLUSH();
+            exit(EXIT_FAILURE);
+        }
+
+        _cutl_remote_tests    = tests;
+        _cutl_remote_capacity = capacity;
+    }
+
+    test = &_cutl_remote_tests[index];
+    test->file   = file;
+    test->func   = func;
+    test->args   = args;
+    test->line   = line;
+    test->call   = call;
+    test->state  = _CUTL_REMOTE_QUEUED;
+    test->result = NULL;
+}
+
+
+/**
+ * Decides whether the worker has to run the test, asking the coordinator
+ * for another batch once past the end of the last one
+ */
+bool _CUTL_REMOTE_CLAIM(unsigned long index) {
+    _cutl_msg_header_t header;
+    uint64_t           reached = index;
+    uint64_t           batch[2];
+
+    if (!_cutl_remote_drained && index >= _cutl_remote_end) {
+        if (!_cutl_remote_send(_cutl_remote_fd, _CUTL_MSG_CLAIM, &reached, sizeof(reached))
+                || !_cutl_remote_receive(_cutl_remote_fd, &header, sizeof(header))
+                || header.type != _CUTL_MSG_BATCH || header.length != sizeof(batch)
+                || !_cutl_remote_receive(_cutl_remote_fd, batch, sizeof(batch))) {
+            _cutl_remote_lost();
+        }
+
+        _cutl_remote_first   = (unsigned long)batch[0];
+        _cutl_remote_end     = (unsigned long)(batch[0] + batch[1]);
+        _cutl_remote_drained = (batch[1] == 0);
+    }
+
+    if (index < _cutl_remote_first || index >= _cutl_remote_end) {
+        return false;
+    }
+
+    _cutl_remote_n_run++;
+
+    return true;
+}
+
+
+/**
+ * Sends the result of a test to the coordinator
+ */
+void _CUTL_REMOTE_SEND_RESULT(const _cutl_result_t *result) {
+    char   payload[sizeof(_cutl_result_t)];
+    size_t head = offsetof(_cutl_result_t, failure_msg);
+    size_t tail = sizeof(*result) - head - _CUTL_MAX_LEN_MSG;
+    size_t msg  = strnlen(result->failure_msg, _CUTL_MAX_LEN_MSG - 1);
+
+    memcpy(payload, result, head);
+    memcpy(payload + head, (const char *)result + head + _CUTL_MAX_LEN_MSG, tail);
+    memcpy(payload + head + tail, result->failure_msg, msg);
+
+    if (!_cutl_remote_send(_cutl_remote_fd, _CUTL_MSG_RESULT, payload, head + tail + msg)) {
+        _cutl_remote_lost();
+    }
+}
+
+
+/**
+ * Marks the tests of the batch of a worker before the given index as
+ * done, those without a result having been skipped by it
+ */
+static void _cutl_remote_settle(_cutl_remote_client_t *client, unsigned long until) {
+    for (; client->next < client->end && client->next < until; client->next++) {
+        if (_cutl_remote_tests[client->next].state == _CUTL_REMOTE_SENT) {
+            _cutl_remote_tests[client->next].state = _CUTL_REMOTE_DONE;
+        }
+    }
+}
+
+
+/**
+ * Hands the next batch of queued tests from the given index on to a
+ * worker. Batches get smaller as fewer tests are left, so that all the
+ * workers finish at about the same time.
+ */
+static bool _cutl_remote_hand_out(_cutl_remote_client_t *client, int fd, unsigned long reached) {
+    unsigned long n_tests = _cutl_test_index;
+    unsigned long first   = (reached > _cutl_remote_cursor) ? reached : _cutl_remote_cursor;
+    unsigned long count   = _cutl_remote_n_queued / (4 * (size_t)_cutl_remote_n_clients);
+    uint64_t      batch[2];
+
+    count = (count < 1) ? 1 : (count > _CUTL_REMOTE_MAX_BATCH) ? _CUTL_REMOTE_MAX_BATCH : count;
+
+    while (first < n_tests && _cutl_remote_tests[first].state != _CUTL_REMOTE_QUEUED) {
+        first++;
+    }
+
+    // The cursor can only move past what nobody is behind of
+    if (reached <= _cutl_remote_cursor) {
+        _cutl_remote_cursor = first;
+    }
+
+    client->first = first;
+    client->next  = first;
+    client->end   = first;
+
+    while (client->end < n_tests && client->end - first < count
+            && _cutl_remote_tests[client->end].state == _CUTL_REMOTE_QUEUED) {
+        _cutl_remote_tests[client->end].state = _CUTL_REMOTE_SENT;
+        _cutl_remote_n_queued--;
+        client->end++;
+    }
+
+    batch[0] = first;
+    batch[1] = client->end - first;
+
+    return _cutl_remote_send(fd, _CUTL_MSG_BATCH, batch, sizeof(batch));
+}
+
+
+/**
+ * Handles a message from a worker. Returns false if the worker has to be
+ * dropped.
+ */
+static bool _cutl_remote_handle(_cutl_remote_client_t *client, int fd,
+                                const _cutl_msg_header_t *header, const char *payload) {
+    size_t         head = offsetof(_cutl_result_t, failure_msg);
+    size_t         tail = sizeof(_cutl_result_t) - head - _CUTL_MAX_LEN_MSG;
+    _cutl_result_t *result;
+    uint64_t       value;
+    uint32_t       size;
+
+    if (header->type == _CUTL_MSG_HELLO && !client->hello && header->length == sizeof(value) + sizeof(size)) {
+        memcpy(&value, payload, sizeof(value));
+        memcpy(&size, payload + sizeof(value), sizeof(size));
+
+        if (value != _CUTL_PROGRAM_HASH() || size != sizeof(_cutl_result_t)) {
+            _CUTL_REPORT_INFO("Turned away a worker running another build of the program");
+            return false;
+        }
+
+        client->hello = true;
+        _cutl_remote_n_clients++;
+        _cutl_remote_n_workers++;
+        return true;
+    }
+
+    if (!client->hello) {
+        return false;
+    }
+
+    switch (header->type) {
+        case _CUTL_MSG_CLAIM:
+            if (header->length != sizeof(value)) {
+                return false;
+            }
+
+            memcpy(&value, payload, sizeof(value));
+            _cutl_remote_settle(client, (unsigned long)value);
+
+            return _cutl_remote_hand_out(client, fd, (unsigned long)value);
+
+        case _CUTL_MSG_RESULT:
+            if (header->length < head + tail || header->length > head + tail + _CUTL_MAX_LEN_MSG - 1) {
+                return false;
+            }
+
+            _cutl_alloc_paused++;
+            result = calloc(1, sizeof(*result));
+            _cutl_alloc_paused--;
+
+            if (result == NULL) {
+                return false;
+            }
+
+            memcpy(result, payload, head);
+            memcpy((char *)result + head + _CUTL_MAX_LEN_MSG, payload + head, tail);
+            memcpy(result->failure_msg, payload + head + tail, header->length - head - tail);
+
+            if (result->index < client->next || result->index >= client->end
+                    || _cutl_remote_tests[result->index].state != _CUTL_REMOTE_SENT) {
+                free(result);
+                return false;
+            }
+
+            _cutl_remote_settle(client, result->index);
+
+            // Pointers only make sense in this process
+            result->file = _cutl_remote_tests[result->index].file;
+            result->func = _cutl_remote_tests[result->index].func;
+            result->args = _cutl_remote_tests[result->index].args;
+            result->line = _cutl_remote_tests[result->index].line;
+            result->call = _cutl_remote_tests[result->index].call;
+
+            _cutl_remote_tests[result->index].result = result;
+            _cutl_remote_tests[result->index].state  = _CUTL_REMOTE_DONE;
+            client->next = result->index + 1;
+            return true;
+
+        case _CUTL_MSG_BYE:
+            _cutl_remote_settle(client, client->end);
+            client->bye = true;
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+
+/**
+ * Reads what a worker sent and handles every complete message. Returns
+ * false if the worker has to be dropped.
+ */
+static bool _cutl_remote_serve(_cutl_remote_client_t *client, int fd) {
+    _cutl_msg_header_t header;
+    ssize_t            n = recv(fd, client->buffer + client->received, sizeof(client->buffer) - client->received, 0);
+
+    if (n < 0 && errno == EINTR) {
+        return true;
+    }
+
+    if (n <= 0) {
+        return false;
+    }
+
+    client->received += (size_t)n;
+
+    while (client->received >= sizeof(header)) {
+        size_t size;
+
+        memcpy(&header, client->buffer, sizeof(header));
+        size = sizeof(header) + header.length;
+
+        if (size > sizeof(client->buffer)) {
+            return false;
+        }
+
+        if (client->received < size) {
+            break;
+        }
+
+        if (!_cutl_remote_handle(client, fd, &header, client->buffer + sizeof(header))) {
+            return false;
+        }
+
+        client->received -= size;
+        memmove(client->buffer, client->buffer + size, client->received);
+    }
+
+    return true;
+}
+
+
+/**
+ * Drops a worker. If it did not say goodbye, the test it was running is
+ * an error and the rest of its batch goes back to the queue.
+ */
+static void _cutl_remote_drop(_cutl_remote_client_t *client, int fd) {
+    unsigned long index;
+    unsigned long n_queued = 0;
+    bool          running  = true;
+
+    close(fd);
+
+    if (client->hello) {
+        _cutl_remote_n_clients--;
+    }
+
+    if (client->bye) {
+        return;
+    }
+
+    for (index = client->next; index < client->end; index++) {
+        _cutl_remote_test_t *test = &_cutl_remote_tests[index];
+
+        if (test->state != _CUTL_REMOTE_SENT) {
+            continue;
+        }
+
+        if (running) {
+            _cutl_alloc_paused++;
+            test->result = calloc(1, sizeof(_cutl_result_t));
+            _cutl_alloc_paused--;
+
+            if (test->result != NULL) {
+                test->result->index        = index;
+                test->result->file         = test->file;
+                test->result->func         = test->func;
+                test->result->args         = test->args;
+                test->result->line         = test->line;
+                test->result->call         = test->call;
+                test->result->status       = _CUTL_ERROR;
+                test->result->failure_line = test->line;
+
+                snprintf(test->result->failure_msg, _CUTL_MAX_LEN_MSG, "Worker lost while running the test");
+            }
+
+            test->state = _CUTL_REMOTE_DONE;
+            running     = false;
+            continue;
+        }
+
+        test->state = _CUTL_REMOTE_QUEUED;
+        n_queued++;
+    }
+
+    if (n_queued > 0) {
+        _cutl_remote_n_queued += n_queued;
+
+        if (client->next < _cutl_remote_cursor) {
+            _cutl_remote_cursor = client->next;
+        }
+
+        _CUTL_REPORT_INFO("Lost a worker, %lu of its tests are queued again", n_queued);
+    }
+    else if (!running) {
+        _CUTL_REPORT_INFO("Lost a worker");
+    }
+}
+
+
+/**
+ * Hands the tests out to the workers that connect to the coordinator, and
+ * reports their results in program order. Workers only say goodbye.
+ */
+void _CUTL_REMOTE_END(void) {
+    _cutl_remote_client_t *clients   = NULL;
+    struct pollfd         *fds       = NULL;
+    size_t                 n_fds     = 1;
+    unsigned long          n_tests   = _cutl_test_index;
+    unsigned long          reported  = 0;
+    bool                   waiting   = false;
+    size_t                 i;
+
+    if (_cutl_remote_role == CUTL_REMOTE_WORKER) {
+        _cutl_remote_send(_cutl_remote_fd, _CUTL_MSG_BYE, NULL, 0);
+        close(_cutl_remote_fd);
+        _cutl_remote_fd = -1;
+        return;
+    }
+
+    if (_cutl_remote_role != CUTL_REMOTE_COORDINATOR) {
+        return;
+    }
+
+    _cutl_remote_n_queued  = n_tests;
+    _cutl_remote_cursor    = 0;
+    _cutl_remote_n_clients = 0;
+
+    _cutl_alloc_paused++;
+    fds = malloc(sizeof(*fds));
+    _cutl_alloc_paused--;
+
+    if (fds == NULL) {
+        _CUTL_REPORT_ERROR("Could not wait for workers");
+        _CUTL_REPORT_FLUSH();
+        exit(EXIT_FAILURE);
+    }
+
+    fds[0].fd     = _cutl_remote_fd;
+    fds[0].events = POLLIN;
+
+    // Workers that are still connected get told there is nothing left
+    while (reported < n_tests || n_fds > 1) {
+        if (reported == n_tests) {
+            fds[0].fd = -1;
+        }
+
+        if (poll(fds, (nfds_t)n_fds, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            _CUTL_REPORT_ERROR("Could not wait for workers (%s)", strerror(errno));
+            _CUTL_REPORT_FLUSH();
+            exit(EXIT_FAILURE);
+        }
+
+        for (i = n_fds - 1; i > 0; i--) {
+            if (fds[i].revents == 0 || _cutl_remote_serve(&clients[i - 1], fds[i].fd)) {
+                continue;
+            }
+
+            _cutl_remote_drop(&clients[i - 1], fds[i].fd);
+
+            n_fds--;
+            fds[i]         = fds[n_fds];
+            clients[i - 1] = clients[n_fds - 1];
+        }
+
+        if (fds[0].fd >= 0 && (fds[0].revents & POLLIN) != 0) {
+            int fd = accept(_cutl_remote_fd, NULL, NULL);
+
+            if (fd >= 0) {
+                struct pollfd         *more_fds;
+                _cutl_remote_client_t *more_clients;
+
+                _cutl_alloc_paused++;
+                more_fds     = realloc(fds, (n_fds + 1) * sizeof(*fds));
+                more_clients = (more_fds != NULL) ? realloc(clients, n_fds * sizeof(*clients)) : NULL;
+                _cutl_alloc_paused--;
+
+                if (more_fds != NULL) {
+                    fds = more_fds;
+                }
+
+                if (more_clients == NULL) {
+                    close(fd);
+                }
+                else {
+                    clients = more_clients;
+
+                    _cutl_remote_tune(fd);
+                    memset(&clients[n_fds - 1], 0, sizeof(*clients));
+
+                    fds[n_fds].fd     = fd;
+                    fds[n_fds].events = POLLIN;
+                    n_fds++;
+                }
+            }
+        }
+
+        while (reported < n_tests && _cutl_remote_tests[reported].state == _CUTL_REMOTE_DONE) {
+            _cutl_result_t *result = _cutl_remote_tests[reported].result;
+
+            if (result != NULL) {
+                _CUTL_REPORT_TEST_RESULT(result);
+                free(result);
+            }
+
+            reported++;
+        }
+
+        // Tests behind every worker wait for another one
+        if (_cutl_remote_n_clients == 0 && _cutl_remote_n_queued > 0 && _cutl_remote_n_workers > 0 && !waiting) {
+            _CUTL_REPORT_INFO("%zu tests are waiting for another worker at %s",
+                _cutl_remote_n_queued, _cutl_remote_address);
+            _CUTL_REPORT_FLUSH();
+        }
+
+        waiting = (_cutl_remote_n_clients == 0);
+    }
+
+    close(_cutl_remote_fd);
+
+    if (strncmp(_cutl_remote_address, "unix:", 5) == 0) {
+        unlink(_cutl_remote_address + 5);
+    }
+
+    _CUTL_REPORT_INFO("Workers that ran the tests: %u", _cutl_remote_n_workers);
+
+    free(fds);
+    free(clients);
+    free(_cutl_remote_tests);
+
+    _cutl_remote_fd       = -1;
+    _cutl_remote_tests    = NULL;
+    _cutl_remote_capacity = 0;
+}
+
+
+/**
+ * Leaves a worker once it is done, as the coordinator reports the run
+ */
+void _CUTL_REMOTE_EXIT(void) {
+    if (_cutl_remote_role != CUTL_REMOTE_WORKER) {
+        return;
+    }
+
+    _CUTL_REPORT_INFO("Ran %u tests for the coordinator at %s", _cutl_remote_n_run, _cutl_remote_address);
+    _CUTL_REPORT_FLUSH();
+    fflush(NULL);
+    exit(EXIT_SUCCESS);
+}
+
+#else
+
+void _CUTL_REMOTE_START(void) {
+    if (_cutl_remote_role != 0 || getenv("CUTL_COORDINATOR") != NULL || getenv("CUTL_WORKER") != NULL) {
+        _CUTL_REPORT_INFO("Distributed execution is not supported on this platform, running the tests here");
+        _cutl_remote_role = 0;
+    }
+}
+
+void _CUTL_REMOTE_ADD(const char *file, const char *func, const char *args, int line, unsigned int call) {
+    (void)file; (void)func; (void)args; (void)line; (void)call;
+}
+
+bool _CUTL_REMOTE_CLAIM(unsigned long index) { (void)index; return true; }
+void _CUTL_REMOTE_SEND_RESULT(const _cutl_result_t *result) { (void)result; }
+void _CUTL_REMOTE_END(void) {}
+void _CUTL_REMOTE_EXIT(void) {}
+
+#endif /* _CUTL_POSIX */
+
+
+
+// ==========================================================================
+// TIMEOUTS
+// ==========================================================================
+
+
+#if _CUTL_POSIX
+
+/**
+ * Reads the timeouts from the environment
+ */
+void _CUTL_TIMEOUT_SETUP(void) {
+    const char *test  = getenv("CUTL_TIMEOUT");
+    const char *total = getenv("CUTL_TOTAL_TIMEOUT");
+
+    if (test != NULL && *test != '\0') {
+        _cutl_timeout_ms = (unsigned int)strtoul(test, NULL, 10);
+    }
+
+    if (total != NULL && *total != '\0') {
+        _cutl_timeout_total_ms = (unsigned int)strtoul(total, NULL, 10);
+    }
+
+    _cutl_test_thread = pthread_self();
+}
+
+
+/**
+ * Starts the timer of the test about to run, or stops it with 0. The
+ * signal handler is only installed once a timer is needed.
+ */
+void _CUTL_TIMEOUT_ARM(unsigned int ms) {
+    static bool      installed = false;
+    static bool      armed     = false;
+    struct itimerval timer;
+
+    if (ms == 0 && !armed) {
+        return;
+    }
+
+    if (!installed) {
+        struct sigaction action;
+
+        // The handler may not return, so the signal is not blocked in it
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = _CUTL_TIMEOUT_HANDLER;
+        action.sa_flags   = SA_NODEFER;
+        sigemptyset(&action.sa_mask);
+
+        sigaction(SIGALRM, &action, NULL);
+        installed = true;
+    }
+
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_sec  = ms / 1000;
+    timer.it_value.tv_usec = (ms % 1000) * 1000;
+
+    setitimer(ITIMER_REAL, &timer, NULL);
+
+    armed = (ms > 0);
+}
+
+
+/**
+ * Gets ready for the timer of the test about to run. What the handler
+ * reports if the test is out of its function when the time is up is
+ * written now, and the reports so far are flushed, as the handler may
+ * only call async-signal-safe functions.
+ */
+void _CUTL_TIMEOUT_PREPARE(void) {
+    int len;
+
+    _CUTL_REPORT_FLUSH();
+
+    len = snprintf(_cutl_timeout_report, sizeof(_cutl_timeout_report),
+        "====[ERROR]====  %s l:%d (%s)\n\tError in line %d: %s, in CUTL_BEFORE_EACH or CUTL_AFTER_EACH\n"
+        "=====[INFO]===== Ending execution...\n",
+        _cutl_current_file, _cutl_current_line, _cutl_current_func, _cutl_current_line, _cutl_timeout_msg);
+
+    _cutl_timeout_len = (len < 0) ? 0 : ((size_t)len < sizeof(_cutl_timeout_report)) ? (size_t)len
+                                                                                      : sizeof(_cutl_timeout_report) - 1;
+    _cutl_timeout_fd  = (_cutl_report_file != NULL) ? fileno(_cutl_report_file) : STDOUT_FILENO;
+    _cutl_timeout_expired = 0;
+}
+
+
+/**
+ * Called when the time of a test that runs in process is up. It leaves
+ * the test function, and _CUTL_TIMEOUT_REGISTER registers the error after
+ * the jump. Out of it, in CUTL_BEFORE_EACH or CUTL_AFTER_EACH, there is
+ * nowhere to go back to and the run ends.
+ */
+void _CUTL_TIMEOUT_HANDLER(int signal) {
+    size_t written = 0;
+
+    // Any thread may get the signal, but only that of the test can leave it
+    if (_cutl_thread_context == NULL) {
+        pthread_kill(_cutl_test_thread, signal);
+        return;
+    }
+
+    _cutl_timeout_expired = 1;
+
+    if (_cutl_context.in_body) {
+        _CUTL_LONGJMP(_cutl_context.exit);
+    }
+
+    while (written < _cutl_timeout_len) {
+        ssize_t n = write(_cutl_timeout_fd, _cutl_timeout_report + written, _cutl_timeout_len - written);
+
+        if (n <= 0) {
+            break;
+        }
+
+        written += (size_t)n;
+    }
+
+    _exit(EXIT_FAILURE);
+}
+
+
+/**
+ * Registers the error of a test whose time ran out, once the handler has
+ * left its function
+ */
+void _CUTL_TIMEOUT_REGISTER(void) {
+    if (_cutl_timeout_expired) {
+        _cutl_timeout_expired = 0;
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, _cutl_timeout_msg);
+    }
+}
+
+#else
+
+void _CUTL_TIMEOUT_SETUP(void) {}
+void _CUTL_TIMEOUT_PREPARE(void) {}
+void _CUTL_TIMEOUT_ARM(unsigned int ms) { (void)ms; }
+void _CUTL_TIMEOUT_HANDLER(int signal) { (void)signal; }
+void _CUTL_TIMEOUT_REGISTER(void) {}
+
+#endif /* _CUTL_POSIX */
+
+
+/**
+ * Reports whether the run went over its total time, which left some tests
+ * without running
+ */
+void _CUTL_REPORT_TIMEOUT_SUMMARY(void) {
+    if (_cutl_n_tests_skipped > 0) {
+        _CUTL_REPORT_INFO("The run went over its total timeout of %u ms, the tests left were not run",
+            _cutl_timeout_total_ms);
+    }
+}
+
+
+/**
+ * Returns what the summary line adds about the tests left out by the
+ * total timeout, if any
+ */
+const char *_CUTL_FORMAT_SKIPPED(char *buffer, size_t size) {
+    if (_cutl_n_tests_skipped == 0) {
+        return "";
+    }
+
+    snprintf(buffer, size, ", %u not run", _cutl_n_tests_skipped);
+
+    return buffer;
+}
+
+
+
+// ==========================================================================
+// ALLOCATION TRACKING
+// ==========================================================================
+
+
+/**
+ * Starts counting the allocations of a new test
+ */
+void _CUTL_ALLOC_RESET(void) {
+    _cutl_alloc_paused = 0;
+
+#if _CUTL_TRACK_ALLOC
+    __atomic_add_fetch(&_cutl_alloc_test, 1, __ATOMIC_RELAXED);
+#endif
+
+    __atomic_store_n(&_cutl_alloc.count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_cutl_alloc.bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_cutl_alloc.in_use, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_cutl_alloc.in_use_bytes, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&_cutl_alloc.peak_bytes, 0, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * Takes the counters at the start of a block checked by ASSERT_NO_ALLOC or
+ * ASSERT_ALLOC_BYTES_LE
+ */
+_cutl_alloc_scope_t _CUTL_ALLOC_SCOPE_START(void) {
+    _cutl_alloc_scope_t scope;
+
+    scope.done  = false;
+    scope.count = __atomic_load_n(&_cutl_alloc.count, __ATOMIC_RELAXED);
+    scope.bytes = __atomic_load_n(&_cutl_alloc.bytes, __ATOMIC_RELAXED);
+
+    return scope;
+}
+
+
+/**
+ * Checks what a block allocated against its budget, registering a failure
+ * if it went over. Returns whether it did not.
+ */
+bool _CUTL_ALLOC_SCOPE_CHECK(const _cutl_alloc_scope_t *scope, uint64_t max_count, uint64_t max_bytes,
+                             int line, const char *assertion) {
+    uint64_t count = __atomic_load_n(&_cutl_alloc.count, __ATOMIC_RELAXED) - scope->count;
+    uint64_t bytes = __atomic_load_n(&_cutl_alloc.bytes, __ATOMIC_RELAXED) - scope->bytes;
+    char     msg[_CUTL_MAX_LEN_MSG];
+
+    if (!_CUTL_TRACK_ALLOC) {
+        snprintf(msg, sizeof(msg), "%s needs CUTL_TRACK_ALLOC to be defined", assertion);
+        _CUTL_REGISTER_TEST_ERROR(line, msg);
+        return false;
+    }
+
+    if (count <= max_count && bytes <= max_bytes) {
+        return true;
+    }
+
+    snprintf(msg, sizeof(msg), "%s: %llu allocations of %llu bytes",
+        assertion, (unsigned long long)count, (unsigned long long)bytes);
+    _CUTL_REGISTER_TEST_FAILURE(line, msg);
+
+    return false;
+}
+
+
+/**
+ * Formats a number of bytes with a binary unit
+ */
+const char *_CUTL_FORMAT_BYTES(double bytes, char *buffer, size_t size) {
+    if (bytes < 1024) {
+        snprintf(buffer, size, "%.0f B", bytes);
+    }
+    else if (bytes < 1024 * 1024) {
+        snprintf(buffer, size, "%.1f KiB", bytes / 1024);
+    }
+    else if (bytes < 1024 * 1024 * 1024) {
+        snprintf(buffer, size, "%.1f MiB", bytes / (1024 * 1024));
+    }
+    else {
+        snprintf(buffer, size, "%.1f GiB", bytes / (1024 * 1024 * 1024));
+    }
+
+    return buffer;
+}
+
+
+#if _CUTL_TRACK_ALLOC
+
+// The real allocator, and the names the tracking functions take
+#if defined(CUTL_ALLOC_WRAP)
+    void *__real_malloc(size_t size);
+    void *__real_calloc(size_t n, size_t size);
+    void *__real_realloc(void *ptr, size_t size);
+    void  __real_free(void *ptr);
+
+    #define _CUTL_REAL(name)    __real_##name
+    #define _CUTL_TRACKED(name) __wrap_##name
+#else
+    void *__libc_malloc(size_t size);
+    void *__libc_calloc(size_t n, size_t size);
+    void *__libc_realloc(void *ptr, size_t size);
+    void  __libc_free(void *ptr);
+    void *__libc_memalign(size_t alignment, size_t size);
+
+    #define _CUTL_REAL(name)    __libc_##name
+    #define _CUTL_TRACKED(name) name
+#endif
+
+
+/**
+ * Finds the slot of a block in the set, or where to add it. The lock must
+ * be held.
+ */
+static _cutl_alloc_block_t *_cutl_alloc_slot(_cutl_alloc_block_t *blocks, size_t capacity, uintptr_t ptr) {
+    _cutl_alloc_block_t *removed = NULL;
+    size_t               i       = (size_t)(((uint64_t)ptr >> 4) * 0x9E3779B97F4A7C15ull) & (capacity - 1);
+
+    while (blocks[i].ptr != _CUTL_ALLOC_EMPTY) {
+        if (blocks[i].ptr == ptr) {
+            return &blocks[i];
+        }
+
+        if (blocks[i].ptr == _CUTL_ALLOC_REMOVED && removed == NULL) {
+            removed = &blocks[i];
+        }
+
+        i = (i + 1) & (capacity - 1);
+    }
+
+    return (removed != NULL) ? removed : &blocks[i];
+}
+
+
+/**
+ * Makes room in the set for one more block, growing it when it is mostly
+ * live blocks, or only dropping its removed slots otherwise. The lock
+ * must be held. Returns false if there is no memory for it.
+ */
+static bool _cutl_alloc_reserve(void) {
+    _cutl_alloc_block_t *blocks;
+    size_t               capacity = (_cutl_alloc_capacity > 0) ? _cutl_alloc_capacity : 1024;
+    size_t               i;
+
+    if ((_cutl_alloc_n_used + 1) * 4 <= _cutl_alloc_capacity * 3) {
+        return true;
+    }
+
+    if ((_cutl_alloc_n_live + 1) * 2 > _cutl_alloc_capacity) {
+        capacity *= (_cutl_alloc_capacity > 0) ? 2 : 1;
+    }
+
+    if ((blocks = _CUTL_REAL(calloc)(capacity, sizeof(_cutl_alloc_block_t))) == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < _cutl_alloc_capacity; i++) {
+        if (_cutl_alloc_blocks[i].ptr > _CUTL_ALLOC_REMOVED) {
+            *_cutl_alloc_slot(blocks, capacity, _cutl_alloc_blocks[i].ptr) = _cutl_alloc_blocks[i];
+        }
+    }
+
+    _CUTL_REAL(free)(_cutl_alloc_blocks);
+
+    _cutl_alloc_blocks   = blocks;
+    _cutl_alloc_capacity = capacity;
+    _cutl_alloc_n_used   = _cutl_alloc_n_live;
+
+    return true;
+}
+
+
+/**
+ * Counts an allocation, unless CutL is allocating for itself, and keeps
+ * the block in the set
+ */
+void _CUTL_ALLOC_RECORD(void *ptr, size_t size) {
+    _cutl_alloc_block_t *block;
+    int64_t              now, peak;
+
+    if (_cutl_alloc_paused) {
+        return;
+    }
+
+    while (__atomic_test_and_set(&_cutl_alloc_lock, __ATOMIC_ACQUIRE)) {
+    }
+
+    if (!_cutl_alloc_reserve()) {
+        __atomic_clear(&_cutl_alloc_lock, __ATOMIC_RELEASE);
+        return;
+    }
+
+    block = _cutl_alloc_slot(_cutl_alloc_blocks, _cutl_alloc_capacity, (uintptr_t)ptr);
+
+    _cutl_alloc_n_used += (block->ptr == _CUTL_ALLOC_EMPTY) ? 1 : 0;
+    _cutl_alloc_n_live++;
+
+    block->ptr  = (uintptr_t)ptr;
+    block->size = size;
+    block->test = __atomic_load_n(&_cutl_alloc_test, __ATOMIC_RELAXED);
+
+    __atomic_clear(&_cutl_alloc_lock, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&_cutl_alloc.count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&_cutl_alloc.bytes, size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&_cutl_alloc.in_use, 1, __ATOMIC_RELAXED);
+
+    now  = __atomic_add_fetch(&_cutl_alloc.in_use_bytes, (int64_t)size, __ATOMIC_RELAXED);
+    peak = __atomic_load_n(&_cutl_alloc.peak_bytes, __ATOMIC_RELAXED);
+
+    while (now > peak && !__atomic_compare_exchange_n(&_cutl_alloc.peak_bytes, &peak, now,
+                                                      true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+
+/**
+ * Counts a block given back, if the running test allocated it. Blocks
+ * of earlier tests leave the set uncounted, and those that are not in it
+ * (allocated by CutL, or not through the tracked functions) are ignored.
+ */
+void _CUTL_FREE_RECORD(void *ptr) {
+    _cutl_alloc_block_t *block;
+    size_t               size;
+    bool                 current;
+
+    if (_cutl_alloc_paused || _cutl_alloc_capacity == 0) {
+        return;
+    }
+
+    while (__atomic_test_and_set(&_cutl_alloc_lock, __ATOMIC_ACQUIRE)) {
+    }
+
+    block = _cutl_alloc_slot(_cutl_alloc_blocks, _cutl_alloc_capacity, (uintptr_t)ptr);
+
+    if (block->ptr != (uintptr_t)ptr) {
+        __atomic_clear(&_cutl_alloc_lock, __ATOMIC_RELEASE);
+        return;
+    }
+
+    size    = block->size;
+    current = (block->test == __atomic_load_n(&_cutl_alloc_test, __ATOMIC_RELAXED));
+
+    block->ptr = _CUTL_ALLOC_REMOVED;
+    _cutl_alloc_n_live--;
+
+    __atomic_clear(&_cutl_alloc_lock, __ATOMIC_RELEASE);
+
+    if (current) {
+        __atomic_fetch_sub(&_cutl_alloc.in_use, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&_cutl_alloc.in_use_bytes, (int64_t)size, __ATOMIC_RELAXED);
+    }
+}
+
+
+void *_CUTL_TRACKED(malloc)(size_t size) {
+    void *ptr = _CUTL_REAL(malloc)(size);
+
+    if (ptr != NULL) {
+        _CUTL_ALLOC_RECORD(ptr, size);
+    }
+
+    return ptr;
+}
+
+
+void *_CUTL_TRACKED(calloc)(size_t n, size_t size) {
+    void *ptr = _CUTL_REAL(calloc)(n, size);
+
+    if (ptr != NULL) {
+        _CUTL_ALLOC_RECORD(ptr, n * size);
+    }
+
+    return ptr;
+}
+
+
+void *_CUTL_TRACKED(realloc)(void *old, size_t size) {
+    void *ptr = _CUTL_REAL(realloc)(old, size);
+
+    // On failure, the old block is left as it was
+    if (ptr == NULL && size > 0) {
+        return NULL;
+    }
+
+    if (old != NULL) {
+        _CUTL_FREE_RECORD(old);
+    }
+
+    if (ptr != NULL) {
+        _CUTL_ALLOC_RECORD(ptr, size);
+    }
+
+    return ptr;
+}
+
+
+void _CUTL_TRACKED(free)(void *ptr) {
+    if (ptr != NULL) {
+        _CUTL_FREE_RECORD(ptr);
+    }
+
+    _CUTL_REAL(free)(ptr);
+}
+
+
+// The aligned allocators give blocks that are freed with free(), so they
+// are tracked too. Only glibc has a real one to forward them to.
+#if !defined(CUTL_ALLOC_WRAP)
+
+void *memalign(size_t alignment, size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+
+    if (ptr != NULL) {
+        _CUTL_ALLOC_RECORD(ptr, size);
+    }
+
+    return ptr;
+}
+
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+
+int posix_memalign(void **result, size_t alignment, size_t size) {
+    void *ptr;
+
+    if (alignment == 0 || alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+
+    if ((ptr = memalign(alignment, size)) == NULL) {
+        return ENOMEM;
+    }
+
+    *result = ptr;
+
+    return 0;
+}
+
+#endif
+
+#endif /* _CUTL_TRACK_ALLOC */
+
+
+
+// ==========================================================================
+// TEST ARENA
+// ==========================================================================
+
+
+/**
+ * Allocates memory that lasts until the end of the test, when all of it is
+ * freed at once right after CUTL_AFTER_EACH. Nothing has to be freed, so a
+ * failed assertion that returns early never leaks. It is aligned for any
+ * type, not initialized, and NULL if there is no memory left.
+ *
+ * Memory taken by a function measured with CUTL_BENCH only lasts one batch
+ * of iterations, so that the arena does not grow with them. It is safe to
+ * use from several threads.
+ */
+void *cutl_arena_alloc(size_t size) {
+    _cutl_arena_chunk_t *chunk;
+    void                *ptr = NULL;
+
+    size = (size + _CUTL_ARENA_ALIGN - 1) & ~(size_t)(_CUTL_ARENA_ALIGN - 1);
+
+    if (size == 0) {
+        size = _CUTL_ARENA_ALIGN;
+    }
+
+    while (__atomic_exchange_n(&_cutl_arena_lock, 1, __ATOMIC_ACQUIRE)) {
+#if _CUTL_POSIX
+        sched_yield();
+#endif
+    }
+
+    chunk = _cutl_arena;
+
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        size_t capacity = (chunk != NULL) ? 2 * chunk->size : _CUTL_ARENA_MIN_CHUNK;
+
+        if (capacity < size) {
+            capacity = size;
+        }
+
+        _cutl_alloc_paused++;
+        chunk = (_cutl_arena_chunk_t *)malloc(_CUTL_ARENA_HEADER + capacity);
+        _cutl_alloc_paused--;
+
+        if (chunk != NULL) {
+            chunk->next = _cutl_arena;
+            chunk->size = capacity;
+            chunk->used = 0;
+            _cutl_arena = chunk;
+        }
+    }
+
+    if (chunk != NULL) {
+        ptr = (char *)chunk + _CUTL_ARENA_HEADER + chunk->used;
+        chunk->used += size;
+    }
+
+    __atomic_store_n(&_cutl_arena_lock, 0, __ATOMIC_RELEASE);
+
+    return ptr;
+}
+
+
+/**
+ * Takes note of how much of the arena is in use
+ */
+void _CUTL_ARENA_MARK(_cutl_arena_mark_t *mark) {
+    mark->chunk = _cutl_arena;
+    mark->used  = (_cutl_arena != NULL) ? _cutl_arena->used : 0;
+}
+
+
+/**
+ * Takes back what was allocated from the arena since the mark
+ */
+void _CUTL_ARENA_RELEASE(const _cutl_arena_mark_t *mark) {
+    _cutl_alloc_paused++;
+
+    while (_cutl_arena != NULL && _cutl_arena != mark->chunk) {
+        _cutl_arena_chunk_t *next = _cutl_arena->next;
+
+        free(_cutl_arena);
+        _cutl_arena = next;
+    }
+
+    if (_cutl_arena != NULL) {
+        _cutl_arena->used = mark->used;
+    }
+
+    _cutl_alloc_paused--;
+}
+
+
+/**
+ * Takes back all the memory of the arena after a test. If it took several
+ * chunks, they are replaced by one as large as all of them, so that next
+ * tests find room in a single one.
+ */
+void _CUTL_ARENA_RESET(void) {
+    size_t total = 0;
+
+    if (_cutl_arena == NULL) {
+        return;
+    }
+
+    if (_cutl_arena->next == NULL) {
+        _cutl_arena->used = 0;
+        return;
+    }
+
+    _cutl_alloc_paused++;
+
+    while (_cutl_arena != NULL) {
+        _cutl_arena_chunk_t *next = _cutl_arena->next;
+
+        total += _cutl_arena->size;
+        free(_cutl_arena);
+        _cutl_arena = next;
+    }
+
+    total = (total < _CUTL_ARENA_MAX_KEPT) ? total : _CUTL_ARENA_MAX_KEPT;
+
+    if ((_cutl_arena = (_cutl_arena_chunk_t *)malloc(_CUTL_ARENA_HEADER + total)) != NULL) {
+        _cutl_arena->next = NULL;
+        _cutl_arena->size = total;
+        _cutl_arena->used = 0;
+    }
+
+    _cutl_alloc_paused--;
+}
+
+
+
+// ==========================================================================
+// TIMING
+// ==========================================================================
+
+
+/**
+ * Returns a monotonic timestamp in nanoseconds
+ */
+uint64_t _CUTL_NOW_NS(void) {
+#if _CUTL_POSIX
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+    return (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+#endif
+}
+
+
+/**
+ * Gets the CPU time used so far by the process, in nanoseconds
+ */
+void _CUTL_CPU_NS(uint64_t *user_ns, uint64_t *sys_ns) {
+#if _CUTL_POSIX
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    *user_ns = (uint64_t)usage.ru_utime.tv_sec * 1000000000u + (uint64_t)usage.ru_utime.tv_usec * 1000u;
+    *sys_ns  = (uint64_t)usage.ru_stime.tv_sec * 1000000000u + (uint64_t)usage.ru_stime.tv_usec * 1000u;
+#else
+    *user_ns = (uint64_t)clock() * (1000000000u / CLOCKS_PER_SEC);
+    *sys_ns  = 0;
+#endif
+}
+
+
+/**
+ * Writes a duration in the most readable unit
+ */
+const char *_CUTL_FORMAT_DURATION(double ns, char *buffer, size_t size) {
+    if (ns < 100) {
+        snprintf(buffer, size, "%.2f ns", ns);
+    }
+    else if (ns < 1000u) {
+        snprintf(buffer, size, "%.0f ns", ns);
+    }
+    else if (ns < 1000000u) {
+        snprintf(buffer, size, "%.2f us", ns / 1e3);
+    }
+    else if (ns < 1000000000u) {
+        snprintf(buffer, size, "%.2f ms", ns / 1e6);
+    }
+    else {
+        snprintf(buffer, size, "%.2f s", ns / 1e9);
+    }
+
+    return buffer;
+}
+
+
+/**
+ * Keeps the slowest tests seen so far
+ */
+void _CUTL_TRACK_SLOWEST(const _cutl_result_t *result) {
+    unsigned int i;
+
+    _cutl_tests_wall_ns += result->timing.wall_ns;
+
+    if (_cutl_n_slowest == 0) {
+        return;
+    }
+
+    if (_cutl_slowest == NULL) {
+        _cutl_slowest = malloc(_cutl_n_slowest * sizeof(_cutl_result_t));
+
+        if (_cutl_slowest == NULL) {
+            _cutl_n_slowest = 0;
+            return;
+        }
+    }
+
+    if (_cutl_slowest_size == _cutl_n_slowest) {
+        if (result->timing.wall_ns <= _cutl_slowest[_cutl_slowest_size - 1].timing.wall_ns) {
+            return;
+        }
+
+        _cutl_slowest_size--;
+    }
+
+    for (i = _cutl_slowest_size; i > 0 && _cutl_slowest[i - 1].timing.wall_ns < result->timing.wall_ns; i--) {
+        _cutl_slowest[i] = _cutl_slowest[i - 1];
+    }
+
+    _cutl_slowest[i] = *result;
+    _cutl_slowest_size++;
+}
+
+
+/**
+ * Lists the slowest tests and the time spent by the whole run
+ */
+void _CUTL_REPORT_TIMING_SUMMARY(void) {
+    char         total[16], tests[16], wall[16];
+    unsigned int i;
+
+    if (!_cutl_timing) {
+        return;
+    }
+
+    if (_cutl_slowest_size > 0) {
+        _CUTL_REPORT_INFO("Slowest tests:");
+
+        for (i = 0; i < _cutl_slowest_size; i++) {
+            _CUTL_REPORT_INFO("  %2u. %10s  %s l:%d (%s)", i + 1,
+                _CUTL_FORMAT_DURATION(_cutl_slowest[i].timing.wall_ns, wall, sizeof(wall)),
+                _cutl_slowest[i].file, _cutl_slowest[i].line, _cutl_slowest[i].func
+            );
+        }
+    }
+
+    _CUTL_REPORT_INFO("Total time: %s (tests: %s)",
+        _CUTL_FORMAT_DURATION(_CUTL_NOW_NS() - _cutl_run_start, total, sizeof(total)),
+        _CUTL_FORMAT_DURATION(_cutl_tests_wall_ns, tests, sizeof(tests))
+    );
+
+    free(_cutl_slowest);
+    _cutl_slowest      = NULL;
+    _cutl_slowest_size = 0;
+    _cutl_tests_wall_ns = 0;
+}
+
+
+
+// ==========================================================================
+// PERFORMANCE COUNTERS
+// ==========================================================================
+
+
+/**
+ * Reads whether to count CPU events from the environment, and opens the
+ * counters to tell which events can be counted
+ */
+void _CUTL_PERF_SETUP(void) {
+    const char *env = getenv("CUTL_PERF");
+    char        names[128] = "";
+    size_t      used = 0;
+    int         i;
+
+    if (env != NULL && *env != '\0') {
+        _cutl_perf = (strcmp(env, "0") != 0);
+    }
+
+    if (!_cutl_perf) {
+        return;
+    }
+
+    _CUTL_PERF_OPEN();
+
+    if (_cutl_perf_open == 0) {
+        _CUTL_REPORT_INFO("CPU event counters are not available");
+        return;
+    }
+
+    for (i = 0; i < _CUTL_N_PERF; i++) {
+        if ((_cutl_perf_open & (1u << i)) && used < sizeof(names)) {
+            used += (size_t)snprintf(names + used, sizeof(names) - used, "%s%s",
+                (used > 0) ? ", " : "", _cutl_perf_events[i].name);
+        }
+    }
+
+    _CUTL_REPORT_INFO("%s: %s", (_cutl_perf_open & ((1u << _CUTL_PERF_HARDWARE) - 1))
+        ? "Counting" : "Hardware counters not available, counting", names);
+}
+
+
+#if _CUTL_PERF
+
+/**
+ * Opens the counters in the process that runs the tests, unless they are
+ * already open. Those inherited from the parent of a fork count the
+ * parent, so they are closed and opened again. Software events are only
+ * counted when none of the hardware ones can be.
+ */
+void _CUTL_PERF_OPEN(void) {
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[_CUTL_N_PERF] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                                      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                                     | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+        { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    };
+
+    struct perf_event_attr attr;
+    long                   pid = (long)getpid();
+    int                    i;
+
+    if (!_cutl_perf || _cutl_perf_pid == pid) {
+        return;
+    }
+
+    for (i = 0; i < _CUTL_N_PERF; i++) {
+        if (_cutl_perf_open & (1u << i)) {
+            close(_cutl_perf_fd[i]);
+        }
+    }
+
+    _cutl_perf_open = 0;
+    _cutl_perf_pid  = pid;
+
+    for (i = 0; i < _CUTL_N_PERF; i++) {
+        if (i == _CUTL_PERF_HARDWARE && _cutl_perf_open != 0) {
+            break;
+        }
+
+        memset(&attr, 0, sizeof(attr));
+        attr.size           = sizeof(attr);
+        attr.type           = events[i].type;
+        attr.config         = events[i].config;
+        attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+
+        _cutl_perf_fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+
+        if (_cutl_perf_fd[i] >= 0) {
+            _cutl_perf_open |= 1u << i;
+        }
+    }
+}
+
+
+/**
+ * Reads the counters being counted
+ */
+void _CUTL_PERF_READ(_cutl_perf_reading_t *readings) {
+    int i;
+
+    for (i = 0; i < _CUTL_N_PERF; i++) {
+        if ((_cutl_perf_open & (1u << i))
+                && read(_cutl_perf_fd[i], &readings[i], sizeof(readings[i])) != (ssize_t)sizeof(readings[i])) {
+            memset(&readings[i], 0, sizeof(readings[i]));
+        }
+    }
+}
+
+#else
+
+void _CUTL_PERF_OPEN(void) {}
+void _CUTL_PERF_READ(_cutl_perf_reading_t *readings) { (void)readings; }
+
+#endif /* _CUTL_PERF */
+
+
+/**
+ * Adds what the counters counted between two readings. Events that did
+ * not get to run at all are left out.
+ */
+void _CUTL_PERF_ADD(_cutl_perf_t *perf, const _cutl_perf_reading_t *start, const _cutl_perf_reading_t *end) {
+    int i;
+
+    for (i = 0; i < _CUTL_N_PERF; i++) {
+        uint64_t enabled = end[i].enabled - start[i].enabled;
+        uint64_t running = end[i].running - start[i].running;
+        double   value   = (double)(end[i].value - start[i].value);
+
+        if (!(perf->counted & (1u << i))) {
+            continue;
+        }
+
+        if (running == 0 && enabled > 0) {
+            perf->counted &= ~(1u << i);
+            continue;
+        }
+
+        if (running < enabled) {
+            value *= (double)enabled / (double)running;
+        }
+
+        perf->value[i] += value;
+    }
+}
+
+
+/**
+ * Writes a count, with a suffix for thousands, millions and billions
+ */
+const char *_CUTL_FORMAT_COUNT(double count, char *buffer, size_t size) {
+    if (count < 1e3) {
+        snprintf(buffer, size, "%.*f", (count == (double)(uint64_t)count) ? 0 : 2, count);
+    }
+    else if (count < 1e6) {
+        snprintf(buffer, size, "%.2fk", count / 1e3);
+    }
+    else if (count < 1e9) {
+        snprintf(buffer, size, "%.2fM", count / 1e6);
+    }
+    else {
+        snprintf(buffer, size, "%.2fG", count / 1e9);
+    }
+
+    return buffer;
+}
+
+
+/**
+ * Writes the counted events, along with the instructions per cycle when
+ * both were counted
+ */
+const char *_CUTL_FORMAT_PERF(const _cutl_perf_t *perf, char *buffer, size_t size) {
+    size_t used = 0;
+    int    i;
+
+    buffer[0] = '\0';
+
+    for (i = 0; i < _CUTL_N_PERF && used < size; i++) {
+        char value[16];
+
+        if (!(perf->counted & (1u << i))) {
+            continue;
+        }
+
+        if (i == _CUTL_PERF_TASK_CLOCK) {
+            _CUTL_FORMAT_DURATION(perf->value[i], value, sizeof(value));
+        }
+        else {
+            _CUTL_FORMAT_COUNT(perf->value[i], value, sizeof(value));
+        }
+
+        used += (size_t)snprintf(buffer + used, size - used, "%s%s %s",
+            (used > 0) ? " | " : "", _cutl_perf_events[i].name, value);
+
+        // Instructions come right after cycles
+        if (i == 1 && (perf->counted & 1u) && perf->value[0] > 0 && used < size) {
+            used += (size_t)snprintf(buffer + used, size - used, " | IPC %.2f", perf->value[1] / perf->value[0]);
+        }
+    }
+
+    return buffer;
+}
+
+
+
+// ==========================================================================
+// MACHINE-READABLE OUTPUTS
+// ==========================================================================
+
+
+/**
+ * Opens the enabled outputs and writes their headers
+ */
+void _CUTL_OUTPUT_OPEN(const char *suite) {
+    int i;
+
+    _cutl_measure = _cutl_timing;
+
+    // Workers measure for the coordinator, which writes the outputs
+    if (_cutl_remote_role == CUTL_REMOTE_WORKER) {
+        _cutl_measure = true;
+        return;
+    }
+
+    for (i = 0; i < _CUTL_N_OUTPUTS; i++) {
+        _cutl_output_t *output = &_cutl_outputs[i];
+        const char     *path   = getenv(output->env);
+
+        if (path == NULL || *path == '\0') {
+            path = output->path;
+        }
+
+        if (path == NULL || output->file != NULL) {
+            continue;
+        }
+
+        if ((output->file = fopen(path, "w")) == NULL) {
+            _CUTL_REPORT_INFO("Could not open %s", path);
+            continue;
+        }
+
+        output->n_passed = 0;
+        output->n_failed = 0;
+        output->n_errors = 0;
+        output->begin(output, suite);
+
+        _cutl_measure = true;
+    }
+}
+
+
+/**
+ * Writes the result of a test to every enabled output
+ */
+void _CUTL_OUTPUT_TEST(const _cutl_result_t *result) {
+    int i;
+
+    for (i = 0; i < _CUTL_N_OUTPUTS; i++) {
+        _cutl_output_t *output = &_cutl_outputs[i];
+
+        if (output->file == NULL) {
+            continue;
+        }
+
+        switch (result->status) {
+            case _CUTL_SUCCESS: output->n_passed++; break;
+            case _CUTL_FAILURE: output->n_failed++; break;
+            default:            output->n_errors++; break;
+        }
+
+        output->test(output, result);
+    }
+}
+
+
+/**
+ * Writes the footers of the enabled outputs and closes them
+ */
+void _CUTL_OUTPUT_CLOSE(const char *suite) {
+    uint64_t wall_ns = _CUTL_NOW_NS() - _cutl_run_start;
+    int      i;
+
+    for (i = 0; i < _CUTL_N_OUTPUTS; i++) {
+        _cutl_output_t *output = &_cutl_outputs[i];
+
+        if (output->file == NULL) {
+            continue;
+        }
+
+        output->end(output, suite, wall_ns);
+
+        fclose(output->file);
+        output->file = NULL;
+    }
+}
+
+
+/**
+ * Writes a string escaped for XML attributes and text, or for JSON strings
+ */
+void _CUTL_WRITE_ESCAPED(FILE *file, const char *str, bool xml) {
+    for (; str != NULL && *str != '\0'; str++) {
+        unsigned char c = (unsigned char)*str;
+
+        if (xml) {
+            switch (c) {
+                case '&':  fputs("&amp;", file);  break;
+                case '<':  fputs("&lt;", file);   break;
+                case '>':  fputs("&gt;", file);   break;
+                case '"':  fputs("&quot;", file); break;
+                case '\'': fputs("&apos;", file); break;
+                default:
+                    if (c < 0x20 && c != '\n' && c != '\t') {
+                        fputc('?', file);   // Not allowed in XML 1.0
+                    }
+                    else {
+                        fputc(c, file);
+                    }
+            }
+        }
+        else {
+            switch (c) {
+                case '"':  fputs("\\\"", file); break;
+                case '\\': fputs("\\\\", file); break;
+                case '\n': fputs("\\n", file);  break;
+                case '\t': fputs("\\t", file);  break;
+                default:
+                    if (c < 0x20) {
+                        fprintf(file, "\\u%04x", c);
+                    }
+                    else {
+                        fputc(c, file);
+                    }
+            }
+        }
+    }
+}
+
+
+// JUnit XML
+//
+// The <testsuite> element needs the totals of the run, which are not known
+// until the end. Room is left for them in the header, and it is rewritten
+// once the run is over if the file allows it.
+
+#define _CUTL_JUNIT_HEADER_WIDTH 160
+
+void _CUTL_JUNIT_BEGIN(_cutl_output_t *output, const char *suite) {
+    fprintf(output->file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n");
+
+    output->header_pos = ftell(output->file);
+
+    fprintf(output->file, "%-*s>\n", _CUTL_JUNIT_HEADER_WIDTH, "<testsuite");
+    (void)suite;
+}
+
+
+void _CUTL_JUNIT_TEST(_cutl_output_t *output, const _cutl_result_t *result) {
+    FILE *file = output->file;
+
+    fprintf(file, "  <testcase classname=\"");
+    _CUTL_WRITE_ESCAPED(file, result->file, true);
+    fprintf(file, "\" name=\"");
+    _CUTL_WRITE_ESCAPED(file, result->func, true);
+
+    if (result->args != NULL && *result->args != '\0') {
+        fputc('(', file);
+        _CUTL_WRITE_ESCAPED(file, result->args, true);
+        fputc(')', file);
+    }
+
+    fprintf(file, "\" file=\"");
+    _CUTL_WRITE_ESCAPED(file, result->file, true);
+    fprintf(file, "\" line=\"%d\" time=\"%.9f\"", result->line, result->timing.wall_ns / 1e9);
+
+    if (result->status == _CUTL_SUCCESS) {
+        fprintf(file, "/>\n");
+        return;
+    }
+
+    fprintf(file, ">\n    <%s message=\"", (result->status == _CUTL_FAILURE) ? "failure" : "error");
+    _CUTL_WRITE_ESCAPED(file, result->failure_msg, true);
+    fprintf(file, "\">");
+    _CUTL_WRITE_ESCAPED(file, result->file, true);
+    fprintf(file, ":%d: ", result->failure_line);
+    _CUTL_WRITE_ESCAPED(file, result->failure_msg, true);
+    fprintf(file, "</%s>\n  </testcase>\n", (result->status == _CUTL_FAILURE) ? "failure" : "error");
+}
+
+
+void _CUTL_JUNIT_END(_cutl_output_t *output, const char *suite, uint64_t wall_ns) {
+    char header[_CUTL_JUNIT_HEADER_WIDTH + 1];
+    int  len;
+
+    fprintf(output->file, "</testsuite>\n</testsuites>\n");
+
+    len = snprintf(header, sizeof(header), "<testsuite name=\"%s\" tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.6f\"",
+        suite, output->n_passed + output->n_failed + output->n_errors,
+        output->n_failed, output->n_errors, wall_ns / 1e9);
+
+    // Names with characters to escape, or too long, are left out
+    if (len >= (int)sizeof(header) || strpbrk(suite, "&<>\"'") != NULL) {
+        len = snprintf(header, sizeof(header), "<testsuite tests=\"%u\" failures=\"%u\" errors=\"%u\" time=\"%.6f\"",
+            output->n_passed + output->n_failed + output->n_errors,
+            output->n_failed, output->n_errors, wall_ns / 1e9);
+    }
+
+    if (output->header_pos >= 0 && len < (int)sizeof(header)
+            && fseek(output->file, output->header_pos, SEEK_SET) == 0) {
+        fprintf(output->file, "%-*s", _CUTL_JUNIT_HEADER_WIDTH, header);
+    }
+}
+
+
+// JSON Lines
+
+void _CUTL_JSON_BEGIN(_cutl_output_t *output, const char *suite) {
+    fprintf(output->file, "{\"type\":\"begin\",\"suite\":\"");
+    _CUTL_WRITE_ESCAPED(output->file, suite, false);
+    fprintf(output->file, "\",\"version\":\"" CUTL_VERSION "\"}\n");
+}
+
+
+void _CUTL_JSON_TEST(_cutl_output_t *output, const _cutl_result_t *result) {
+    static const char *status_names[] = { "passed", "failed", "error" };
+    FILE              *file = output->file;
+
+    fprintf(file, "{\"type\":\"test\",\"index\":%lu,\"file\":\"", result->index);
+    _CUTL_WRITE_ESCAPED(file, result->file, false);
+    fprintf(file, "\",\"line\":%d,\"name\":\"", result->line);
+    _CUTL_WRITE_ESCAPED(file, result->func, false);
+    fprintf(file, "\",\"args\":\"");
+    _CUTL_WRITE_ESCAPED(file, result->args, false);
+    fprintf(file, "\",\"status\":\"%s\"", status_names[result->status % 3]);
+
+    if (result->cached) {
+        fprintf(file, ",\"cached\":true");
+    }
+
+    if (result->skipped) {
+        fprintf(file, ",\"skipped\":true");
+    }
+
+    if (result->status != _CUTL_SUCCESS) {
+        fprintf(file, ",\"failure_line\":%d,\"message\":\"", result->failure_line);
+        _CUTL_WRITE_ESCAPED(file, result->failure_msg, false);
+        fprintf(file, "\",\"more_failures\":%u", result->n_more_failures);
+    }
+
+    fprintf(file, ",\"wall_ns\":%llu,\"user_ns\":%llu,\"sys_ns\":%llu,\"setup_ns\":%llu,\"teardown_ns\":%llu",
+        (unsigned long long)result->timing.wall_ns, (unsigned long long)result->timing.user_ns,
+        (unsigned long long)result->timing.sys_ns, (unsigned long long)result->timing.setup_ns,
+        (unsigned long long)result->timing.teardown_ns);
+
+    if (result->bench.samples > 0) {
+        fprintf(file, ",\"bench\":{\"samples\":%u,\"iterations\":%llu,\"min_ns\":%.3f,\"median_ns\":%.3f,"
+                      "\"mean_ns\":%.3f,\"stddev_ns\":%.3f,\"p99_ns\":%.3f}",
+            (unsigned int)result->bench.samples, (unsigned long long)result->bench.iterations,
+            result->bench.min_ns, result->bench.median_ns, result->bench.mean_ns,
+            result->bench.stddev_ns, result->bench.p99_ns);
+    }
+
+    if (_CUTL_TRACK_ALLOC) {
+        fprintf(file, ",\"alloc\":{\"count\":%llu,\"bytes\":%llu,\"peak_bytes\":%lld,\"leaked\":%lld,\"leaked_bytes\":%lld}",
+            (unsigned long long)result->alloc.count, (unsigned long long)result->alloc.bytes,
+            (long long)result->alloc.peak_bytes, (long long)result->alloc.in_use,
+            (long long)result->alloc.in_use_bytes);
+    }
+
+    if (result->cases.total > 0) {
+        fprintf(file, ",\"cases\":{\"total\":%llu,\"failed\":%llu}",
+            (unsigned long long)result->cases.total, (unsigned long long)result->cases.failed);
+    }
+
+    if (result->perf.counted != 0) {
+        int i;
+
+        fprintf(file, ",\"perf\":{\"per_op\":%s", (result->bench.samples > 0) ? "true" : "false");
+
+        for (i = 0; i < _CUTL_N_PERF; i++) {
+            if (result->perf.counted & (1u << i)) {
+                fprintf(file, ",\"%s\":%.3f", _cutl_perf_events[i].key, result->perf.value[i]);
+            }
+        }
+
+        fputc('}', file);
+    }
+
+    if (result->stress.rounds > 0) {
+        uint32_t i;
+
+        fprintf(file, ",\"stress\":{\"iterations\":%llu,\"rounds\":[",
+            (unsigned long long)result->stress.iterations);
+
+        for (i = 0; i < result->stress.rounds; i++) {
+            fprintf(file, "%s{\"threads\":%u,\"ops_per_s\":%.1f,\"min_thread_ops_per_s\":%.1f,"
+                          "\"max_thread_ops_per_s\":%.1f}",
+                (i > 0) ? "," : "", (unsigned int)result->stress.round[i].threads,
+                result->stress.round[i].ops_per_s, result->stress.round[i].min_ops_per_s,
+                result->stress.round[i].max_ops_per_s);
+        }
+
+        fprintf(file, "]}");
+    }
+
+    fprintf(file, "}\n");
+}
+
+
+void _CUTL_JSON_END(_cutl_output_t *output, const char *suite, uint64_t wall_ns) {
+    fprintf(output->file, "{\"type\":\"summary\",\"suite\":\"");
+    _CUTL_WRITE_ESCAPED(output->file, suite, false);
+    fprintf(output->file, "\",\"tests\":%u,\"passed\":%u,\"failed\":%u,\"errors\":%u,"
+                          "\"cases\":%llu,\"cases_failed\":%llu,\"wall_ns\":%llu}\n",
+        output->n_passed + output->n_failed + output->n_errors,
+        output->n_passed, output->n_failed, output->n_errors,
+        _cutl_n_cases_passed + _cutl_n_cases_failed, _cutl_n_cases_failed, (unsigned long long)wall_ns);
+}
+
+
+
+// ==========================================================================
+// TEST CASES
+// ==========================================================================
+
+
+/**
+ * Makes the path of a file next to the file being tested. Returns false
+ * if the path is absolute, or there is no such place, or it does not fit.
+ */
+bool _CUTL_SOURCE_PATH(const char *path, char *buffer, size_t size) {
+    const char *slash = strrchr(_cutl_current_file, '/');
+
+    if (path[0] == '/' || slash == NULL || (size_t)(slash - _cutl_current_file) + strlen(path) + 2 > size) {
+        return false;
+    }
+
+    memcpy(buffer, _cutl_current_file, (size_t)(slash - _cutl_current_file) + 1);
+    strcpy(buffer + (slash - _cutl_current_file) + 1, path);
+
+    return true;
+}
+
+
+/**
+ * Maps a whole file into memory, read only, or reads it into the heap
+ * where it cannot be mapped. Returns NULL if it is empty or fails.
+ */
+const char *_CUTL_MAP_FILE(FILE *file, size_t *size) {
+    const char *data = NULL;
+    long        end;
+
+    fseek(file, 0, SEEK_END);
+    end = ftell(file);
+    *size = (end > 0) ? (size_t)end : 0;
+
+    if (*size == 0) {
+        return NULL;
+    }
+
+#if _CUTL_POSIX
+    {
+        void *mapped = mmap(NULL, *size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+
+        if (mapped != MAP_FAILED) {
+            madvise(mapped, *size, MADV_SEQUENTIAL);
+            data = (const char *)mapped;
+        }
+    }
+#else
+    {
+        char *buffer;
+
+        _cutl_alloc_paused++;
+        buffer = malloc(*size);
+        _cutl_alloc_paused--;
+
+        fseek(file, 0, SEEK_SET);
+
+        if (buffer != NULL && fread(buffer, 1, *size, file) == *size) {
+            data = buffer;
+        }
+        else {
+            _cutl_alloc_paused++;
+            free(buffer);
+            _cutl_alloc_paused--;
+        }
+    }
+#endif
+
+    return data;
+}
+
+
+/**
+ * Releases a file mapped by _CUTL_MAP_FILE
+ */
+void _CUTL_UNMAP_FILE(const char *data, size_t size) {
+    if (data == NULL) {
+        return;
+    }
+
+#if _CUTL_POSIX
+    munmap((void *)data, size);
+#else
+    (void)size;
+    _cutl_alloc_paused++;
+    free((void *)data);
+    _cutl_alloc_paused--;
+#endif
+}
+
+
+/**
+ * Maps a case file into memory. Relative paths not found from the working
+ * directory are looked for next to the file being tested.
+ */
+bool _CUTL_CASES_MAP(const char *path) {
+    char  buffer[1024];
+    FILE *file = fopen(path, "rb");
+
+    if (file == NULL && _CUTL_SOURCE_PATH(path, buffer, sizeof(buffer))) {
+        file = fopen(buffer, "rb");
+    }
+
+    if (file == NULL) {
+        return false;
+    }
+
+    _cutl_cases_data = _CUTL_MAP_FILE(file, &_cutl_cases_size);
+    fclose(file);
+
+    return _cutl_cases_size == 0 || _cutl_cases_data != NULL;
+}
+
+
+/**
+ * Unmaps the case file, if any is mapped
+ */
+void _CUTL_CASES_UNMAP(void) {
+    _CUTL_UNMAP_FILE(_cutl_cases_data, _cutl_cases_size);
+    _cutl_cases_data = NULL;
+}
+
+
+/**
+ * Runs a function on every record of a case file. Records are handed over
+ * where they are in the mapped file, and a case fails when any failure is
+ * registered while the function runs on it. The cases go on after a
+ * failure, but not after an error.
+ */
+void _CUTL_TEST_CASES(void (*func)(const cutl_case_t *), const char *path) {
+    size_t      len   = strlen(path);
+    bool        lines = (len >= 4 && strcmp(path + len - 4, ".tsv") == 0);
+    size_t      offset = 0;
+    cutl_case_t record;
+
+    if (!_CUTL_CASES_MAP(path)) {
+        char msg[_CUTL_MAX_LEN_MSG];
+
+        snprintf(msg, sizeof(msg), "Could not open the case file %s", path);
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, msg);
+        return;
+    }
+
+    record.index = 0;
+
+    while (offset < _cutl_cases_size) {
+        const char  *data = _cutl_cases_data + offset;
+        size_t       left = _cutl_cases_size - offset;
+        unsigned int failures;
+
+        record.offset = offset;
+
+        if (lines) {
+            const char *end = (const char *)memchr(data, '\n', left);
+
+            record.data = data;
+            record.size = (end != NULL) ? (size_t)(end - data) : left;
+            offset     += record.size + (end != NULL);
+
+            if (record.size > 0 && data[record.size - 1] == '\r') {
+                record.size--;
+            }
+
+            if (record.size == 0 || data[0] == '#') {
+                continue;
+            }
+        }
+        else {
+            const unsigned char *prefix = (const unsigned char *)data;
+
+            record.size = (left < 4) ? 0 : (size_t)prefix[0] | (size_t)prefix[1] << 8
+                                         | (size_t)prefix[2] << 16 | (size_t)prefix[3] << 24;
+
+            if (left < 4 || record.size > left - 4) {
+                char msg[_CUTL_MAX_LEN_MSG];
+
+                snprintf(msg, sizeof(msg), "Truncated record %zu at offset %zu of %s",
+                    record.index, offset, path);
+                _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, msg);
+                break;
+            }
+
+            record.data = data + 4;
+            offset     += 4 + record.size;
+        }
+
+        failures = __atomic_load_n(&_cutl_context.claimed, __ATOMIC_ACQUIRE)
+                 + __atomic_load_n(&_cutl_context.n_more_failures, __ATOMIC_RELAXED);
+
+        _cutl_case_current = &record;
+        func(&record);
+        _cutl_case_current = NULL;
+
+        _cutl_cases_stats.total++;
+
+        if (__atomic_load_n(&_cutl_context.claimed, __ATOMIC_ACQUIRE)
+                + __atomic_load_n(&_cutl_context.n_more_failures, __ATOMIC_RELAXED) != failures) {
+            _cutl_cases_stats.failed++;
+        }
+
+        if (__atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE) == _CUTL_ERROR) {
+            break;
+        }
+
+        record.index++;
+    }
+
+    _CUTL_CASES_UNMAP();
+}
+
+
+/**
+ * Reports how many cases passed, if any test ran cases
+ */
+void _CUTL_REPORT_CASES_SUMMARY(void) {
+    if (_cutl_n_cases_passed + _cutl_n_cases_failed > 0) {
+        _CUTL_REPORT_INFO("Cases passed: %llu / %llu", _cutl_n_cases_passed,
+            _cutl_n_cases_passed + _cutl_n_cases_failed);
+    }
+}
+
+
+/**
+ * Returns the given field of a record of a .tsv case file, where fields
+ * are separated by tabs, and sets its size. The field is not copied, so it
+ * is not NUL-terminated. Returns NULL if the record has fewer fields.
+ */
+__CUTL_UNUSED const char *cutl_case_field(const cutl_case_t *record, unsigned int i, size_t *size) {
+    const char *field = record->data;
+    const char *end   = record->data + record->size;
+
+    for (;;) {
+        const char *tab = (const char *)memchr(field, '\t', (size_t)(end - field));
+
+        if (i == 0) {
+            *size = (size_t)(((tab != NULL) ? tab : end) - field);
+            return field;
+        }
+
+        if (tab == NULL) {
+            return NULL;
+        }
+
+        field = tab + 1;
+        i--;
+    }
+}
+
+
+
+// ==========================================================================
+// PROPERTY-BASED TESTS
+// ==========================================================================
+
+
+static uint64_t _cutl_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+
+/**
+ * Returns the next number of a xoshiro256** generator
+ */
+__CUTL_NO_COVERAGE uint64_t _CUTL_RANDOM(uint64_t state[4]) {
+    uint64_t result = _cutl_rotl(state[1] * 5, 7) * 9;
+    uint64_t t      = state[1] << 17;
+
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3]  = _cutl_rotl(state[3], 45);
+
+    return result;
+}
+
+
+/**
+ * Returns the next number of a splitmix64 generator, which spreads a seed
+ * over the state of xoshiro256**
+ */
+uint64_t _CUTL_SPLITMIX(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+
+    return z ^ (z >> 31);
+}
+
+
+/**
+ * Sets the seed of the run and the cases of every property. The
+ * environment variables override the configuration, and a seed is made
+ * up when none is given.
+ */
+void _CUTL_PROPERTY_SETUP(void) {
+    const char *cases = getenv("CUTL_PROPERTY_CASES");
+    const char *seed  = getenv("CUTL_SEED");
+
+    if (cases != NULL && *cases != '\0') {
+        _cutl_property_cases = (unsigned int)strtoul(cases, NULL, 10);
+    }
+
+    if (seed != NULL && *seed != '\0') {
+        _cutl_property_seed = strtoull(seed, NULL, 0);
+    }
+
+    if (_cutl_property_seed == 0) {
+        uint64_t mix = _CUTL_NOW_NS() ^ (uint64_t)(uintptr_t)&mix;
+
+        _cutl_property_seed = _CUTL_SPLITMIX(&mix);
+    }
+
+    // For generators used out of properties
+    _CUTL_PROPERTY_START("", "");
+    _cutl_property.active = false;
+}
+
+
+/**
+ * Makes room for n choices in each buffer of the property
+ */
+static bool _cutl_property_reserve(_cutl_property_t *property, size_t n) {
+    size_t    capacity = (property->capacity > 0) ? property->capacity : 256;
+    uint64_t *buffers[3];
+    int       i;
+
+    if (n <= property->capacity) {
+        return true;
+    }
+
+    while (capacity < n) {
+        capacity *= 2;
+    }
+
+    _cutl_alloc_paused++;
+    buffers[0] = (uint64_t *)realloc(property->drawn, capacity * sizeof(uint64_t));
+    property->drawn = (buffers[0] != NULL) ? buffers[0] : property->drawn;
+    buffers[1] = (uint64_t *)realloc(property->input, capacity * sizeof(uint64_t));
+    property->input = (buffers[1] != NULL) ? buffers[1] : property->input;
+    buffers[2] = (uint64_t *)realloc(property->best, capacity * sizeof(uint64_t));
+    property->best  = (buffers[2] != NULL) ? buffers[2] : property->best;
+    _cutl_alloc_paused--;
+
+    for (i = 0; i < 3; i++) {
+        if (buffers[i] == NULL) {
+            return false;
+        }
+    }
+
+    property->capacity = capacity;
+    return true;
+}
+
+
+/**
+ * Keeps a choice of the current run, for it to be replayed
+ */
+static void _cutl_property_record(_cutl_property_t *property, uint64_t value) {
+    if (!property->active) {
+        return;
+    }
+
+    if (property->n_drawn == property->capacity
+            && !_cutl_property_reserve(property, property->n_drawn + 1)) {
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not allocate the choices of the property");
+        property->active = false;
+        return;
+    }
+
+    property->drawn[property->n_drawn++] = value;
+}
+
+
+/**
+ * Returns a choice between 0 and bound, both included. Random choices
+ * favour both ends and small numbers, where bugs tend to be. Replayed
+ * choices beyond the bound are clamped, and missing ones are 0.
+ */
+uint64_t _CUTL_PROPERTY_DRAW(uint64_t bound) {
+    _cutl_property_t *property = &_cutl_property;
+    uint64_t          value;
+
+    if (property->replay) {
+        value = (property->n_drawn < property->n_input) ? property->input[property->n_drawn] : 0;
+        value = (value < bound) ? value : bound;
+    }
+    else {
+        uint64_t random = _CUTL_RANDOM(property->rng);
+
+        switch (random & 15) {
+            case 0:
+                value = 0;
+                break;
+
+            case 1:
+                value = bound;
+                break;
+
+            case 2:
+            case 3:
+                value = (random >> 4) % (((bound < 16) ? bound : 16) + 1);
+                break;
+
+            default:
+                random = _CUTL_RANDOM(property->rng);
+
+                if (bound == UINT64_MAX) {
+                    value = random;
+                }
+                else {
+#ifdef __SIZEOF_INT128__
+                    value = (uint64_t)(((unsigned __int128)random * (bound + 1)) >> 64);
+#else
+                    value = random % (bound + 1);
+#endif
+                }
+        }
+    }
+
+    _cutl_property_record(property, value);
+
+    return value;
+}
+
+
+/**
+ * Tells whether a string or buffer of len elements gets one more, with a
+ * choice of its own. Shrinking it to 0 ends the string there, and removing
+ * it along with the choice of the element takes that element out. Random
+ * strings are empty now and then, and about half max_len long otherwise.
+ */
+bool _CUTL_PROPERTY_MORE(size_t len, size_t max_len) {
+    _cutl_property_t *property = &_cutl_property;
+    uint64_t          more;
+
+    if (len >= max_len) {
+        return false;
+    }
+
+    if (property->replay) {
+        more = (property->n_drawn < property->n_input && property->input[property->n_drawn] > 0);
+    }
+    else {
+        uint64_t random  = _CUTL_RANDOM(property->rng);
+        uint64_t average = (max_len < 64) ? (max_len + 1) / 2 : 32;
+
+        more = (len > 0 || (random & 15) != 0) && (random >> 4) % (average + 1) != 0;
+    }
+
+    _cutl_property_record(property, more);
+
+    return more != 0;
+}
+
+
+/**
+ * Returns memory that lasts until the next run of the property
+ */
+void *_CUTL_PROPERTY_ALLOC(size_t size) {
+    _cutl_arena_chunk_t *chunk = _cutl_property.scratch;
+
+    if (chunk == NULL || chunk->size - chunk->used < size) {
+        size_t capacity = (chunk != NULL) ? 2 * chunk->size : _CUTL_ARENA_MIN_CHUNK;
+
+        if (capacity < size) {
+            capacity = size;
+        }
+
+        _cutl_alloc_paused++;
+        chunk = (_cutl_arena_chunk_t *)malloc(_CUTL_ARENA_HEADER + capacity);
+        _cutl_alloc_paused--;
+
+        if (chunk == NULL) {
+            _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not allocate the arguments of the property");
+            _CUTL_THREAD_EXIT();
+        }
+
+        chunk->next = _cutl_property.scratch;
+        chunk->size = capacity;
+        chunk->used = 0;
+        _cutl_property.scratch = chunk;
+    }
+
+    chunk->used += size;
+
+    return (char *)chunk + _CUTL_ARENA_HEADER + chunk->used - size;
+}
+
+
+/**
+ * Adds a generated argument to the description of the counterexample
+ */
+void _CUTL_PROPERTY_DESCRIBE(const char *format, ...) {
+    size_t  used = strlen(_cutl_property.args);
+    va_list args;
+
+    if (used + 2 >= sizeof(_cutl_property.args)) {
+        return;
+    }
+
+    if (used > 0) {
+        strcpy(_cutl_property.args + used, ", ");
+        used += 2;
+    }
+
+    va_start(args, format);
+    vsnprintf(_cutl_property.args + used, sizeof(_cutl_property.args) - used, format, args);
+    va_end(args);
+}
+
+
+/**
+ * Gets ready to run a property, with a seed of its own that depends on
+ * that of the run and on what the property is
+ */
+void _CUTL_PROPERTY_START(const char *func, const char *generators) {
+    _cutl_property_t *property = &_cutl_property;
+    uint64_t          seed     = _cutl_property_seed;
+    const char       *c;
+    int               i;
+
+    for (c = func; *c != '\0'; c++) {
+        seed = (seed ^ (unsigned char)*c) * 0x100000001b3ull;
+    }
+
+    for (c = generators; *c != '\0'; c++) {
+        seed = (seed ^ (unsigned char)*c) * 0x100000001b3ull;
+    }
+
+    property->func     = func;
+    property->seed     = seed;
+    property->phase    = _CUTL_PROPERTY_GENERATING;
+    property->cases    = 0;
+    property->runs     = 0;
+    property->shrinks  = 0;
+    property->n_drawn  = 0;
+    property->n_input  = 0;
+    property->n_best   = 0;
+    property->replay   = false;
+    property->ran      = false;
+    property->describe = false;
+    property->args[0]  = '\0';
+    property->active   = _cutl_property_reserve(property, 256);
+
+    for (i = 0; i < 4; i++) {
+        property->rng[i] = _CUTL_SPLITMIX(&seed);
+    }
+}
+
+
+/**
+ * Gets the choices of the next candidate from the simplest failing ones,
+ * once told whether the previous candidate was simpler. Passes over the
+ * choices remove them in chunks from the end, lower them one by one, and
+ * move amounts from one to a later one, as in a + b where only the sum
+ * matters. Lowering and moving are binary searches. Passes are repeated
+ * while they find simpler cases. Returns false when nothing is left.
+ */
+bool _CUTL_PROPERTY_SHRINK(bool accepted) {
+    _cutl_property_t *property = &_cutl_property;
+
+    if (property->searching) {
+        if (property->n_best != property->search_len) {
+            property->searching = false;    // What the choices after it mean changed
+        }
+        else if (property->pass == _CUTL_PROPERTY_LOWER) {
+            if (accepted) {
+                property->hi = property->best[property->index];
+            }
+            else {
+                property->lo = property->mid + 1;
+            }
+
+            property->searching = property->lo < property->hi;
+        }
+        else {
+            // Amounts still to try, from what is moved already
+            property->hi = accepted ? property->hi - property->mid : property->mid - 1;
+            property->searching = property->hi > 0;
+        }
+
+        if (!property->searching) {
+            property->other++;
+        }
+    }
+
+    if (property->runs >= _CUTL_PROPERTY_MAX_RUNS) {
+        return false;
+    }
+
+    for (;;) {
+        size_t i = property->index;
+        size_t j = property->other;
+
+        if (property->searching) {
+            break;
+        }
+
+        if (property->pass == _CUTL_PROPERTY_DELETE) {
+            if (i == 0) {
+                property->chunk /= 2;
+
+                if (property->chunk == 0) {
+                    property->pass  = _CUTL_PROPERTY_LOWER;
+                    property->index = 0;
+                    property->other = 0;
+                    continue;
+                }
+
+                property->index = (property->n_best >= property->chunk) ? property->n_best - property->chunk + 1 : 0;
+                continue;
+            }
+
+            property->index = --i;
+
+            if (i + property->chunk > property->n_best) {
+                continue;
+            }
+
+            memcpy(property->input, property->best, i * sizeof(uint64_t));
+            memcpy(property->input + i, property->best + i + property->chunk,
+                (property->n_best - i - property->chunk) * sizeof(uint64_t));
+            property->n_input = property->n_best - property->chunk;
+
+            return true;
+        }
+
+        // Lowering goes through every choice once, moving through every
+        // pair of choices close enough
+        if (i >= property->n_best) {
+            if (property->pass == _CUTL_PROPERTY_LOWER) {
+                property->pass  = _CUTL_PROPERTY_MOVE;
+                property->index = 0;
+                property->other = 1;
+                continue;
+            }
+
+            if (!property->improved) {
+                return false;
+            }
+
+            property->improved = false;
+            property->pass     = _CUTL_PROPERTY_DELETE;
+            property->chunk    = 2 * _CUTL_PROPERTY_CHUNK;
+            property->index    = 0;
+            continue;
+        }
+
+        if (property->pass == _CUTL_PROPERTY_LOWER) {
+            if (j > 0 || property->best[i] == 0) {
+                property->index++;
+                property->other = 0;
+                continue;
+            }
+
+            property->lo = 0;
+            property->hi = property->best[i];
+        }
+        else {
+            if (j >= property->n_best || j > i + _CUTL_PROPERTY_CHUNK || property->best[i] == 0) {
+                property->index++;
+                property->other = property->index + 1;
+                continue;
+            }
+
+            if (property->best[j] == UINT64_MAX) {
+                property->other++;
+                continue;
+            }
+
+            property->hi = (property->best[i] < UINT64_MAX - property->best[j])
+                         ? property->best[i] : UINT64_MAX - property->best[j];
+        }
+
+        property->search_len = property->n_best;
+        property->searching  = true;
+    }
+
+    memcpy(property->input, property->best, property->n_best * sizeof(uint64_t));
+    property->n_input = property->n_best;
+
+    if (property->pass == _CUTL_PROPERTY_LOWER) {
+        property->mid = property->lo + (property->hi - property->lo) / 2;
+        property->input[property->index] = property->mid;
+    }
+    else {
+        property->mid = property->hi - property->hi / 2;
+        property->input[property->index] -= property->mid;
+        property->input[property->other] += property->mid;
+    }
+
+    return true;
+}
+
+
+/**
+ * Tells about the counterexample in the failure of its last replay
+ */
+void _CUTL_PROPERTY_REPORT(bool failed) {
+    _cutl_property_t *property = &_cutl_property;
+    char             *msg      = _cutl_context.failure_msg;
+    size_t            used     = strlen(msg);
+
+    if (!failed) {
+        char error[_CUTL_MAX_LEN_MSG];
+
+        snprintf(error, sizeof(error), "Case %llu of the property failed, but not when replayed "
+                "(CUTL_SEED=0x%016llx)", (unsigned long long)property->cases,
+                (unsigned long long)_cutl_property_seed);
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, error);
+        return;
+    }
+
+    snprintf(msg + used, _CUTL_MAX_LEN_MSG - used,
+        "\n\t  counterexample: %s(%s)\n\t  found at case %llu and shrunk %llu times, CUTL_SEED=0x%016llx",
+        property->func, property->args, (unsigned long long)property->cases,
+        (unsigned long long)property->shrinks, (unsigned long long)_cutl_property_seed);
+}
+
+
+/**
+ * Called before each run of a property, and once more after the last one.
+ * Looks at how the run went, and sets up the next one: a new random case,
+ * a candidate of the shrinking, or the replay of the simplest failing case
+ * found. Returns false when done.
+ */
+bool _CUTL_PROPERTY_NEXT(void) {
+    _cutl_property_t *property = &_cutl_property;
+    bool              failed   = __atomic_load_n(&_cutl_context.claimed, __ATOMIC_ACQUIRE) != 0;
+    bool              accepted = false;
+
+    if (property->phase == _CUTL_PROPERTY_REPLAYING) {
+        _CUTL_PROPERTY_REPORT(failed);
+        property->active = false;
+        return false;
+    }
+
+    // Errors are not shrunk, but where they happened is told
+    if (failed && __atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE) == _CUTL_ERROR) {
+        size_t used = strlen(_cutl_context.failure_msg);
+
+        snprintf(_cutl_context.failure_msg + used, _CUTL_MAX_LEN_MSG - used,
+            "\n\t  in case %llu of the property, CUTL_SEED=0x%016llx",
+            (unsigned long long)property->cases + 1, (unsigned long long)_cutl_property_seed);
+
+        if (property->phase == _CUTL_PROPERTY_GENERATING) {
+            _cutl_cases_stats.total++;
+            _cutl_cases_stats.failed++;
+        }
+
+        property->active = false;
+        return false;
+    }
+
+    // Failures are kept for the last replay only
+    if (failed) {
+        _cutl_context.claimed         = 0;
+        _cutl_context.n_more_failures = 0;
+        __atomic_store_n(&_cutl_context.status, _CUTL_SUCCESS, __ATOMIC_RELEASE);
+    }
+
+    if (property->phase == _CUTL_PROPERTY_GENERATING && property->ran) {
+        property->cases++;
+        _cutl_cases_stats.total++;
+
+        if (failed) {
+            _cutl_cases_stats.failed++;
+
+            memcpy(property->best, property->drawn, property->n_drawn * sizeof(uint64_t));
+            property->n_best    = property->n_drawn;
+            property->phase     = _CUTL_PROPERTY_SHRINKING;
+            property->pass      = _CUTL_PROPERTY_DELETE;
+            property->chunk     = 2 * _CUTL_PROPERTY_CHUNK;
+            property->index     = 0;
+            property->improved  = false;
+            property->searching = false;
+            property->replay    = true;
+        }
+        else if (property->cases >= _cutl_property_cases) {
+            property->active = false;
+            return false;
+        }
+    }
+    else if (property->phase == _CUTL_PROPERTY_SHRINKING) {
+        size_t i;
+
+        property->runs++;
+
+        // Shorter, or as long but smaller at the first choice that differs
+        if (failed && property->n_drawn <= property->n_best) {
+            accepted = property->n_drawn < property->n_best;
+
+            for (i = 0; !accepted && i < property->n_drawn; i++) {
+                if (property->drawn[i] != property->best[i]) {
+                    accepted = property->drawn[i] < property->best[i];
+                    break;
+                }
+            }
+        }
+
+        if (accepted) {
+            memcpy(property->best, property->drawn, property->n_drawn * sizeof(uint64_t));
+            property->n_best   = property->n_drawn;
+            property->improved = true;
+            property->shrinks++;
+        }
+    }
+
+    if (property->phase == _CUTL_PROPERTY_SHRINKING && !_CUTL_PROPERTY_SHRINK(accepted)) {
+        memcpy(property->input, property->best, property->n_best * sizeof(uint64_t));
+        property->n_input  = property->n_best;
+        property->phase    = _CUTL_PROPERTY_REPLAYING;
+        property->describe = true;
+        property->args[0]  = '\0';
+    }
+
+    // Strings of the previous run are no longer used
+    if (property->scratch != NULL) {
+        _cutl_arena_chunk_t *chunk = property->scratch->next;
+
+        while (chunk != NULL) {
+            _cutl_arena_chunk_t *next = chunk->next;
+
+            _cutl_alloc_paused++;
+            free(chunk);
+            _cutl_alloc_paused--;
+
+            chunk = next;
+        }
+
+        property->scratch->next = NULL;
+        property->scratch->used = 0;
+    }
+
+    property->n_drawn = 0;
+    property->ran     = true;
+
+    return true;
+}
+
+
+/**
+ * Returns an integer between min and max, both included. Shrinks towards
+ * the one closest to zero.
+ */
+__CUTL_UNUSED long long cutl_gen_int(long long min, long long max) {
+    long long value;
+
+    if (min > max) {
+        value = min;
+        min   = max;
+        max   = value;
+    }
+
+    if (min >= 0) {
+        value = (long long)((uint64_t)min + _CUTL_PROPERTY_DRAW((uint64_t)max - (uint64_t)min));
+    }
+    else if (max <= 0) {
+        value = (long long)((uint64_t)max - _CUTL_PROPERTY_DRAW((uint64_t)max - (uint64_t)min));
+    }
+    else if (_CUTL_PROPERTY_DRAW(1) == 0) {
+        value = (long long)_CUTL_PROPERTY_DRAW((uint64_t)max);
+    }
+    else {
+        value = (long long)(0 - _CUTL_PROPERTY_DRAW(0 - (uint64_t)min));
+    }
+
+    if (_cutl_property.describe) {
+        _CUTL_PROPERTY_DESCRIBE("%lld", value);
+    }
+
+    return value;
+}
+
+
+/**
+ * Returns a double between min and max, both included, which must be
+ * finite. Shrinks towards the one closest to zero.
+ */
+__CUTL_UNUSED double cutl_gen_double(double min, double max) {
+    const uint64_t steps = (uint64_t)1 << 53;
+    double         value;
+
+    if (min > max) {
+        value = min;
+        min   = max;
+        max   = value;
+    }
+
+    if (min >= 0) {
+        value = min + (max - min) * ((double)_CUTL_PROPERTY_DRAW(steps) / (double)steps);
+    }
+    else if (max <= 0) {
+        value = max - (max - min) * ((double)_CUTL_PROPERTY_DRAW(steps) / (double)steps);
+    }
+    else if (_CUTL_PROPERTY_DRAW(1) == 0) {
+        value = max * ((double)_CUTL_PROPERTY_DRAW(steps) / (double)steps);
+    }
+    else {
+        value = min * ((double)_CUTL_PROPERTY_DRAW(steps) / (double)steps);
+    }
+
+    value = (value < min) ? min : (value > max) ? max : value;
+
+    if (_cutl_property.describe) {
+        _CUTL_PROPERTY_DESCRIBE("%.17g", value);
+    }
+
+    return value;
+}
+
+
+/**
+ * Returns a float between min and max, both included, which must be
+ * finite. Shrinks towards the one closest to zero.
+ */
+__CUTL_UNUSED float cutl_gen_float(float min, float max) {
+    bool  describe = _cutl_property.describe;
+    float value;
+
+    _cutl_property.describe = false;
+    value = (float)cutl_gen_double(min, max);
+    _cutl_property.describe = describe;
+
+    value = (value < min) ? min : (value > max) ? max : value;
+
+    if (describe) {
+        _CUTL_PROPERTY_DESCRIBE("%.9gf", (double)value);
+    }
+
+    return value;
+}
+
+
+/**
+ * Returns a NUL-terminated string of printable ASCII characters, with up to
+ * max_len of them. Shrinks towards shorter strings of 'a'. It lasts until
+ * the property runs again.
+ */
+__CUTL_UNUSED const char *cutl_gen_string(size_t max_len) {
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"
+                                   " !\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~";
+    char  *string = (char *)_CUTL_PROPERTY_ALLOC(max_len + 1);
+    size_t len    = 0;
+    size_t i;
+
+    while (_CUTL_PROPERTY_MORE(len, max_len)) {
+        string[len++] = alphabet[_CUTL_PROPERTY_DRAW(sizeof(alphabet) - 2)];
+    }
+
+    string[len] = '\0';
+
+    if (_cutl_property.describe) {
+        char   escaped[96];
+        size_t used = 0;
+
+        for (i = 0; i < len && used < sizeof(escaped) - 8; i++) {
+            if (string[i] == '"' || string[i] == '\\') {
+                escaped[used++] = '\\';
+            }
+
+            escaped[used++] = string[i];
+        }
+
+        escaped[used] = '\0';
+        _CUTL_PROPERTY_DESCRIBE("\"%s\"%s", escaped, (i < len) ? "..." : "");
+    }
+
+    return string;
+}
+
+
+/**
+ * Returns a buffer of up to max_len bytes of any value. Shrinks towards
+ * shorter buffers of zeros. It lasts until the property runs again.
+ */
+__CUTL_UNUSED cutl_bytes_t cutl_gen_bytes(size_t max_len) {
+    cutl_bytes_t bytes;
+    uint8_t     *data;
+    size_t       i;
+
+    data       = (uint8_t *)_CUTL_PROPERTY_ALLOC(max_len + 1);
+    bytes.size = 0;
+
+    while (_CUTL_PROPERTY_MORE(bytes.size, max_len)) {
+        data[bytes.size++] = (uint8_t)_CUTL_PROPERTY_DRAW(255);
+    }
+
+    bytes.data = data;
+
+    if (_cutl_property.describe) {
+        char   hex[2 * 32 + 1] = "";
+        size_t shown = (bytes.size < 32) ? bytes.size : 32;
+
+        for (i = 0; i < shown; i++) {
+            snprintf(hex + 2 * i, 3, "%02x", data[i]);
+        }
+
+        _CUTL_PROPERTY_DESCRIBE("{%zu bytes: %s%s}", bytes.size, hex, (shown < bytes.size) ? "..." : "");
+    }
+
+    return bytes;
+}
+
+
+
+// ==========================================================================
+// FUZZING
+// ==========================================================================
+
+
+#if defined(__GNUC__) || defined(__clang__)
+
+/**
+ * Numbers the edges of a module built with trace-pc-guard
+ */
+__CUTL_NO_COVERAGE __attribute__((weak)) void __sanitizer_cov_trace_pc_guard_init(uint32_t *start, uint32_t *stop) {
+    uint32_t *guard;
+
+    if (start == stop || *start != 0) {
+        return;
+    }
+
+    for (guard = start; guard < stop; guard++) {
+        *guard = ++_cutl_fuzz_guards;
+    }
+}
+
+
+/**
+ * Counts an edge taken (trace-pc-guard)
+ */
+__CUTL_NO_COVERAGE __attribute__((weak)) void __sanitizer_cov_trace_pc_guard(uint32_t *guard) {
+    if (_cutl_fuzz_tracing) {
+        ((uint8_t *)_cutl_fuzz_map)[*guard & (_CUTL_FUZZ_MAP_SIZE - 1)]++;
+    }
+}
+
+
+/**
+ * Counts the edge from the previous block to this one (trace-pc), from
+ * where the blocks are, as AFL does
+ */
+__CUTL_NO_COVERAGE __attribute__((weak)) void __sanitizer_cov_trace_pc(void) {
+    if (_cutl_fuzz_tracing) {
+        uintptr_t block = (uintptr_t)__builtin_return_address(0);
+
+        block = (block ^ (block >> 16)) * 0x9e3779b1u;
+        block = (block >> 8) & (_CUTL_FUZZ_MAP_SIZE - 1);
+
+        ((uint8_t *)_cutl_fuzz_map)[block ^ _cutl_fuzz_prev]++;
+        _cutl_fuzz_prev = block >> 1;
+    }
+}
+
+#endif
+
+
+#if _CUTL_POSIX
+
+/**
+ * Runs the fuzz target on an input. Returns whether it failed, leaving
+ * the failure registered.
+ */
+__CUTL_NO_COVERAGE bool _CUTL_FUZZ_RUN(void (*func)(const uint8_t *, size_t), const uint8_t *data, size_t size) {
+    _cutl_jmp_buf_t exit;
+
+    memcpy(exit, _cutl_context.exit, sizeof(_cutl_jmp_buf_t));
+
+    _cutl_fuzz_data = data;
+    _cutl_fuzz_size = size;
+
+    if (_cutl_fuzz && _cutl_fuzz_run_ms > 0) {
+        _CUTL_TIMEOUT_ARM(_cutl_fuzz_run_ms);
+    }
+
+    if (_CUTL_SETJMP(_cutl_context.exit) == 0) {
+        _cutl_fuzz_prev    = 0;
+        _cutl_fuzz_tracing = _cutl_fuzz;
+        func(data, size);
+    }
+
+    _cutl_fuzz_tracing = false;
+
+    _CUTL_TIMEOUT_REGISTER();
+
+    memcpy(_cutl_context.exit, exit, sizeof(_cutl_jmp_buf_t));
+
+    return __atomic_load_n(&_cutl_context.claimed, __ATOMIC_ACQUIRE) != 0;
+}
+
+
+/**
+ * Looks at the counts of the last run, and clears them for the next one.
+ * Returns whether any edge was taken a number of times never seen before,
+ * in buckets of powers of 2, and adds the new edges to edges.
+ */
+__CUTL_NO_COVERAGE bool _CUTL_FUZZ_COVERAGE(size_t *edges) {
+    bool   found = false;
+    size_t w;
+
+    for (w = 0; w < _CUTL_FUZZ_MAP_SIZE / 8; w++) {
+        const uint8_t *counts;
+        int            i;
+
+        if (_cutl_fuzz_map[w] == 0) {
+            continue;
+        }
+
+        counts = (const uint8_t *)&_cutl_fuzz_map[w];
+
+        for (i = 0; i < 8; i++) {
+            uint8_t *seen = &_cutl_fuzz_seen[8 * w + (size_t)i];
+            uint8_t  bucket;
+
+            if (counts[i] == 0) {
+                continue;
+            }
+
+            bucket = (counts[i] <= 3)  ? (uint8_t)(1u << (counts[i] - 1))
+                   : (counts[i] < 8)   ? 8
+                   : (counts[i] < 16)  ? 16
+                   : (counts[i] < 32)  ? 32
+                   : (counts[i] < 128) ? 64 : 128;
+
+            if ((*seen & bucket) == 0) {
+                *edges += (*seen == 0);
+                *seen  |= bucket;
+                found   = true;
+            }
+        }
+
+        _cutl_fuzz_map[w] = 0;
+    }
+
+    return found;
+}
+
+
+/**
+ * Changes an input in one to eight random ways, as byte flips, new bytes,
+ * removed or copied ranges, or parts of another input of the corpus.
+ * Returns its new size, which is never over max_len.
+ */
+__CUTL_NO_COVERAGE size_t _CUTL_FUZZ_MUTATE(uint8_t *data, size_t size, size_t max_len) {
+    static const uint32_t interesting[] = { 0, 1, 0x7f, 0x80, 0xff, 0x7fff, 0x8000, 0xffff,
+                                            0x7fffffff, 0x80000000u, 0xffffffffu, 16, 32, 64, 100, 1000 };
+    uint64_t n_changes = 1 + (_CUTL_RANDOM(_cutl_fuzz_rng) & 7);
+
+    while (n_changes-- > 0) {
+        uint64_t random = _CUTL_RANDOM(_cutl_fuzz_rng);
+        size_t   at     = (size > 0) ? (size_t)((random >> 8) % size) : 0;
+        size_t   len, from;
+
+        switch ((size == 0) ? 4 : random % 10) {
+            case 0:     // Flip a bit
+                data[at] ^= (uint8_t)(1u << ((random >> 40) & 7));
+                break;
+
+            case 1:     // Set a random byte
+                data[at] = (uint8_t)(random >> 40);
+                break;
+
+            case 2:     // Add or subtract a little
+                data[at] = (uint8_t)(data[at] + ((random >> 40) % 35) - 17);
+                break;
+
+            case 3:     // Write an interesting value, of 1, 2 or 4 bytes
+                len = (size_t)1 << ((random >> 40) % 3);
+                len = (len < size - at) ? len : size - at;
+                memcpy(data + at, &interesting[(random >> 44) % (sizeof(interesting) / sizeof(interesting[0]))], len);
+                break;
+
+            case 4:     // Insert random bytes
+                len = 1 + (size_t)((random >> 40) % 8);
+                len = (len < max_len - size) ? len : max_len - size;
+                memmove(data + at + len, data + at, size - at);
+
+                for (from = 0; from < len; from++) {
+                    data[at + from] = (uint8_t)_CUTL_RANDOM(_cutl_fuzz_rng);
+                }
+
+                size += len;
+                break;
+
+            case 5:     // Remove a range
+                len   = 1 + (size_t)((random >> 40) % 16);
+                len   = (len < size - at) ? len : size - at;
+                memmove(data + at, data + at + len, size - at - len);
+                size -= len;
+                break;
+
+            case 6:     // Copy a range over another one
+                from = (size_t)((random >> 40) % size);
+                len  = 1 + (size_t)(_CUTL_RANDOM(_cutl_fuzz_rng) % (size - ((from > at) ? from : at)));
+                memmove(data + at, data + from, len);
+                break;
+
+            case 7:     // Set an ASCII digit, which parsers are fond of
+                data[at] = (uint8_t)('0' + (random >> 40) % 10);
+                break;
+
+            case 8:     // Splice in a range of another input
+            case 9: {
+                const _cutl_fuzz_input_t *other = &_cutl_fuzz_corpus[(random >> 40) % _cutl_fuzz_n_corpus];
+
+                if (other->size == 0) {
+                    break;
+                }
+
+                from = (size_t)(_CUTL_RANDOM(_cutl_fuzz_rng) % other->size);
+                len  = 1 + (size_t)((random >> 48) % (other->size - from));
+                len  = (len < max_len - at) ? len : max_len - at;
+                memcpy(data + at, other->data + from, len);
+                size = (at + len > size) ? at + len : size;
+                break;
+            }
+        }
+    }
+
+    return size;
+}
+
+
+/**
+ * Writes an input to the corpus directory, named after its hash with a
+ * prefix, and leaves its path in path. Async-signal-safe, as it is also
+ * how inputs that crash are saved.
+ */
+bool _CUTL_FUZZ_SAVE(const char *prefix, const uint8_t *data, size_t size, char *path, size_t path_size) {
+    static const char hex[] = "0123456789abcdef";
+    uint64_t          hash  = 0xcbf29ce484222325ull;
+    size_t            used  = 0;
+    size_t            i;
+    int               fd;
+
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001b3ull;
+    }
+
+    for (i = 0; _cutl_fuzz_dir[i] != '\0' && used < path_size; i++) {
+        path[used++] = _cutl_fuzz_dir[i];
+    }
+
+    if (used < path_size) {
+        path[used++] = '/';
+    }
+
+    for (i = 0; prefix[i] != '\0' && used < path_size; i++) {
+        path[used++] = prefix[i];
+    }
+
+    for (i = 0; i < 16 && used < path_size; i++) {
+        path[used++] = hex[(hash >> (60 - 4 * i)) & 15];
+    }
+
+    if (used >= path_size) {
+        return false;
+    }
+
+    path[used] = '\0';
+
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if (fd < 0) {
+        return false;
+    }
+
+    for (i = 0; i < size; ) {
+        ssize_t n = write(fd, data + i, size - i);
+
+        if (n <= 0) {
+            break;
+        }
+
+        i += (size_t)n;
+    }
+
+    close(fd);
+
+    return i == size;
+}
+
+
+/**
+ * Saves the input that crashed the target as a reproducer, and dies of
+ * the same signal
+ */
+void _CUTL_FUZZ_CRASH(int signal) {
+    char             path[sizeof(_cutl_fuzz_dir) + 32];
+    struct sigaction action;
+
+    if (_cutl_fuzz_input != NULL) {
+        _CUTL_REPORT_INFO("%s l:%d (%s) crashed with signal %d on %s/%s", _cutl_current_file,
+            _cutl_current_line, _cutl_current_func, signal, _cutl_fuzz_dir, _cutl_fuzz_input);
+    }
+    else if (_CUTL_FUZZ_SAVE("crash-", _cutl_fuzz_data, _cutl_fuzz_size, path, sizeof(path))) {
+        _CUTL_REPORT_INFO("%s l:%d (%s) crashed with signal %d, input saved to %s", _cutl_current_file,
+            _cutl_current_line, _cutl_current_func, signal, path);
+    }
+
+    _CUTL_REPORT_FLUSH();
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+
+    raise(signal);
+}
+
+
+/**
+ * Adds a copy of an input to the corpus held in memory, with the name of
+ * its file if it was read from one
+ */
+static bool _cutl_fuzz_add(const uint8_t *data, size_t size, const char *name) {
+    size_t   len = (name != NULL) ? strlen(name) + 1 : 0;
+    uint8_t *copy;
+
+    _cutl_alloc_paused++;
+
+    if (_cutl_fuzz_n_corpus == _cutl_fuzz_capacity) {
+        size_t              capacity = (_cutl_fuzz_capacity > 0) ? 2 * _cutl_fuzz_capacity : 64;
+        _cutl_fuzz_input_t *corpus   = (_cutl_fuzz_input_t *)realloc(_cutl_fuzz_corpus,
+                                            capacity * sizeof(_cutl_fuzz_input_t));
+
+        if (corpus == NULL) {
+            _cutl_alloc_paused--;
+            return false;
+        }
+
+        _cutl_fuzz_corpus   = corpus;
+        _cutl_fuzz_capacity = capacity;
+    }
+
+    copy = (uint8_t *)malloc(size + len + 1);
+    _cutl_alloc_paused--;
+
+    if (copy == NULL) {
+        return false;
+    }
+
+    if (size > 0) {
+        memcpy(copy, data, size);
+    }
+
+    if (name != NULL) {
+        memcpy(copy + size, name, len);
+    }
+
+    _cutl_fuzz_corpus[_cutl_fuzz_n_corpus].data = copy;
+    _cutl_fuzz_corpus[_cutl_fuzz_n_corpus].size = size;
+    _cutl_fuzz_corpus[_cutl_fuzz_n_corpus].name = (name != NULL) ? (const char *)copy + size : NULL;
+    _cutl_fuzz_n_corpus++;
+
+    return true;
+}
+
+
+/**
+ * Reads the files of the corpus directory into memory, in the order of
+ * their names. Returns false if the directory cannot be read.
+ */
+bool _CUTL_FUZZ_LOAD(void) {
+    struct dirent **entries;
+    int             n = scandir(_cutl_fuzz_dir, &entries, NULL, alphasort);
+    int             i;
+
+    if (n < 0) {
+        return false;
+    }
+
+    for (i = 0; i < n; i++) {
+        char  path[sizeof(_cutl_fuzz_dir) + 256];
+        FILE *file = NULL;
+        long  size;
+
+        if (entries[i]->d_name[0] != '.'
+                && (size_t)snprintf(path, sizeof(path), "%s/%s", _cutl_fuzz_dir, entries[i]->d_name) < sizeof(path)) {
+            file = fopen(path, "rb");
+        }
+
+        if (file != NULL && fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0) {
+            uint8_t *data;
+
+            _cutl_alloc_paused++;
+            data = (uint8_t *)malloc((size_t)size + 1);
+            _cutl_alloc_paused--;
+
+            fseek(file, 0, SEEK_SET);
+
+            if (data != NULL && fread(data, 1, (size_t)size, file) == (size_t)size) {
+                _cutl_fuzz_add(data, (size_t)size, entries[i]->d_name);
+            }
+
+            _cutl_alloc_paused++;
+            free(data);
+            _cutl_alloc_paused--;
+        }
+
+        if (file != NULL) {
+            fclose(file);
+        }
+
+        free(entries[i]);
+    }
+
+    free(entries);
+
+    return true;
+}
+
+
+/**
+ * Frees the corpus held in memory
+ */
+void _CUTL_FUZZ_FREE(void) {
+    size_t i;
+
+    _cutl_alloc_paused++;
+
+    for (i = 0; i < _cutl_fuzz_n_corpus; i++) {
+        free(_cutl_fuzz_corpus[i].data);
+    }
+
+    free(_cutl_fuzz_corpus);
+    _cutl_alloc_paused--;
+
+    _cutl_fuzz_corpus   = NULL;
+    _cutl_fuzz_n_corpus = 0;
+    _cutl_fuzz_capacity = 0;
+}
+
+
+/**
+ * Runs a fuzz target on every input of its corpus directory, found as case
+ * files are. With --fuzz, it then mutates them for as long as it was told,
+ * adding those that take new paths to the directory, until one fails.
+ * Failing inputs are saved there too, so that later runs replay them.
+ */
+__CUTL_NO_COVERAGE void _CUTL_FUZZ(void (*func)(const uint8_t *, size_t), const char *dir) {
+    static const int signals[] = { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+    struct sigaction action, previous[sizeof(signals) / sizeof(signals[0])];
+    char             path[sizeof(_cutl_fuzz_dir) + 32];
+    char             msg[_CUTL_MAX_LEN_MSG];
+    struct stat      info;
+    uint8_t         *data = NULL;
+    uint64_t         runs = 0, start, deadline;
+    uint64_t         seed = _cutl_property_seed;
+    size_t           edges = 0, n_loaded, i;
+    bool             failed = false;
+
+    if (strlen(dir) >= sizeof(_cutl_fuzz_dir)) {
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Corpus directory path too long");
+        return;
+    }
+
+    strcpy(_cutl_fuzz_dir, dir);
+
+    if (stat(_cutl_fuzz_dir, &info) != 0
+            && !(_CUTL_SOURCE_PATH(dir, _cutl_fuzz_dir, sizeof(_cutl_fuzz_dir)) && stat(_cutl_fuzz_dir, &info) == 0)) {
+        strcpy(_cutl_fuzz_dir, dir);
+
+        // An empty corpus has nothing to replay, but something to fuzz
+        if (!_cutl_fuzz) {
+            return;
+        }
+
+        if (mkdir(_cutl_fuzz_dir, 0755) != 0) {
+            snprintf(msg, sizeof(msg), "Could not create the corpus directory %s", dir);
+            _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, msg);
+            return;
+        }
+    }
+
+    if (!_CUTL_FUZZ_LOAD()) {
+        snprintf(msg, sizeof(msg), "Could not read the corpus directory %s", dir);
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, msg);
+        _CUTL_FUZZ_FREE();
+        return;
+    }
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = _CUTL_FUZZ_CRASH;
+    sigemptyset(&action.sa_mask);
+
+    for (i = 0; i < sizeof(signals) / sizeof(signals[0]); i++) {
+        sigaction(signals[i], &action, &previous[i]);
+    }
+
+    memset(_cutl_fuzz_map, 0, sizeof(_cutl_fuzz_map));
+    memset(_cutl_fuzz_seen, 0, sizeof(_cutl_fuzz_seen));
+
+    for (i = 0; i < 4; i++) {
+        _cutl_fuzz_rng[i] = _CUTL_SPLITMIX(&seed);
+    }
+
+    // Every input of the corpus is a case, named after its file. Replaying
+    // stops at the first one that fails.
+    for (i = 0; i < _cutl_fuzz_n_corpus && !failed; i++) {
+        _cutl_fuzz_input = _cutl_fuzz_corpus[i].name;
+        failed = _CUTL_FUZZ_RUN(func, _cutl_fuzz_corpus[i].data, _cutl_fuzz_corpus[i].size);
+        _cutl_fuzz_input = NULL;
+
+        if (_cutl_fuzz) {
+            _CUTL_FUZZ_COVERAGE(&edges);
+        }
+
+        _cutl_cases_stats.total++;
+        _cutl_cases_stats.failed += failed;
+    }
+
+    if (_cutl_fuzz && !failed) {
+        _cutl_alloc_paused++;
+        data = (uint8_t *)malloc(_cutl_fuzz_max_len + 1);
+        _cutl_alloc_paused--;
+
+        // Mutations start from nothing with an empty corpus
+        if (data != NULL && _cutl_fuzz_n_corpus == 0 && _cutl_fuzz_add(NULL, 0, NULL)) {
+            failed = _CUTL_FUZZ_RUN(func, data, 0);
+            _CUTL_FUZZ_COVERAGE(&edges);
+        }
+    }
+
+    n_loaded = _cutl_fuzz_n_corpus;
+
+    start    = _CUTL_NOW_NS();
+    deadline = start + (uint64_t)_cutl_fuzz_time * 1000000000u;
+
+    while (data != NULL && !failed && (_cutl_fuzz_runs == 0 || runs < _cutl_fuzz_runs)) {
+        const _cutl_fuzz_input_t *input = &_cutl_fuzz_corpus[_CUTL_RANDOM(_cutl_fuzz_rng) % _cutl_fuzz_n_corpus];
+        size_t                    size  = (input->size < _cutl_fuzz_max_len) ? input->size : _cutl_fuzz_max_len;
+
+        if (_cutl_fuzz_time > 0 && (runs & 1023) == 0 && _CUTL_NOW_NS() >= deadline) {
+            break;
+        }
+
+        memcpy(data, input->data, size);
+        size = _CUTL_FUZZ_MUTATE(data, size, _cutl_fuzz_max_len);
+
+        failed = _CUTL_FUZZ_RUN(func, data, size);
+        runs++;
+
+        if (_CUTL_FUZZ_COVERAGE(&edges) && !failed && _cutl_fuzz_add(data, size, NULL)) {
+            _CUTL_FUZZ_SAVE("", data, size, path, sizeof(path));
+        }
+    }
+
+    // Replayed inputs were saved already
+    if (failed && data != NULL) {
+        char  *failure = _cutl_context.failure_msg;
+        size_t used    = strlen(failure);
+
+        if (_CUTL_FUZZ_SAVE("crash-", data, _cutl_fuzz_size, path, sizeof(path))) {
+            snprintf(failure + used, _CUTL_MAX_LEN_MSG - used, "\n\t  input of %zu bytes saved to %s",
+                _cutl_fuzz_size, path);
+        }
+    }
+
+    if (_cutl_fuzz) {
+        double seconds = (double)(_CUTL_NOW_NS() - start) / 1e9;
+
+        _CUTL_REPORT_INFO("Fuzzed %s: %llu runs in %.1f s (%.0f/s), %zu edges, %zu new inputs in %s",
+            _cutl_current_func, (unsigned long long)runs, seconds, (seconds > 0) ? (double)runs / seconds : 0.0,
+            edges, _cutl_fuzz_n_corpus - n_loaded, _cutl_fuzz_dir);
+    }
+
+    for (i = 0; i < sizeof(signals) / sizeof(signals[0]); i++) {
+        sigaction(signals[i], &previous[i], NULL);
+    }
+
+    _cutl_alloc_paused++;
+    free(data);
+    _cutl_alloc_paused--;
+
+    _CUTL_FUZZ_FREE();
+}
+
+#else
+
+void _CUTL_FUZZ(void (*func)(const uint8_t *, size_t), const char *dir) {
+    (void)func;
+    (void)dir;
+
+    _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Fuzz targets are only available on POSIX systems");
+}
+
+#endif /* _CUTL_POSIX */
+
+
+
+// ==========================================================================
+// BENCHMARKS
+// ==========================================================================
+
+
+/**
+ * Ends the batch of iterations that was running, if any, and decides how
+ * many iterations the next one has. Returns false once the benchmark is
+ * over, either because all samples were taken or because a test failure
+ * was registered.
+ */
+bool _CUTL_BENCH_NEXT(uint64_t *iterations) {
+    uint64_t now     = _CUTL_NOW_NS();
+    uint64_t target  = (uint64_t)_cutl_bench_sample_ms * 1000000u;
+    uint64_t elapsed = now - _cutl_bench_started;
+
+    if (_cutl_bench_phase == _CUTL_BENCH_SAMPLE && _cutl_perf_open != 0) {
+        _cutl_perf_reading_t end[_CUTL_N_PERF];
+
+        _CUTL_PERF_READ(end);
+        _CUTL_PERF_ADD(&_cutl_perf_bench, _cutl_perf_bench_mark, end);
+    }
+
+    if (__atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE) != _CUTL_SUCCESS) {
+        return false;
+    }
+
+    // What the benchmarked function takes from the arena lasts one batch
+    if (_cutl_bench_phase == _CUTL_BENCH_IDLE) {
+        _CUTL_ARENA_MARK(&_cutl_bench_arena);
+    }
+    else {
+        _CUTL_ARENA_RELEASE(&_cutl_bench_arena);
+    }
+
+    switch (_cutl_bench_phase) {
+        case _CUTL_BENCH_IDLE:
+            _cutl_bench_phase = _CUTL_BENCH_CALIBRATE;
+            _cutl_bench_stats.iterations = 1;
+
+            break;
+
+        case _CUTL_BENCH_CALIBRATE:
+            if (elapsed < target) {
+                // Aim at the target with some margin, growing at most 100x
+                // at a time in case the first batches were too short to tell
+                uint64_t n = _cutl_bench_stats.iterations;
+                uint64_t next = (elapsed > 0) ? (uint64_t)((double)n * target * 1.2 / elapsed) : n * 100;
+
+                if (next > n * 100) next = n * 100;
+                if (next <= n)      next = n + 1;
+
+                _cutl_bench_stats.iterations = next;
+                break;
+            }
+
+            _cutl_bench_phase = _CUTL_BENCH_WARMUP;
+            _cutl_bench_done  = 0;
+
+            break;
+
+        case _CUTL_BENCH_WARMUP:
+            if (++_cutl_bench_done < (_cutl_bench_samples + 9) / 10) {
+                break;
+            }
+
+            if (_cutl_bench_times == NULL) {
+                _cutl_alloc_paused++;
+                _cutl_bench_times = malloc(_cutl_bench_samples * sizeof(double));
+                _cutl_alloc_paused--;
+
+                if (_cutl_bench_times == NULL) {
+                    _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not allocate benchmark samples");
+                    return false;
+                }
+            }
+
+            _cutl_bench_phase = _CUTL_BENCH_SAMPLE;
+            _cutl_bench_done  = 0;
+
+            break;
+
+        case _CUTL_BENCH_SAMPLE:
+            _cutl_bench_times[_cutl_bench_done++] = (double)elapsed / _cutl_bench_stats.iterations;
+
+            if (_cutl_bench_done == _cutl_bench_samples) {
+                _cutl_alloc_paused++;
+                _CUTL_BENCH_STATS();
+                _cutl_alloc_paused--;
+                return false;
+            }
+
+            break;
+
+        default:
+            return false;
+    }
+
+    *iterations = _cutl_bench_stats.iterations;
+
+    // Only samples are counted, calibration and warmup are left out
+    if (_cutl_bench_phase == _CUTL_BENCH_SAMPLE && _cutl_perf_open != 0) {
+        _CUTL_PERF_READ(_cutl_perf_bench_mark);
+    }
+
+    _cutl_bench_started = _CUTL_NOW_NS();
+
+    return true;
+}
+
+
+/**
+ * Comparison function for qsort
+ */
+static int _cutl_compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+
+/**
+ * Computes the statistics of the samples taken by a benchmark
+ */
+void _CUTL_BENCH_STATS(void) {
+    unsigned int n = _cutl_bench_samples;
+    unsigned int i;
+    double       sum = 0, sum_sq = 0;
+
+    qsort(_cutl_bench_times, n, sizeof(double), _cutl_compare_doubles);
+
+    for (i = 0; i < n; i++) {
+        sum += _cutl_bench_times[i];
+    }
+
+    _cutl_bench_stats.mean_ns = sum / n;
+
+    for (i = 0; i < n; i++) {
+        double d = _cutl_bench_times[i] - _cutl_bench_stats.mean_ns;
+        sum_sq += d * d;
+    }
+
+    // Square root by Newton's method. Only macros and fabs(), which is
+    // inlined, are taken from <math.h>, so programs need not link libm.
+    _cutl_bench_stats.stddev_ns = (n > 1) ? sum_sq / (n - 1) : 0;
+
+    if (_cutl_bench_stats.stddev_ns > 0) {
+        double variance = _cutl_bench_stats.stddev_ns;
+        double root     = variance;
+
+        for (i = 0; i < 64; i++) {
+            root = (root + variance / root) / 2;
+        }
+
+        _cutl_bench_stats.stddev_ns = root;
+    }
+
+    _cutl_bench_stats.samples   = n;
+    _cutl_bench_stats.min_ns    = _cutl_bench_times[0];
+    _cutl_bench_stats.median_ns = (n % 2) ? _cutl_bench_times[n / 2]
+                                          : (_cutl_bench_times[n / 2 - 1] + _cutl_bench_times[n / 2]) / 2;
+    _cutl_bench_stats.p99_ns    = _cutl_bench_times[(n * 99 + 99) / 100 - 1];
+
+    // The samples are no longer needed, so they are reused to find the
+    // median of the deviations
+    for (i = 0; i < n; i++) {
+        double d = _cutl_bench_times[i] - _cutl_bench_stats.median_ns;
+        _cutl_bench_times[i] = (d < 0) ? -d : d;
+    }
+
+    qsort(_cutl_bench_times, n, sizeof(double), _cutl_compare_doubles);
+
+    _cutl_bench_stats.mad_ns = 1.4826 * ((n % 2) ? _cutl_bench_times[n / 2]
+                                                 : (_cutl_bench_times[n / 2 - 1] + _cutl_bench_times[n / 2]) / 2);
+}
+
+
+
+// ==========================================================================
+// STRESS TESTS
+// ==========================================================================
+
+
+/**
+ * Runs a stress test: every thread calls the function the given number of
+ * iterations, all of them starting at once. With sweep, it is run once per
+ * number of threads up to the given one, to see how it scales.
+ */
+void _CUTL_STRESS(void (*func)(void *), unsigned int threads, uint64_t iterations, bool sweep, void *arg) {
+    _cutl_alloc_paused++;
+    _CUTL_STRESS_RUN(func, threads, iterations, sweep, arg);
+    _cutl_alloc_paused--;
+}
+
+
+/**
+ * Runs the rounds of a stress test. Allocations of the thread running the
+ * tests are paused meanwhile, but not those of the threads it starts.
+ */
+void _CUTL_STRESS_RUN(void (*func)(void *), unsigned int threads, uint64_t iterations, bool sweep, void *arg) {
+    unsigned int           counts[_CUTL_MAX_STRESS_ROUNDS];
+    unsigned int           n_rounds = 0;
+    unsigned int           r, t;
+    _cutl_stress_thread_t *data;
+    int                   *cpus;
+    int                    n_cpus;
+
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    // Sweeps with many threads go in powers of two
+    if (!sweep) {
+        counts[n_rounds++] = threads;
+    }
+    else if (threads <= _CUTL_MAX_STRESS_ROUNDS) {
+        for (t = 1; t <= threads; t++) {
+            counts[n_rounds++] = t;
+        }
+    }
+    else {
+        for (t = 1; t < threads && n_rounds < _CUTL_MAX_STRESS_ROUNDS - 1; t *= 2) {
+            counts[n_rounds++] = t;
+        }
+
+        counts[n_rounds++] = threads;
+    }
+
+    data = (_cutl_stress_thread_t *)malloc(threads * sizeof(*data));
+    cpus = (int *)malloc(threads * sizeof(*cpus));
+
+    if (data == NULL || cpus == NULL) {
+        free(data);
+        free(cpus);
+        _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not allocate the stress test threads");
+        return;
+    }
+
+    n_cpus = _CUTL_STRESS_CPUS(cpus, (int)threads);
+
+    _cutl_stress_stats.iterations = iterations;
+
+    for (r = 0; r < n_rounds; r++) {
+        unsigned int n       = counts[r];
+        uint64_t     start   = UINT64_MAX;
+        uint64_t     end     = 0;
+        double       min_ops = 0, max_ops = 0;
+
+        for (t = 0; t < n; t++) {
+            data[t].func       = func;
+            data[t].arg        = arg;
+            data[t].iterations = iterations;
+            data[t].cpu        = (n_cpus > 0) ? cpus[t % n_cpus] : -1;
+            data[t].start_ns   = 0;
+            data[t].end_ns     = 0;
+        }
+
+#if _CUTL_POSIX
+        {
+            pthread_t   *ids = (pthread_t *)malloc(n * sizeof(pthread_t));
+            unsigned int started;
+
+            if (ids == NULL) {
+                _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not allocate the stress test threads");
+                break;
+            }
+
+            __atomic_store_n(&_cutl_stress_arrived, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&_cutl_stress_go, 0, __ATOMIC_RELAXED);
+
+            for (started = 0; started < n; started++) {
+                if (pthread_create(&ids[started], NULL, _CUTL_STRESS_THREAD, &data[started]) != 0) {
+                    _CUTL_REGISTER_TEST_ERROR(_cutl_current_line, "Could not start the stress test threads");
+                    break;
+                }
+            }
+
+            // Barrier: release the threads once all of them are ready
+            while (__atomic_load_n(&_cutl_stress_arrived, __ATOMIC_ACQUIRE) < (int)started) {
+                sched_yield();
+            }
+
+            __atomic_store_n(&_cutl_stress_go, 1, __ATOMIC_RELEASE);
+
+            for (t = 0; t < started; t++) {
+                pthread_join(ids[t], NULL);
+            }
+
+            free(ids);
+        }
+#else
+        for (t = 0; t < n; t++) {
+            _CUTL_STRESS_THREAD(&data[t]);
+        }
+#endif
+
+        if (__atomic_load_n(&_cutl_context.status, __ATOMIC_ACQUIRE) != _CUTL_SUCCESS) {
+            break;
+        }
+
+        for (t = 0; t < n; t++) {
+            uint64_t elapsed = data[t].end_ns - data[t].start_ns;
+            double   ops     = (elapsed > 0) ? iterations * 1e9 / elapsed : 0;
+
+            if (t == 0 || ops < min_ops) {
+                min_ops = ops;
+            }
+
+            if (t == 0 || ops > max_ops) {
+                max_ops = ops;
+            }
+
+            start = (data[t].start_ns < start) ? data[t].start_ns : start;
+            end   = (data[t].end_ns > end) ? data[t].end_ns : end;
+        }
+
+        _cutl_stress_stats.round[r].threads       = n;
+        _cutl_stress_stats.round[r].ops_per_s     = (end > start) ? (double)n * iterations * 1e9 / (end - start) : 0;
+        _cutl_stress_stats.round[r].min_ops_per_s = min_ops;
+        _cutl_stress_stats.round[r].max_ops_per_s = max_ops;
+        _cutl_stress_stats.rounds = r + 1;
+    }
+
+    free(data);
+    free(cpus);
+}
+
+
+/**
+ * Body of every thread of a stress test
+ */
+void *_CUTL_STRESS_THREAD(void *data) {
+    _cutl_stress_thread_t *thread = (_cutl_stress_thread_t *)data;
+    uint64_t               i;
+
+#if _CUTL_POSIX && defined(__linux__) && defined(SYS_sched_setaffinity)
+    if (thread->cpu >= 0) {
+        unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+
+        mask[thread->cpu / (8 * sizeof(unsigned long))] |= 1ul << (thread->cpu % (8 * sizeof(unsigned long)));
+
+        // The calling thread only, unlike sched_setaffinity() on other systems
+        syscall(SYS_sched_setaffinity, 0, sizeof(mask), mask);
+    }
+#endif
+
+#if _CUTL_POSIX
+    __atomic_fetch_add(&_cutl_stress_arrived, 1, __ATOMIC_ACQ_REL);
+
+    while (!__atomic_load_n(&_cutl_stress_go, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+#endif
+
+    thread->start_ns = _CUTL_NOW_NS();
+
+    for (i = 0; i < thread->iterations; i++) {
+        thread->func(thread->arg);
+
+        // Stop soon after a failure in any thread
+        if ((i & 1023) == 1023 && __atomic_load_n(&_cutl_context.status, __ATOMIC_RELAXED) != _CUTL_SUCCESS) {
+            break;
+        }
+    }
+
+    thread->end_ns = _CUTL_NOW_NS();
+
+    return NULL;
+}
+
+
+/**
+ * Gets the CPUs the process may run on, to pin the threads of stress tests
+ * to them. Returns how many were found, or 0 if threads cannot be pinned.
+ */
+int _CUTL_STRESS_CPUS(int *cpus, int max) {
+    int n = 0;
+
+#if _CUTL_POSIX && defined(__linux__) && defined(SYS_sched_getaffinity)
+    unsigned long mask[1024 / (8 * sizeof(unsigned long))] = { 0 };
+    long          size = syscall(SYS_sched_getaffinity, 0, sizeof(mask), mask);
+    int           cpu;
+
+    for (cpu = 0; size > 0 && cpu < (int)(8 * size) && n < max; cpu++) {
+        if (mask[cpu / (8 * sizeof(unsigned long))] & (1ul << (cpu % (8 * sizeof(unsigned long))))) {
+            cpus[n++] = cpu;
+        }
+    }
+#else
+    (void)cpus;
+    (void)max;
+#endif
+
+    return n;
+}
+
+
+/**
+ * Formats a rate per second with a unit prefix
+ */
+const char *_CUTL_FORMAT_RATE(double per_s, char *buffer, size_t size) {
+    if (per_s < 1e3) {
+        snprintf(buffer, size, "%.1f ", per_s);
+    }
+    else if (per_s < 1e6) {
+        snprintf(buffer, size, "%.2f k", per_s / 1e3);
+    }
+    else if (per_s < 1e9) {
+        snprintf(buffer, size, "%.2f M", per_s / 1e6);
+    }
+    else {
+        snprintf(buffer, size, "%.2f G", per_s / 1e9);
+    }
+
+    return buffer;
+}
+
+
+/**
+ * Reports the throughput of each round of a stress test, how far apart
+ * its threads were, and how it scaled compared with a single thread
+ */
+void _CUTL_REPORT_STRESS_STATS(const _cutl_result_t *result) {
+    uint32_t i;
+
+    for (i = 0; i < result->stress.rounds; i++) {
+        char   total[16], min[16], max[16], scaling[48] = "";
+        double spread = 0;
+
+        if (result->stress.round[i].max_ops_per_s > 0) {
+            spread = 100 * (1 - result->stress.round[i].min_ops_per_s / result->stress.round[i].max_ops_per_s);
+        }
+
+        if (i > 0 && result->stress.round[0].threads == 1 && result->stress.round[0].ops_per_s > 0) {
+            double speedup = result->stress.round[i].ops_per_s / result->stress.round[0].ops_per_s;
+
+            snprintf(scaling, sizeof(scaling), " | x%.2f vs 1 thread (%.0f%% efficiency)",
+                speedup, 100 * speedup / result->stress.round[i].threads);
+        }
+
+        _CUTL_REPORT_STRESS("%2u thread%s | %sops/s | per thread %sops/s - %sops/s (spread %.1f%%)%s",
+            (unsigned int)result->stress.round[i].threads, (result->stress.round[i].threads == 1) ? " " : "s",
+            _CUTL_FORMAT_RATE(result->stress.round[i].ops_per_s, total, sizeof(total)),
+            _CUTL_FORMAT_RATE(result->stress.round[i].min_ops_per_s, min, sizeof(min)),
+            _CUTL_FORMAT_RATE(result->stress.round[i].max_ops_per_s, max, sizeof(max)),
+            spread, scaling
+        );
+    }
+}
+
+
+
+// ==========================================================================
+// BENCHMARK BASELINES
+// ==========================================================================
+
+
+/**
+ * Writes the key of a benchmark in the baseline. Unlike _CUTL_TEST_KEY,
+ * it leaves out the line, and the call is only there from the second one.
+ */
+int _CUTL_BASELINE_KEY(char *buffer, size_t size, const _cutl_result_t *result) {
+    const char *args = (result->args != NULL) ? result->args : "";
+
+    return (result->call == 0) ? snprintf(buffer, size, "%s\t%s\t%s", result->file, result->func, args)
+                               : snprintf(buffer, size, "%s\t%s\t%s\t%u", result->file, result->func, args,
+                                          result->call);
+}
+
+
+/**
+ * Looks for the entry of a benchmark in the baseline, creating it if
+ * create is true
+ */
+_cutl_baseline_entry_t *_CUTL_BASELINE_ENTRY(const char *key, bool create) {
+    size_t i;
+    size_t len;
+
+    for (i = 0; i < _cutl_baseline_size; i++) {
+        if (strcmp(_cutl_baseline[i].key, key) == 0) {
+            return &_cutl_baseline[i];
+        }
+    }
+
+    if (!create) {
+        return NULL;
+    }
+
+    if (_cutl_baseline_size == _cutl_baseline_capacity) {
+        size_t                  capacity = _cutl_baseline_capacity ? 2 * _cutl_baseline_capacity : 16;
+        _cutl_baseline_entry_t *entries  = realloc(_cutl_baseline, capacity * sizeof(*entries));
+
+        if (entries == NULL) {
+            return NULL;
+        }
+
+        _cutl_baseline          = entries;
+        _cutl_baseline_capacity = capacity;
+    }
+
+    len = strlen(key) + 1;
+
+    _cutl_baseline[_cutl_baseline_size].key = malloc(len);
+
+    if (_cutl_baseline[_cutl_baseline_size].key == NULL) {
+        return NULL;
+    }
+
+    memcpy(_cutl_baseline[_cutl_baseline_size].key, key, len);
+    _cutl_baseline[_cutl_baseline_size].samples = 0;
+
+    return &_cutl_baseline[_cutl_baseline_size++];
+}
+
+
+/**
+ * Reads the baseline file, if there is one
+ */
+void _CUTL_BASELINE_LOAD(void) {
+    const char *update = getenv("CUTL_BASELINE_UPDATE");
+    char        line[2 * _CUTL_MAX_LEN_MSG];
+    FILE       *file;
+
+    _cutl_baseline_loaded = true;
+    _cutl_baseline_update = (update != NULL && strcmp(update, "1") == 0);
+
+    if (getenv("CUTL_BASELINE") != NULL) {
+        _cutl_baseline_path = getenv("CUTL_BASELINE");
+    }
+
+    if (_cutl_baseline_path == NULL || (file = fopen(_cutl_baseline_path, "r")) == NULL) {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        _cutl_baseline_entry_t *entry;
+        unsigned long           samples;
+        double                  median, mad;
+        char                   *key = line;
+        int                     fields;
+
+        if (line[0] == '#') {
+            continue;
+        }
+
+        line[strcspn(line, "\n")] = '\0';
+
+        // The key is whatever follows the third tab
+        for (fields = 0; fields < 3 && key != NULL; fields++) {
+            key = strchr(key, '\t');
+            key = (key != NULL) ? key + 1 : NULL;
+        }
+
+        if (key == NULL || sscanf(line, "%lu\t%lf\t%lf", &samples, &median, &mad) != 3) {
+            continue;
+        }
+
+        entry = _CUTL_BASELINE_ENTRY(key, true);
+
+        if (entry != NULL) {
+            entry->samples   = (uint32_t)samples;
+            entry->median_ns = median;
+            entry->mad_ns    = mad;
+        }
+    }
+
+    fclose(file);
+}
+
+
+/**
+ * Compares a benchmark against its baseline, turning it into a failure if
+ * it got slower. A note with the comparison is written for the report.
+ */
+void _CUTL_BASELINE_CHECK(_cutl_result_t *result, char *note, size_t size) {
+    _cutl_baseline_entry_t *entry;
+    char                    key[2 * _CUTL_MAX_LEN_MSG];
+    double                  change, noise;
+
+    if (!_cutl_baseline_loaded) {
+        _CUTL_BASELINE_LOAD();
+    }
+
+    if (_cutl_baseline_path == NULL) {
+        return;
+    }
+
+    _CUTL_BASELINE_KEY(key, sizeof(key), result);
+
+    entry = _CUTL_BASELINE_ENTRY(key, _cutl_baseline_update);
+
+    // Not a failure, but it must not look like one that was checked
+    if (entry == NULL) {
+        snprintf(note, size, " | missing from baseline");
+        return;
+    }
+
+    if (entry->samples == 0) {
+        snprintf(note, size, " | new in baseline");
+    }
+    else {
+        change = (result->bench.median_ns - entry->median_ns) / entry->median_ns;
+
+        // Variance of the difference between both medians. The standard
+        // error of a median is about 1.2533 sigma / sqrt(n), and sigma is
+        // estimated from the MAD, which outliers barely move.
+        noise = 1.5708 * (result->bench.mad_ns * result->bench.mad_ns / result->bench.samples
+                          + entry->mad_ns * entry->mad_ns / entry->samples);
+
+        snprintf(note, size, " | %+.1f%% vs baseline", 100 * change);
+
+        if (!_cutl_baseline_update && change > _cutl_baseline_tolerance
+                && (result->bench.median_ns - entry->median_ns) * (result->bench.median_ns - entry->median_ns)
+                    > _cutl_baseline_sigmas * _cutl_baseline_sigmas * noise) {
+            char baseline[16], median[16];
+
+            result->status       = _CUTL_FAILURE;
+            result->failure_line = result->line;
+
+            snprintf(result->failure_msg, _CUTL_MAX_LEN_MSG,
+                "Performance regression: median %s/op vs %s/op in baseline (%+.1f%%, tolerance %.1f%%)",
+                _CUTL_FORMAT_DURATION(result->bench.median_ns, median, sizeof(median)),
+                _CUTL_FORMAT_DURATION(entry->median_ns, baseline, sizeof(baseline)),
+                100 * change, 100 * _cutl_baseline_tolerance
+            );
+        }
+    }
+
+    if (_cutl_baseline_update) {
+        entry->samples   = result->bench.samples;
+        entry->median_ns = result->bench.median_ns;
+        entry->mad_ns    = result->bench.mad_ns;
+
+        _cutl_baseline_changed = true;
+    }
+}
+
+
+/**
+ * Rewrites the baseline file when updating it, and releases the baseline
+ */
+void _CUTL_BASELINE_SAVE(void) {
+    size_t i;
+
+    if (_cutl_baseline_update && _cutl_baseline_changed) {
+        char  tmp_path[FILENAME_MAX];
+        FILE *file;
+
+        // Write to a temporary file first, so the baseline is never left
+        // half written
+        snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", _cutl_baseline_path);
+
+        if ((file = fopen(tmp_path, "w")) != NULL) {
+            fprintf(file, _CUTL_BASELINE_HEADER "\n");
+
+            for (i = 0; i < _cutl_baseline_size; i++) {
+                if (_cutl_baseline[i].samples > 0) {
+                    fprintf(file, "%u\t%.17g\t%.17g\t%s\n", (unsigned int)_cutl_baseline[i].samples,
+                        _cutl_baseline[i].median_ns, _cutl_baseline[i].mad_ns, _cutl_baseline[i].key);
+                }
+            }
+
+            if (fclose(file) == 0 && rename(tmp_path, _cutl_baseline_path) == 0) {
+                _CUTL_REPORT_INFO("Benchmark baseline written to %s", _cutl_baseline_path);
+            }
+            else {
+                _CUTL_REPORT_INFO("Could not write benchmark baseline to %s", _cutl_baseline_path);
+            }
+        }
+    }
+
+    for (i = 0; i < _cutl_baseline_size; i++) {
+        free(_cutl_baseline[i].key);
+    }
+
+    free(_cutl_baseline);
+
+    _cutl_baseline          = NULL;
+    _cutl_baseline_size     = 0;
+    _cutl_baseline_capacity = 0;
+    _cutl_baseline_loaded   = false;
+    _cutl_baseline_changed  = false;
+}
+
+
+
+// ==========================================================================
+// RESULT CACHE
+// ==========================================================================
+
+
+/**
+ * Hashes some bytes, eight at a time, going on from a previous hash.
+ * Not meant to resist collisions made on purpose.
+ */
+uint64_t _CUTL_HASH(const void *data, size_t size, uint64_t hash) {
+    const unsigned char *bytes = (const unsigned char *)data;
+    size_t               i     = 0;
+    uint64_t             word;
+
+    hash ^= 0xcbf29ce484222325ull ^ size;
+
+    for (; i + 8 <= size; i += 8) {
+        memcpy(&word, bytes + i, 8);
+        hash = (hash ^ word) * 0x100000001b3ull;
+        hash ^= hash >> 29;
+    }
+
+    for (; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+
+    return hash ^ (hash >> 32);
+}
+
+
+/**
+ * Hashes the file of the running program, which changes along with any
+ * of its code or data. Returns 0 if it cannot be read.
+ */
+uint64_t _CUTL_PROGRAM_HASH(void) {
+    uint64_t hash = 0;
+
+#if defined(__linux__)
+    const char *data;
+    size_t      size;
+    FILE       *file;
+
+    if ((file = fopen("/proc/self/exe", "rb")) != NULL) {
+        if ((data = _CUTL_MAP_FILE(file, &size)) != NULL) {
+            hash = _CUTL_HASH(data, size, 0) | 1;
+            _CUTL_UNMAP_FILE(data, size);
+        }
+
+        fclose(file);
+    }
+#endif
+
+    return hash;
+}
+
+
+#if _CUTL_POSIX
+
+/**
+ * Waits for a lock on the whole file, or releases it
+ */
+static bool _cutl_lock_file(int fd, short type) {
+    struct flock lock;
+
+    memset(&lock, 0, sizeof(lock));
+    lock.l_type   = type;
+    lock.l_whence = SEEK_SET;
+
+    while (fcntl(fd, F_SETLKW, &lock) != 0) {
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
+
+
+static int _cutl_cache_compare(const void *a, const void *b) {
+    uint64_t k1 = *(const uint64_t *)a;
+    uint64_t k2 = *(const uint64_t *)b;
+
+    return (k1 > k2) - (k1 < k2);
+}
+
+
+/**
+ * Works out what the tests depend on and reads the keys of the cache
+ * file, if the cache is enabled
+ */
+void _CUTL_CACHE_SETUP(void) {
+    const char *data;
+    size_t      size, i;
+    FILE       *file;
+
+    if (getenv("CUTL_CACHE") != NULL) {
+        _cutl_cache_path = getenv("CUTL_CACHE");
+    }
+
+    if (_cutl_cache_path == NULL || *_cutl_cache_path == '\0') {
+        _cutl_cache_path = NULL;
+        return;
+    }
+
+    // Any change to the program, be it code or data, changes its file
+    if (_cutl_cache_deps == 0) {
+        _cutl_cache_deps = _CUTL_PROGRAM_HASH();
+
+        if (_cutl_cache_deps == 0) {
+            _CUTL_REPORT_INFO("Could not hash the test program, results are not cached without deps (see cutl_config_cache)");
+            _cutl_cache_path = NULL;
+            return;
+        }
+    }
+
+    if ((file = fopen(_cutl_cache_path, "rb")) == NULL) {
+        return;
+    }
+
+#if _CUTL_POSIX
+    _cutl_lock_file(fileno(file), F_RDLCK);
+#endif
+
+    data = _CUTL_MAP_FILE(file, &size);
+
+    if (data != NULL) {
+        _cutl_alloc_paused++;
+        _cutl_cache_keys = malloc((size / _CUTL_CACHE_LINE + 1) * sizeof(uint64_t));
+        _cutl_alloc_paused--;
+
+        // Lines that are not keys, such as the header, are skipped
+        for (i = 0; _cutl_cache_keys != NULL && i + _CUTL_CACHE_LINE <= size; ) {
+            const char *end = memchr(data + i, '\n', size - i);
+            uint64_t    key = 0;
+            size_t      j;
+
+            if (end == NULL) {
+                break;
+            }
+
+            for (j = i; j < (size_t)(end - data); j++) {
+                char c     = (char)(data[j] | 0x20);
+                int  digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+
+                if (digit < 0) {
+                    break;
+                }
+
+                key = (key << 4) | (uint64_t)digit;
+            }
+
+            if (j == i + _CUTL_CACHE_LINE - 1 && data + j == end) {
+                _cutl_cache_keys[_cutl_cache_n_keys++] = key;
+            }
+
+            i = (size_t)(end - data) + 1;
+        }
+
+        _CUTL_UNMAP_FILE(data, size);
+    }
+
+    fclose(file);
+
+    if (_cutl_cache_n_keys > 0) {
+        qsort(_cutl_cache_keys, _cutl_cache_n_keys, sizeof(uint64_t), _cutl_cache_compare);
+    }
+}
+
+
+/**
+ * Returns the hash of the key of a test, or 0 if its result is not to be
+ * cached
+ */
+uint64_t _CUTL_CACHE_KEY(const char *key, const char *tags) {
+    uint64_t hash;
+
+    if (_cutl_cache_path == NULL || (tags != NULL && _CUTL_LIST_MATCH(_CUTL_CACHE_UNCACHED, tags, false))) {
+        return 0;
+    }
+
+    hash = _CUTL_HASH(key, strlen(key) + 1, _cutl_cache_deps);
+
+    return (hash != 0) ? hash : 1;
+}
+
+
+/**
+ * Returns whether a test with the given key passed before
+ */
+bool _CUTL_CACHE_HIT(uint64_t key) {
+    return key != 0 && _cutl_cache_n_keys > 0
+        && bsearch(&key, _cutl_cache_keys, _cutl_cache_n_keys, sizeof(uint64_t), _cutl_cache_compare) != NULL;
+}
+
+
+/**
+ * Appends a key to a growing list of them
+ */
+static void _cutl_cache_push(uint64_t **keys, size_t *n, size_t *capacity, uint64_t key) {
+    if (*n == *capacity) {
+        size_t    grown = (*capacity > 0) ? 2 * *capacity : 64;
+        uint64_t *moved;
+
+        _cutl_alloc_paused++;
+        moved = realloc(*keys, grown * sizeof(uint64_t));
+        _cutl_alloc_paused--;
+
+        if (moved == NULL) {
+            return;
+        }
+
+        *keys     = moved;
+        *capacity = grown;
+    }
+
+    (*keys)[(*n)++] = key;
+}
+
+
+/**
+ * Counts a reported result, keeping the key of the test as passed or
+ * failed in this run
+ */
+void _CUTL_CACHE_ADD(const _cutl_result_t *result) {
+    if (result->cached) {
+        _cutl_n_tests_cached++;
+        return;
+    }
+
+    if (result->cache_key == 0) {
+        return;
+    }
+
+    if (result->status == _CUTL_SUCCESS) {
+        _cutl_cache_push(&_cutl_cache_new, &_cutl_cache_n_new, &_cutl_cache_capacity, result->cache_key);
+    }
+    else {
+        _cutl_cache_push(&_cutl_cache_failed, &_cutl_cache_n_failed, &_cutl_cache_failed_capacity,
+            result->cache_key);
+    }
+}
+
+
+/**
+ * Appends the keys of the tests passed to the cache file, holding a lock
+ * on it. Once it has too many, the oldest half is dropped.
+ */
+bool _CUTL_CACHE_WRITE(void) {
+    static const char hex[] = "0123456789abcdef";
+    size_t            header = sizeof(_CUTL_CACHE_HEADER) - 1;
+    char             *text;
+    size_t            i, j;
+    bool              written = false;
+
+    _cutl_alloc_paused++;
+    text = malloc(_cutl_cache_n_new * _CUTL_CACHE_LINE);
+    _cutl_alloc_paused--;
+
+    if (text == NULL) {
+        return false;
+    }
+
+    for (i = 0; i < _cutl_cache_n_new; i++) {
+        for (j = 0; j < 16; j++) {
+            text[i * _CUTL_CACHE_LINE + j] = hex[(_cutl_cache_new[i] >> (60 - 4 * j)) & 15];
+        }
+
+        text[i * _CUTL_CACHE_LINE + 16] = '\n';
+    }
+
+#if _CUTL_POSIX
+    {
+        int   fd = open(_cutl_cache_path, O_RDWR | O_CREAT, 0644);
+        off_t size;
+
+        if (fd >= 0 && _cutl_lock_file(fd, F_WRLCK) && (size = lseek(fd, 0, SEEK_END)) >= 0) {
+            size_t n_keys = ((size_t)size > header) ? ((size_t)size - header) / _CUTL_CACHE_LINE : 0;
+            size_t n_kept = _CUTL_CACHE_MAX_KEYS / 2;
+
+            written = true;
+
+            if (size == 0) {
+                written = (write(fd, _CUTL_CACHE_HEADER, header) == (ssize_t)header);
+            }
+            else if (n_keys + _cutl_cache_n_new > _CUTL_CACHE_MAX_KEYS && n_keys > n_kept) {
+                char *kept;
+
+                _cutl_alloc_paused++;
+                kept = malloc(n_kept * _CUTL_CACHE_LINE);
+                _cutl_alloc_paused--;
+
+                written = kept != NULL
+                    && pread(fd, kept, n_kept * _CUTL_CACHE_LINE, size - (off_t)(n_kept * _CUTL_CACHE_LINE))
+                        == (ssize_t)(n_kept * _CUTL_CACHE_LINE)
+                    && ftruncate(fd, 0) == 0
+                    && pwrite(fd, _CUTL_CACHE_HEADER, header, 0) == (ssize_t)header
+                    && pwrite(fd, kept, n_kept * _CUTL_CACHE_LINE, (off_t)header) == (ssize_t)(n_kept * _CUTL_CACHE_LINE)
+                    && lseek(fd, 0, SEEK_END) >= 0;
+
+                _cutl_alloc_paused++;
+                free(kept);
+                _cutl_alloc_paused--;
+            }
+
+            written = written && write(fd, text, _cutl_cache_n_new * _CUTL_CACHE_LINE)
+                                 == (ssize_t)(_cutl_cache_n_new * _CUTL_CACHE_LINE);
+        }
+
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+#else
+    {
+        FILE *file = fopen(_cutl_cache_path, "ab");
+
+        if (file != NULL) {
+            if (ftell(file) == 0) {
+                fwrite(_CUTL_CACHE_HEADER, 1, header, file);
+            }
+
+            written = (fwrite(text, _CUTL_CACHE_LINE, _cutl_cache_n_new, file) == _cutl_cache_n_new);
+            written = (fclose(file) == 0) && written;
+        }
+    }
+#endif
+
+    _cutl_alloc_paused++;
+    free(text);
+    _cutl_alloc_paused--;
+
+    return written;
+}
+
+
+/**
+ * Adds the tests passed to the cache file and releases the cache
+ */
+void _CUTL_CACHE_SAVE(void) {
+    size_t i, n_kept = 0;
+
+    if (_cutl_cache_path == NULL) {
+        return;
+    }
+
+    // A key that failed anywhere in the run is not trusted to pass
+    if (_cutl_cache_n_failed > 0) {
+        qsort(_cutl_cache_failed, _cutl_cache_n_failed, sizeof(uint64_t), _cutl_cache_compare);
+
+        for (i = 0; i < _cutl_cache_n_new; i++) {
+            if (bsearch(&_cutl_cache_new[i], _cutl_cache_failed, _cutl_cache_n_failed, sizeof(uint64_t),
+                        _cutl_cache_compare) == NULL) {
+                _cutl_cache_new[n_kept++] = _cutl_cache_new[i];
+            }
+        }
+
+        _cutl_cache_n_new = n_kept;
+    }
+
+    if (_cutl_cache_n_new > 0 && !_CUTL_CACHE_WRITE()) {
+        _CUTL_REPORT_INFO("Could not write the result cache %s", _cutl_cache_path);
+    }
+
+    _CUTL_REPORT_INFO("Cached passes: %u (not run), %zu passes added to %s",
+        _cutl_n_tests_cached, _cutl_cache_n_new, _cutl_cache_path);
+
+    _cutl_alloc_paused++;
+    free(_cutl_cache_keys);
+    free(_cutl_cache_new);
+    free(_cutl_cache_failed);
+    _cutl_alloc_paused--;
+
+    _cutl_cache_keys     = NULL;
+    _cutl_cache_new      = NULL;
+    _cutl_cache_failed   = NULL;
+    _cutl_cache_n_keys   = 0;
+    _cutl_cache_n_new    = 0;
+    _cutl_cache_n_failed = 0;
+    _cutl_cache_capacity = 0;
+    _cutl_cache_failed_capacity = 0;
+    _cutl_n_tests_cached = 0;
+}
+
+
+
+// ==========================================================================
+// SHARDING
+// ==========================================================================
+
+
+static int _cutl_timing_compare_key(const void *a, const void *b) {
+    return strcmp(((const _cutl_timing_entry_t *)a)->key, ((const _cutl_timing_entry_t *)b)->key);
+}
+
+
+static int _cutl_timing_compare_order(const void *a, const void *b) {
+    const _cutl_timing_entry_t *e1 = (const _cutl_timing_entry_t *)a;
+    const _cutl_timing_entry_t *e2 = (const _cutl_timing_entry_t *)b;
+    int                         cmp = strcmp(e1->key, e2->key);
+
+    return (cmp != 0) ? cmp : (e1->order > e2->order) - (e1->order < e2->order);
+}
+
+
+static int _cutl_timing_compare_ns(const void *a, const void *b) {
+    const _cutl_timing_entry_t *e1 = *(const _cutl_timing_entry_t *const *)a;
+    const _cutl_timing_entry_t *e2 = *(const _cutl_timing_entry_t *const *)b;
+
+    if (e1->ns != e2->ns) {
+        return (e1->ns < e2->ns) ? 1 : -1;
+    }
+
+    return strcmp(e1->key, e2->key);
+}
+
+
+/**
+ * Reads the shard to run and, if there is a timings file, assigns the
+ * tests in it to the shards: from the longest to the shortest, each one
+ * goes to the shard with the least time so far
+ */
+void _CUTL_SHARD_SETUP(void) {
+    _cutl_timing_entry_t **by_ns;
+    uint64_t              *loads;
+    char                   line[2 * _CUTL_MAX_LEN_MSG];
+    FILE                  *file;
+    size_t                 capacity = 0, i, n;
+    unsigned int           s;
+
+    if (_cutl_timings_path != NULL || getenv("CUTL_TIMINGS") != NULL) {
+        _cutl_measure = true;
+    }
+
+    if (_cutl_shard_loaded) {
+        return;
+    }
+
+    _cutl_shard_loaded = true;
+
+    if (getenv("CUTL_SHARD_INDEX") != NULL) {
+        _cutl_shard_index = (unsigned int)strtoul(getenv("CUTL_SHARD_INDEX"), NULL, 10);
+    }
+
+    if (getenv("CUTL_SHARD_COUNT") != NULL) {
+        _cutl_shard_count = (unsigned int)strtoul(getenv("CUTL_SHARD_COUNT"), NULL, 10);
+    }
+
+    if (getenv("CUTL_TIMINGS") != NULL) {
+        _cutl_timings_path = getenv("CUTL_TIMINGS");
+    }
+
+    if (_cutl_shard_count > 1 && _cutl_shard_index >= _cutl_shard_count) {
+        _CUTL_REPORT_ERROR("Shard index %u out of range, there are %u shards", _cutl_shard_index, _cutl_shard_count);
+        _CUTL_REPORT_FLUSH();
+        exit(EXIT_FAILURE);
+    }
+
+    if (_cutl_timings_path == NULL || (file = fopen(_cutl_timings_path, "r")) == NULL) {
+        return;
+    }
+
+#if _CUTL_POSIX
+    _cutl_lock_file(fileno(file), F_RDLCK);
+#endif
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        char    *key;
+        uint64_t ns = strtoull(line, &key, 10);
+
+        if (line[0] == '#' || *key != '\t') {
+            continue;
+        }
+
+        key[strcspn(key, "\n")] = '\0';
+
+        if (_cutl_timings_size == capacity) {
+            _cutl_timing_entry_t *entries;
+
+            capacity = (capacity > 0) ? 2 * capacity : 64;
+            entries  = realloc(_cutl_timings, capacity * sizeof(*entries));
+
+            if (entries == NULL) {
+                break;
+            }
+
+            _cutl_timings = entries;
+        }
+
+        if ((_cutl_timings[_cutl_timings_size].key = malloc(strlen(key + 1) + 1)) == NULL) {
+            break;
+        }
+
+        strcpy(_cutl_timings[_cutl_timings_size].key, key + 1);
+        _cutl_timings[_cutl_timings_size].ns    = ns;
+        _cutl_timings[_cutl_timings_size].order = _cutl_timings_size;
+        _cutl_timings[_cutl_timings_size].shard = 0;
+        _cutl_timings_size++;
+    }
+
+    fclose(file);
+
+    if (_cutl_timings_size == 0) {
+        return;
+    }
+
+    // Files of several shards may be put together, so a test may be there
+    // more than once
+    qsort(_cutl_timings, _cutl_timings_size, sizeof(*_cutl_timings), _cutl_timing_compare_order);
+
+    for (i = 0, n = 0; i < _cutl_timings_size; i++) {
+        if (i + 1 < _cutl_timings_size && strcmp(_cutl_timings[i].key, _cutl_timings[i + 1].key) == 0) {
+            free(_cutl_timings[i].key);
+        }
+        else {
+            _cutl_timings[n++] = _cutl_timings[i];
+        }
+    }
+
+    _cutl_timings_size = n;
+
+    if (_cutl_shard_count <= 1) {
+        return;
+    }
+
+    by_ns = malloc(_cutl_timings_size * sizeof(*by_ns));
+    loads = calloc(_cutl_shard_count, sizeof(*loads));
+
+    if (by_ns != NULL && loads != NULL) {
+        for (i = 0; i < _cutl_timings_size; i++) {
+            by_ns[i] = &_cutl_timings[i];
+        }
+
+        qsort(by_ns, _cutl_timings_size, sizeof(*by_ns), _cutl_timing_compare_ns);
+
+        for (i = 0; i < _cutl_timings_size; i++) {
+            unsigned int least = 0;
+
+            for (s = 1; s < _cutl_shard_count; s++) {
+                if (loads[s] < loads[least]) {
+                    least = s;
+                }
+            }
+
+            by_ns[i]->shard = least;
+            loads[least]   += by_ns[i]->ns;
+        }
+    }
+    else {
+        // Without the timings, tests are spread by their hash
+        for (i = 0; i < _cutl_timings_size; i++) {
+            free(_cutl_timings[i].key);
+        }
+
+        free(_cutl_timings);
+        _cutl_timings      = NULL;
+        _cutl_timings_size = 0;
+    }
+
+    free(by_ns);
+    free(loads);
+}
+
+
+/**
+ * Returns whether a test belongs to the shard being run
+ */
+bool _CUTL_SHARD_MINE(const char *key) {
+    _cutl_timing_entry_t  probe;
+    _cutl_timing_entry_t *entry;
+
+    if (!_cutl_shard_loaded) {
+        _CUTL_SHARD_SETUP();
+    }
+
+    if (_cutl_shard_count <= 1) {
+        return true;
+    }
+
+    probe.key = (char *)key;
+
+    // Tests new to the timings file are spread by their hash
+    entry = (_cutl_timings_size > 0)
+        ? bsearch(&probe, _cutl_timings, _cutl_timings_size, sizeof(*_cutl_timings), _cutl_timing_compare_key)
+        : NULL;
+
+    if (entry == NULL) {
+        return _CUTL_HASH(key, strlen(key), 0) % _cutl_shard_count == _cutl_shard_index;
+    }
+
+    return entry->shard == _cutl_shard_index;
+}
+
+
+/**
+ * Keeps how long a test that has just run took, if keeping timings
+ */
+void _CUTL_TIMINGS_ADD(const _cutl_result_t *result) {
+    char    key[2 * _CUTL_MAX_LEN_MSG];
+    char   *copy;
+    int     len;
+
+    if (_cutl_timings_path == NULL || result->cached || result->skipped) {
+        return;
+    }
+
+    len = _CUTL_TEST_KEY(key, sizeof(key), result->file, result->line, result->func, result->args, result->call);
+
+    if (len < 0 || (size_t)len >= sizeof(key)) {
+        return;
+    }
+
+    _cutl_alloc_paused++;
+
+    if (_cutl_timings_n_new == _cutl_timings_capacity) {
+        size_t                capacity = (_cutl_timings_capacity > 0) ? 2 * _cutl_timings_capacity : 64;
+        _cutl_timing_entry_t *entries  = realloc(_cutl_timings_new, capacity * sizeof(*entries));
+
+        if (entries != NULL) {
+            _cutl_timings_new      = entries;
+            _cutl_timings_capacity = capacity;
+        }
+    }
+
+    copy = (_cutl_timings_n_new < _cutl_timings_capacity) ? malloc((size_t)len + 1) : NULL;
+
+    _cutl_alloc_paused--;
+
+    if (copy == NULL) {
+        return;
+    }
+
+    memcpy(copy, key, (size_t)len + 1);
+
+    _cutl_timings_new[_cutl_timings_n_new].key   = copy;
+    _cutl_timings_new[_cutl_timings_n_new].ns    = result->timing.setup_ns + result->timing.wall_ns
+                                                 + result->timing.teardown_ns;
+    _cutl_timings_new[_cutl_timings_n_new].order = _cutl_timings_n_new;
+    _cutl_timings_n_new++;
+}
+
+
+/**
+ * Merges the timings of this run into the timings file, holding a lock on
+ * it. Shards write theirs to <file>.<index> instead, or the shards yet to
+ * start would not make the same assignment.
+ */
+bool _CUTL_TIMINGS_WRITE(void) {
+    const char *data = NULL;
+    char        path[FILENAME_MAX];
+    char       *text;
+    size_t      size = 0, capacity, used, i;
+    FILE       *file;
+    bool        written;
+
+    if (_cutl_shard_count > 1) {
+        snprintf(path, sizeof(path), "%s.%u", _cutl_timings_path, _cutl_shard_index);
+    }
+    else {
+        snprintf(path, sizeof(path), "%s", _cutl_timings_path);
+    }
+
+#if _CUTL_POSIX
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+
+    if (fd < 0 || (file = fdopen(fd, "r+b")) == NULL) {
+        if (fd >= 0) {
+            close(fd);
+        }
+
+        return false;
+    }
+
+    _cutl_lock_file(fd, F_WRLCK);
+#else
+    if ((file = fopen(path, "rb")) == NULL && (file = fopen(path, "w+b")) == NULL) {
+        return false;
+    }
+#endif
+
+    data = _CUTL_MAP_FILE(file, &size);
+
+    capacity = size + sizeof(_CUTL_TIMINGS_HEADER);
+
+    for (i = 0; i < _cutl_timings_n_new; i++) {
+        capacity += strlen(_cutl_timings_new[i].key) + 24;
+    }
+
+    qsort(_cutl_timings_new, _cutl_timings_n_new, sizeof(*_cutl_timings_new), _cutl_timing_compare_order);
+
+    _cutl_alloc_paused++;
+    text = malloc(capacity);
+    _cutl_alloc_paused--;
+
+    if (text != NULL) {
+        used = (size_t)sprintf(text, "%s", _CUTL_TIMINGS_HEADER);
+
+        // The lines of the tests that did not run this time are kept
+        for (i = 0; data != NULL && i < size; ) {
+            const char          *end = memchr(data + i, '\n', size - i);
+            size_t               len = (end != NULL) ? (size_t)(end - (data + i)) : size - i;
+            const char          *tab = memchr(data + i, '\t', len);
+            _cutl_timing_entry_t probe;
+            char                 key[2 * _CUTL_MAX_LEN_MSG];
+
+            if (data[i] != '#' && tab != NULL && (size_t)(data + i + len - tab) <= sizeof(key)) {
+                memcpy(key, tab + 1, (size_t)(data + i + len - tab) - 1);
+                key[data + i + len - tab - 1] = '\0';
+
+                probe.key = key;
+
+                if (bsearch(&probe, _cutl_timings_new, _cutl_timings_n_new, sizeof(*_cutl_timings_new),
+                        _cutl_timing_compare_key) == NULL) {
+                    memcpy(text + used, data + i, len);
+                    used += len;
+                    text[used++] = '\n';
+                }
+            }
+
+            i += len + 1;
+        }
+
+        for (i = 0; i < _cutl_timings_n_new; i++) {
+            used += (size_t)sprintf(text + used, "%llu\t%s\n",
+                (unsigned long long)_cutl_timings_new[i].ns, _cutl_timings_new[i].key);
+        }
+    }
+
+    _CUTL_UNMAP_FILE(data, size);
+
+#if _CUTL_POSIX
+    written = text != NULL && pwrite(fd, text, used, 0) == (ssize_t)used && ftruncate(fd, (off_t)used) == 0;
+    written = (fclose(file) == 0) && written;
+#else
+    fclose(file);
+    written = text != NULL && (file = fopen(path, "wb")) != NULL;
+    written = written && fwrite(text, 1, used, file) == used;
+    written = (file == NULL || fclose(file) == 0) && written;
+#endif
+
+    _cutl_alloc_paused++;
+    free(text);
+    _cutl_alloc_paused--;
+
+    return written;
+}
+
+
+/**
+ * Writes the timings of the run and releases those of the shards
+ */
+void _CUTL_TIMINGS_SAVE(void) {
+    size_t i;
+
+    if (_cutl_shard_count > 1) {
+        _CUTL_REPORT_INFO("Shard %u of %u, tests spread %s", _cutl_shard_index, _cutl_shard_count,
+            (_cutl_timings_size > 0) ? "by their timings" : "by hash");
+    }
+
+    if (_cutl_timings_path != NULL && _cutl_timings_n_new > 0 && !_CUTL_TIMINGS_WRITE()) {
+        _CUTL_REPORT_INFO("Could not write the timings to %s", _cutl_timings_path);
+    }
+
+    for (i = 0; i < _cutl_timings_size; i++) {
+        free(_cutl_timings[i].key);
+    }
+
+    _cutl_alloc_paused++;
+
+    for (i = 0; i < _cutl_timings_n_new; i++) {
+        free(_cutl_timings_new[i].key);
+    }
+
+    free(_cutl_timings_new);
+
+    _cutl_alloc_paused--;
+
+    free(_cutl_timings);
+
+    _cutl_timings          = NULL;
+    _cutl_timings_size     = 0;
+    _cutl_timings_new      = NULL;
+    _cutl_timings_n_new    = 0;
+    _cutl_timings_capacity = 0;
+    _cutl_shard_loaded     = false;
+}
+
+
+
+// ==========================================================================
+// TEST REGISTRATION AND SELECTION
+// ==========================================================================
+
+
+/**
+ * Appends a suite to those seen so far
+ */
+static void _cutl_suite_add(_cutl_suite_t *suite, const char *file) {
+    suite->file = file;
+    suite->next = NULL;
+
+    if (_cutl_suites_tail != NULL) {
+        _cutl_suites_tail->next = suite;
+    }
+    else {
+        _cutl_suites = suite;
+    }
+
+    _cutl_suites_tail = suite;
+}
+
+
+/**
+ * Adds a test to the registry, keeping the tests of each file sorted by
+ * line in case the constructors do not run in definition order
+ */
+void _CUTL_REGISTER_TEST(_cutl_test_desc_t *test) {
+    _cutl_test_desc_t **link = &_cutl_registry;
+
+    // The first test of a file brings its suite along
+    if (test->suite->file == NULL) {
+        _cutl_suite_add(test->suite, test->file);
+    }
+
+    if (_cutl_registry_tail != NULL && !(strcmp(_cutl_registry_tail->file, test->file) == 0
+            && _cutl_registry_tail->line > test->line)) {
+        link = &_cutl_registry_tail->next;
+    }
+
+    while (*link != NULL && !(strcmp((*link)->file, test->file) == 0 && (*link)->line > test->line)) {
+        link = &(*link)->next;
+    }
+
+    test->next = *link;
+    *link = test;
+
+    if (test->next == NULL) {
+        _cutl_registry_tail = test;
+    }
+
+    _cutl_registry_size++;
+}
+
+
+/**
+ * Matches a string against a glob pattern ending at pattern_end. Supports
+ * '*' (any sequence of characters) and '?' (any single character).
+ */
+bool _CUTL_GLOB_MATCH(const char *pattern, const char *pattern_end, const char *str) {
+    const char *star_pattern = NULL;
+    const char *star_str     = NULL;
+
+    while (*str != '\0') {
+        if (pattern < pattern_end && (*pattern == '?' || *pattern == *str)) {
+            pattern++;
+            str++;
+        }
+        else if (pattern < pattern_end && *pattern == '*') {
+            star_pattern = ++pattern;
+            star_str     = str;
+        }
+        else if (star_pattern != NULL) {
+            pattern = star_pattern;
+            str     = ++star_str;
+        }
+        else {
+            return false;
+        }
+    }
+
+    while (pattern < pattern_end && *pattern == '*') {
+        pattern++;
+    }
+
+    return pattern == pattern_end;
+}
+
+
+/**
+ * Checks a comma separated list of patterns against the comma separated
+ * words in tags. Patterns prefixed with '-' exclude the words they match.
+ * With no positive patterns in the list, every word is included. Words
+ * are compared with _CUTL_GLOB_MATCH if globs is true, or verbatim
+ * otherwise.
+ */
+bool _CUTL_LIST_MATCH(const char *list, const char *tags, bool globs) {
+    bool any_positive = false;
+    bool included     = false;
+
+    while (*list != '\0') {
+        const char *end;
+        const char *word = tags;
+        bool        negative;
+
+        while (*list == ',' || *list == ' ') {
+            list++;
+        }
+
+        negative = (*list == '-');
+        list += negative;
+
+        for (end = list; *end != '\0' && *end != ','; end++) {}
+
+        if (end == list) {
+            continue;
+        }
+
+        any_positive |= !negative;
+
+        // Look for any word in tags that matches this pattern
+        while (word != NULL && *word != '\0') {
+            char        buffer[_CUTL_MAX_LEN_FUNC_NAME];
+            size_t      len;
+
+            while (*word == ',' || *word == ' ') {
+                word++;
+            }
+
+            for (len = 0; word[len] != '\0' && word[len] != ',' && word[len] != ' '; len++) {}
+
+            if (len > 0 && len < sizeof(buffer)) {
+                bool match;
+
+                memcpy(buffer, word, len);
+                buffer[len] = '\0';
+
+                if (globs) {
+                    match = _CUTL_GLOB_MATCH(list, end, buffer);
+                }
+                else {
+                    match = ((size_t)(end - list) == len && memcmp(list, word, len) == 0);
+                }
+
+                if (match && negative) {
+                    return false;
+                }
+
+                included |= match;
+            }
+
+            word += len;
+        }
+
+        list = end;
+    }
+
+    return included || !any_positive;
+}
+
+
+/**
+ * Decides whether a test has to run according to the selected names and
+ * tags. Tests without tags (e.g. those called with CUTL_TEST_FUNCTION)
+ * are left out whenever some tags are selected.
+ */
+bool _CUTL_TEST_SELECTED(const char *func, const char *tags) {
+    if (_cutl_filter != NULL && !_CUTL_LIST_MATCH(_cutl_filter, func, true)) {
+        return false;
+    }
+
+    if (_cutl_tags != NULL && !_CUTL_LIST_MATCH(_cutl_tags, (tags != NULL) ? tags : "", false)) {
+        return false;
+    }
+
+    // Only fuzz targets run when fuzzing
+    if (_cutl_fuzz && !_CUTL_LIST_MATCH("fuzz", (tags != NULL) ? tags : "", false)) {
+        return false;
+    }
+
+    return true;
+}
+
+
+/**
+ * Returns whether a registered test is to run in this shard, being run by
+ * CUTL_RUN_REGISTERED
+ */
+static bool _cutl_registered_selected(const _cutl_test_desc_t *test) {
+    char key[2 * _CUTL_MAX_LEN_MSG];
+
+    if (!_CUTL_TEST_SELECTED(test->name, test->tags)) {
+        return false;
+    }
+
+    _CUTL_TEST_KEY(key, sizeof(key), test->file, test->line, test->name, "", 0);
+
+    return _CUTL_SHARD_MINE(key);
+}
+
+
+/**
+ * Parses the command line options understood by CutL and ignores the
+ * rest, so it can be called with the arguments of main() as they are:
+ *
+ *   --filter=GLOBS : Run only tests whose name matches any of the comma
+ *         separated globs. Globs prefixed with '-' exclude tests instead.
+ *         Same as the CUTL_FILTER environment variable.
+ *
+ *   --tags=TAGS : Run only tests having any of the comma separated tags.
+ *         Tags prefixed with '-' exclude tests instead. Same as the
+ *         CUTL_TAGS environment variable.
+ *
+ *   --list : Print the selected registered tests and exit.
+ *
+ *   --fuzz[=SECONDS] : Fuzz the selected CUTL_FUZZ targets, only them, for
+ *         60 seconds each by default, or until they fail (0: no limit).
+ *         Same as the CUTL_FUZZ environment variable.
+ *
+ *   --fuzz-runs=N : Stop fuzzing a target after N runs.
+ *
+ *   --fuzz-max-len=BYTES : Longest input made when fuzzing (4096).
+ *
+ *   --cache=FILE : Do not run again the tests that passed in previous runs
+ *         with the same cache file, while the program does not change (see
+ *         cutl_config_cache). Same as the CUTL_CACHE environment variable.
+ *
+ *   --shard=INDEX/COUNT : Run only one of COUNT shards of the tests, from
+ *         0 to COUNT - 1 (see cutl_config_shard). Same as the
+ *         CUTL_SHARD_INDEX and CUTL_SHARD_COUNT environment variables.
+ *
+ *   --timings=FILE : Keep the durations of the tests in FILE, and spread
+ *         them over the shards by them. Same as the CUTL_TIMINGS
+ *         environment variable.
+ *
+ *   --update-snapshots : Rewrite the golden files of the snapshots that do
+ *         not match, instead of failing. Same as setting the
+ *         CUTL_SNAPSHOT_UPDATE environment variable to 1.
+ *
+ *   --coordinator[=ADDRESS] : Hand the tests out to the workers that
+ *         connect at ADDRESS, "HOST:PORT" or "unix:PATH" (default:
+ *         127.0.0.1:7357), and report their results, instead of running
+ *         them (see cutl_config_remote). Same as the CUTL_COORDINATOR
+ *         environment variable.
+ *
+ *   --worker=ADDRESS : Run the tests handed out by the coordinator at
+ *         ADDRESS. Same as the CUTL_WORKER environment variable.
+ */
+__CUTL_UNUSED void cutl_args(int argc, char **argv) {
+    bool list = false;
+    int  i;
+
+    if (getenv("CUTL_FILTER") != NULL) {
+        _cutl_filter = getenv("CUTL_FILTER");
+    }
+
+    if (getenv("CUTL_TAGS") != NULL) {
+        _cutl_tags = getenv("CUTL_TAGS");
+    }
+
+    if (getenv("CUTL_FUZZ") != NULL) {
+        _cutl_fuzz      = true;
+        _cutl_fuzz_time = (unsigned int)strtoul(getenv("CUTL_FUZZ"), NULL, 10);
+    }
+
+    if (getenv("CUTL_SNAPSHOT_UPDATE") != NULL) {
+        _cutl_snapshot_update = (strcmp(getenv("CUTL_SNAPSHOT_UPDATE"), "1") == 0);
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--filter=", 9) == 0) {
+            _cutl_filter = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--tags=", 7) == 0) {
+            _cutl_tags = argv[i] + 7;
+        }
+        else if (strcmp(argv[i], "--list") == 0) {
+            list = true;
+        }
+        else if (strcmp(argv[i], "--fuzz") == 0) {
+            _cutl_fuzz      = true;
+            _cutl_fuzz_time = _CUTL_FUZZ_TIME;
+        }
+        else if (strncmp(argv[i], "--fuzz=", 7) == 0) {
+            _cutl_fuzz      = true;
+            _cutl_fuzz_time = (unsigned int)strtoul(argv[i] + 7, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--fuzz-runs=", 12) == 0) {
+            _cutl_fuzz_runs = strtoull(argv[i] + 12, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--fuzz-max-len=", 15) == 0) {
+            _cutl_fuzz_max_len = (size_t)strtoull(argv[i] + 15, NULL, 10);
+        }
+        else if (strncmp(argv[i], "--cache=", 8) == 0) {
+            _cutl_cache_path = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--shard=", 8) == 0) {
+            char *count;
+
+            _cutl_shard_index  = (unsigned int)strtoul(argv[i] + 8, &count, 10);
+            _cutl_shard_count  = (*count == '/') ? (unsigned int)strtoul(count + 1, NULL, 10) : 0;
+            _cutl_shard_loaded = false;
+        }
+        else if (strncmp(argv[i], "--timings=", 10) == 0) {
+            _cutl_timings_path = argv[i] + 10;
+            _cutl_shard_loaded = false;
+        }
+        else if (strcmp(argv[i], "--update-snapshots") == 0) {
+            _cutl_snapshot_update = true;
+        }
+        else if (strcmp(argv[i], "--coordinator") == 0) {
+            _cutl_remote_role    = CUTL_REMOTE_COORDINATOR;
+            _cutl_remote_address = NULL;
+        }
+        else if (strncmp(argv[i], "--coordinator=", 14) == 0) {
+            _cutl_remote_role    = CUTL_REMOTE_COORDINATOR;
+            _cutl_remote_address = argv[i] + 14;
+        }
+        else if (strncmp(argv[i], "--worker=", 9) == 0) {
+            _cutl_remote_role    = CUTL_REMOTE_WORKER;
+            _cutl_remote_address = argv[i] + 9;
+        }
+    }
+
+    if (list) {
+        const _cutl_test_desc_t *test;
+        unsigned int             n_selected = 0;
+
+        for (test = _cutl_registry; test != NULL; test = test->next) {
+            if (_cutl_registered_selected(test)) {
+                printf("%s:%d %s [%s]\n", test->file, test->line, test->name, test->tags);
+                n_selected++;
+            }
+        }
+
+        printf("%u / %u tests selected\n", n_selected, _cutl_registry_size);
+        exit(EXIT_SUCCESS);
+    }
+}
+
+
+// ==========================================================================
+// SUITES
+// ==========================================================================
+
+
+/**
+ * Returns the suite of a file, which is made if it has none yet. Returns
+ * NULL if it cannot be made.
+ */
+_cutl_suite_t *_CUTL_SUITE_OF(const char *file) {
+    static _cutl_suite_t *last = NULL;
+    _cutl_suite_t        *suite;
+
+    // Results mostly come in runs from the same file
+    if (last != NULL && (last->file == file || strcmp(last->file, file) == 0)) {
+        return last;
+    }
+
+    for (suite = _cutl_suites; suite != NULL; suite = suite->next) {
+        if (suite->file == file || strcmp(suite->file, file) == 0) {
+            return last = suite;
+        }
+    }
+
+    _cutl_alloc_paused++;
+    suite = calloc(1, sizeof(*suite));
+    _cutl_alloc_paused--;
+
+    if (suite != NULL) {
+        _cutl_suite_add(suite, file);
+        last = suite;
+    }
+
+    return suite;
+}
+
+
+/**
+ * Runs the CUTL_BEFORE_ALL of the suite of a registered test, which is the
+ * first of its file, unless this process runs none of the tests of the
+ * file. That of the runner file was run by CUTL_BEGIN_TEST.
+ */
+void _CUTL_SUITE_START(const _cutl_test_desc_t *first, const char *runner) {
+    const _cutl_test_desc_t *test;
+
+    if (strcmp(first->file, runner) == 0) {
+        return;
+    }
+
+    // The coordinator and the main process of the pool only collect results
+    if (_cutl_remote_role == CUTL_REMOTE_COORDINATOR || (_cutl_pool != NULL && _cutl_worker_id < 0)) {
+        return;
+    }
+
+    for (test = first; test != NULL && test->suite == first->suite; test = test->next) {
+        if (_cutl_registered_selected(test)) {
+            first->suite->started = true;
+            first->suite->before_all();
+            return;
+        }
+    }
+}
+
+
+/**
+ * Runs the CUTL_AFTER_ALL of a suite, if its CUTL_BEFORE_ALL was run
+ */
+void _CUTL_SUITE_END(_cutl_suite_t *suite) {
+    if (suite != NULL && suite->started) {
+        suite->started = false;
+        suite->after_all();
+    }
+}
+
+
+/**
+ * Reports how many tests passed in each file, when they come from more
+ * than one
+ */
+void _CUTL_REPORT_SUITE_SUMMARY(void) {
+    const _cutl_suite_t *suite;
+    unsigned int         n_files = 0;
+
+    for (suite = _cutl_suites; suite != NULL; suite = suite->next) {
+        n_files += (suite->n_passed + suite->n_failed > 0);
+    }
+
+    if (n_files < 2) {
+        return;
+    }
+
+    for (suite = _cutl_suites; suite != NULL; suite = suite->next) {
+        if (suite->n_passed + suite->n_failed > 0) {
+            _CUTL_REPORT_INFO("Tests passed in %s: %u / %u (%s)", suite->file, suite->n_passed,
+                suite->n_passed + suite->n_failed, (suite->n_failed > 0) ? "ERR" : "OK");
+        }
+    }
+}
+
+#endif /* _CUTL_IMPLEMENT */
+
+
+
+// Setup errors
+
+#define _REPORT_GLOB_SETUP_ERROR(file, line, func, msg, ...) \
+    do { \
+        _CUTL_REPORT_ERROR("%s l:%d (%s)\n\tError during global setup: " msg, file, line, func, ##__VA_ARGS__); \
+        _CUTL_REPORT_FLUSH(); \
+        fflush(NULL); \
+        abort(); \
+    } while (0)
+
+
+#define _REPORT_FUNC_SETUP_ERROR(file, line, func, msg, ...) \
+    do { \
+        _CUTL_REPORT_ERROR("%s l:%d (%s)\n\tError during funtion setup: " msg, file, line, func, ##__VA_ARGS__); \
+        _CUTL_REPORT_FLUSH(); \
+        fflush(NULL); \
+        abort(); \
+    } while (0)
+
+
+
+
+// ==========================================================================
+// MACROS FOR TESTING
+// ==========================================================================
+
+
+/**
+ * Begins the testing mode
+ */
+#define CUTL_BEGIN_TEST() \
+    do { \
+        /* Set report file */                   \
+        if (_cutl_report_file == NULL) {        \
+            _CUTL_REPORT_OPEN();                \
+        }                                       \
+                                                \
+        /* Begin testing */                     \
+        _cutl_current_file = __FILE__;          \
+        _cutl_n_tests_passed = 0;               \
+        _cutl_n_tests_failed = 0;               \
+        _cutl_n_tests_skipped = 0;              \
+        _cutl_n_cases_passed = 0;               \
+        _cutl_n_cases_failed = 0;               \
+        _cutl_test_index = 0;                   \
+        _cutl_run_start = _CUTL_NOW_NS();       \
+        _CUTL_TIMEOUT_SETUP();                  \
+                                                \
+        _CUTL_REPORT_INFO("Testing " __FILE__); \
+        _CUTL_REMOTE_START();                   \
+        _CUTL_OUTPUT_OPEN(__FILE__);            \
+        _CUTL_PERF_SETUP();                     \
+        _CUTL_PROPERTY_SETUP();                 \
+        _CUTL_CACHE_SETUP();                    \
+        _CUTL_SHARD_SETUP();                    \
+                                                \
+        CUTL_BEFORE_ALL();                      \
+                                                \
+        _CUTL_POOL_START();                     \
+    } while (0)
+
+
+
+/**
+ * Ends the testing mode
+ */
+#define CUTL_END_TEST() \
+    do { \
+        char _cutl_skipped[32]; \
+        \
+        _CUTL_REMOTE_END(); \
+        _CUTL_POOL_END(); \
+        CUTL_AFTER_ALL(); \
+        _CUTL_REMOTE_EXIT(); \
+        _CUTL_BASELINE_SAVE(); \
+        _CUTL_CACHE_SAVE(); \
+        _CUTL_TIMINGS_SAVE(); \
+        _CUTL_OUTPUT_CLOSE(__FILE__); \
+        _CUTL_REPORT_TIMING_SUMMARY(); \
+        _CUTL_REPORT_TIMEOUT_SUMMARY(); \
+        _CUTL_REPORT_CASES_SUMMARY(); \
+        _CUTL_REPORT_SUITE_SUMMARY(); \
+        _CUTL_REPORT_INFO( \
+            "Tests passed: %u / %u (%s)%s", \
+            _cutl_n_tests_passed, \
+            _cutl_n_tests_passed + _cutl_n_tests_failed + _cutl_n_tests_skipped, \
+            cutl_failed() ? "ERR" : "OK", \
+            _CUTL_FORMAT_SKIPPED(_cutl_skipped, sizeof(_cutl_skipped)) \
+        ); \
+        _CUTL_REPORT_FLUSH(); \
+    } while (0)
+
+
+
+/**
+ * Tests a function and reports its result. The function must not
+ * return void, but can receive any amount of params.
+ * 
+ * If a failure ocurrs while the function is being executed, it will
+ * be reported and the executing function will be aborted.
+ * 
+ * If an error ocurrs while the function is being executed, it will
+ * be reported and the program will be aborted.
+ *
+ * The result is reported once CUTL_AFTER_EACH has run. In parallel mode,
+ * the test may run in a worker process or not at all in this one.
+ */
+#define CUTL_TEST_FUNCTION(func, ...) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #__VA_ARGS__, NULL, __LINE__, func(__VA_ARGS__)); \
+    } while (0)
+
+
+/**
+ * Benchmarks a function, which receives the given params. The function is
+ * called in batches of iterations, calibrated so that each batch lasts
+ * the time set with cutl_config_bench(). After a few warmup batches, the
+ * time per call of each batch is taken as a sample. Once all samples are
+ * taken, their min, median, mean, standard deviation and 99th percentile
+ * are reported.
+ *
+ * A benchmark counts as a test: it fails if an assertion inside the
+ * function fails, which ends the benchmark. Benchmarks are tagged with
+ * "bench", so they can be selected or skipped with --tags.
+ */
+#define CUTL_BENCH(func, ...) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #__VA_ARGS__, "bench", __LINE__, { \
+            uint64_t _cutl_iterations; \
+            \
+            while (_CUTL_BENCH_NEXT(&_cutl_iterations)) { \
+                for (; _cutl_iterations > 0 && !__atomic_load_n(&_cutl_context.claimed, __ATOMIC_RELAXED); \
+                     _cutl_iterations--) { \
+                    func(__VA_ARGS__); \
+                } \
+            } \
+        }); \
+    } while (0)
+
+
+
+/**
+ * Stress-tests a function from several threads at once. The function takes
+ * a single pointer, which is the optional last param of the macro:
+ *
+ *     static void push_pop(void *stack) { ... }
+ *
+ *     CUTL_STRESS(push_pop, 8, 100000, &stack);
+ *
+ * Every thread is pinned to a CPU, waits at a barrier for the others and
+ * then calls the function the given number of iterations. The throughput
+ * of all threads together is reported, along with that of the slowest and
+ * fastest thread. Use THREAD_ASSERT* inside the function: a failure ends
+ * its thread and makes the others stop soon after.
+ *
+ * Stress tests are tagged with "stress", so they can be selected or
+ * skipped with --tags.
+ */
+#define CUTL_STRESS(func, threads, iterations, ...) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #__VA_ARGS__, "stress", __LINE__, \
+            _CUTL_STRESS(func, threads, iterations, false, _CUTL_STRESS_ARG(0, ##__VA_ARGS__, NULL))); \
+    } while (0)
+
+
+/**
+ * Like CUTL_STRESS, but runs once for every number of threads from 1 up to
+ * the given one (in powers of two past 16), reporting how throughput scales
+ */
+#define CUTL_STRESS_SWEEP(func, threads, iterations, ...) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #__VA_ARGS__, "stress", __LINE__, \
+            _CUTL_STRESS(func, threads, iterations, true, _CUTL_STRESS_ARG(0, ##__VA_ARGS__, NULL))); \
+    } while (0)
+
+// Picks the param of the function, or NULL if none was given
+#define _CUTL_STRESS_ARG(zero, arg, ...) (arg)
+
+
+
+/**
+ * Runs a test function once for every record of a case file, which is
+ * mapped into memory and never copied. The function gets a view of each
+ * record, and checks it with assertions as any test function would:
+ *
+ *     static void test_parse(const cutl_case_t *record) { ... }
+ *
+ *     CUTL_TEST_CASES(test_parse, "parse_cases.tsv");
+ *
+ * Files ending in .tsv have a record per line, with fields separated by
+ * tabs (see cutl_case_field). Blank lines and lines starting with '#' are
+ * skipped. Any other file is a sequence of records, each one made of its
+ * size as a 32-bit little-endian integer followed by its bytes.
+ *
+ * All the records are one test, which fails if any case fails. The first
+ * failure tells the index and offset of its record, and the summary counts
+ * the cases apart from the tests. Use ASSERT* in the function: a failed
+ * THREAD_ASSERT* or CUTL_REPORT_ERROR ends all the cases. Tagged with
+ * "cases", so they can be selected or skipped with --tags.
+ */
+#define CUTL_TEST_CASES(func, path) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #path, "cases", __LINE__, _CUTL_TEST_CASES(func, path)); \
+    } while (0)
+
+
+
+/**
+ * Tests that a property holds for many arguments, made by generators. The
+ * test function is called with one argument per generator, for as many
+ * random cases as set with cutl_config_property (10000 by default):
+ *
+ *     static void test_reverse(const char *text, long long n) { ... }
+ *
+ *     CUTL_PROPERTY(test_reverse, cutl_gen_string(64), cutl_gen_int(-5, 5));
+ *
+ * Generators are cutl_gen_int, cutl_gen_double, cutl_gen_float,
+ * cutl_gen_string and cutl_gen_bytes. Any other expression is passed as it
+ * is. Up to 6 arguments are supported.
+ *
+ * Once a case fails an ASSERT*, it is shrunk: smaller and shorter versions
+ * of its arguments are tried, and the simplest one that still fails is
+ * reported, along with the seed that replays the property (CUTL_SEED).
+ * Failures of THREAD_ASSERT* are shrunk too, but errors end the property
+ * right away. Every case counts in the summary of cases. Tagged with
+ * "property", so they can be selected or skipped with --tags.
+ */
+#define CUTL_PROPERTY(func, ...) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #__VA_ARGS__, "property", __LINE__, \
+            _CUTL_PROPERTY(func, __VA_ARGS__)); \
+    } while (0)
+
+
+/**
+ * Makes a test function that takes (const uint8_t *data, size_t size) a
+ * fuzz target, with a corpus of inputs kept as files in a directory:
+ *
+ *     static void test_parse(const uint8_t *data, size_t size) { ... }
+ *
+ *     CUTL_FUZZ(test_parse, "parse_corpus");
+ *
+ * Normal runs replay every input of the corpus, as a case, and the test
+ * fails with the first one that fails. The directory is found as case
+ * files are, and a missing one is an empty corpus.
+ *
+ * With --fuzz (see cutl_args), fuzz targets are the only tests run. Their
+ * inputs are mutated in process, and those that take new paths through
+ * the code join the corpus. Paths are only seen in code built with
+ * -fsanitize-coverage=trace-pc-guard (clang) or trace-pc (gcc), otherwise
+ * inputs are just random. Fuzzing goes on until the target fails an
+ * assertion, reports an error, crashes or times out, which saves the
+ * input to the corpus as crash-<hash>, to be replayed from then on. The
+ * timeout of the test applies to each run. Mutations depend on CUTL_SEED.
+ * Tagged with "fuzz", so they can be selected or skipped with --tags.
+ */
+#define CUTL_FUZZ(func, dir) \
+    do { \
+        _CUTL_RUN_TEST(__FILE__, #func, #dir, "fuzz", __LINE__, _CUTL_FUZZ(func, dir)); \
+    } while (0)
+
+
+// Runs every case under a jump point of its own, so that THREAD_ASSERT*
+// end the case and not the whole property
+#define _CUTL_PROPERTY(func, ...) \
+    { \
+        _cutl_jmp_buf_t _cutl_property_exit; \
+        \
+        memcpy(_cutl_property_exit, _cutl_context.exit, sizeof(_cutl_jmp_buf_t)); \
+        _CUTL_PROPERTY_START(#func, #__VA_ARGS__); \
+        \
+        while (_CUTL_PROPERTY_NEXT()) { \
+            if (_CUTL_SETJMP(_cutl_context.exit) == 0) { \
+                _CUTL_PROPERTY_CALL(func, __VA_ARGS__); \
+            } \
+            else { \
+                _CUTL_TIMEOUT_REGISTER(); \
+            } \
+        } \
+        \
+        memcpy(_cutl_context.exit, _cutl_property_exit, sizeof(_cutl_jmp_buf_t)); \
+    }
+
+
+// Generates the arguments in order, then calls the function with them
+#define _CUTL_PROPERTY_CALL(func, ...) \
+    _CUTL_PROPERTY_PICK(__VA_ARGS__, _CUTL_PROPERTY_CALL_6, _CUTL_PROPERTY_CALL_5, _CUTL_PROPERTY_CALL_4, \
+        _CUTL_PROPERTY_CALL_3, _CUTL_PROPERTY_CALL_2, _CUTL_PROPERTY_CALL_1, _)(func, __VA_ARGS__)
+
+#define _CUTL_PROPERTY_PICK(_1, _2, _3, _4, _5, _6, call, ...) call
+
+#define _CUTL_PROPERTY_CALL_1(func, g1) \
+    { __typeof__(g1) _cutl_a1 = (g1); \
+      func(_cutl_a1); }
+
+#define _CUTL_PROPERTY_CALL_2(func, g1, g2) \
+    { __typeof__(g1) _cutl_a1 = (g1); __typeof__(g2) _cutl_a2 = (g2); \
+      func(_cutl_a1, _cutl_a2); }
+
+#define _CUTL_PROPERTY_CALL_3(func, g1, g2, g3) \
+    { __typeof__(g1) _cutl_a1 = (g1); __typeof__(g2) _cutl_a2 = (g2); __typeof__(g3) _cutl_a3 = (g3); \
+      func(_cutl_a1, _cutl_a2, _cutl_a3); }
+
+#define _CUTL_PROPERTY_CALL_4(func, g1, g2, g3, g4) \
+    { __typeof__(g1) _cutl_a1 = (g1); __typeof__(g2) _cutl_a2 = (g2); __typeof__(g3) _cutl_a3 = (g3); \
+      __typeof__(g4) _cutl_a4 = (g4); \
+      func(_cutl_a1, _cutl_a2, _cutl_a3, _cutl_a4); }
+
+#define _CUTL_PROPERTY_CALL_5(func, g1, g2, g3, g4, g5) \
+    { __typeof__(g1) _cutl_a1 = (g1); __typeof__(g2) _cutl_a2 = (g2); __typeof__(g3) _cutl_a3 = (g3); \
+      __typeof__(g4) _cutl_a4 = (g4); __typeof__(g5) _cutl_a5 = (g5); \
+      func(_cutl_a1, _cutl_a2, _cutl_a3, _cutl_a4, _cutl_a5); }
+
+#define _CUTL_PROPERTY_CALL_6(func, g1, g2, g3, g4, g5, g6) \
+    { __typeof__(g1) _cutl_a1 = (g1); __typeof__(g2) _cutl_a2 = (g2); __typeof__(g3) _cutl_a3 = (g3); \
+      __typeof__(g4) _cutl_a4 = (g4); __typeof__(g5) _cutl_a5 = (g5); __typeof__(g6) _cutl_a6 = (g6); \
+      func(_cutl_a1, _cutl_a2, _cutl_a3, _cutl_a4, _cutl_a5, _cutl_a6); }
+
+
+
+/**
+ * Prevents the compiler from optimizing away a value computed inside a
+ * benchmark, e.g. the result of a pure function
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define CUTL_DO_NOT_OPTIMIZE(value) \
+        do { \
+            __typeof__(value) _cutl_value = (value); \
+            __asm__ __volatile__("" : : "g"(_cutl_value) : "memory"); \
+        } while (0)
+#else
+    #define CUTL_DO_NOT_OPTIMIZE(value) \
+        do { \
+            volatile uintmax_t _cutl_value = (uintmax_t)(value); \
+            (void)_cutl_value; \
+        } while (0)
+#endif
+
+
+
+// Runs a test call surrounded by the special functions. Each call counts
+// the times it is reached, which tells apart those in a loop.
+#define _CUTL_RUN_TEST(file, name, args, tags, line, call) \
+    do { \
+        static unsigned int _cutl_n_calls = 0; \
+        \
+        _CUTL_RUN_TEST_HOOKED(CUTL_BEFORE_EACH, CUTL_AFTER_EACH, file, name, args, tags, line, \
+            _cutl_n_calls++, call); \
+    } while (0)
+
+// The same, with the special functions of another file
+#define _CUTL_RUN_TEST_HOOKED(before_each, after_each, file, name, args, tags, line, n_call, call) \
+    if (_CUTL_TEST_START(file, name, args, tags, line, n_call)) { \
+        before_each();                              \
+                                                    \
+        _CUTL_TEST_BODY_START();                    \
+                                                    \
+        if (_CUTL_SETJMP(_cutl_context.exit) == 0) { \
+            call;                                   \
+        }                                           \
+                                                    \
+        _CUTL_TEST_BODY_END();                      \
+                                                    \
+        after_each();                               \
+                                                    \
+        _CUTL_TEST_FINISH();                        \
+    }
+
+
+
+/**
+ * Defines a test function that takes no params and registers it, so that
+ * CUTL_RUN_REGISTERED can find it. It can be given any number of tags to
+ * select it with. The body of the test follows the macro:
+ *
+ *     CUTL_TEST(test_addition, fast, math) {
+ *         ASSERT_EQ_INT(1 + 2, 3);
+ *     }
+ *
+ * Registration relies on constructors, so it is only available with GCC
+ * and clang.
+ *
+ * The special functions of the file where the test is defined run around
+ * it, even from the CUTL_MAIN() of another file in split mode. Each
+ * file is a suite: its CUTL_BEFORE_ALL runs before the first of its
+ * tests and its CUTL_AFTER_ALL after the last one.
+ */
+#define CUTL_TEST(name, ...) \
+    static void name(void); \
+    static _cutl_suite_t _cutl_file_suite; \
+    static _cutl_test_desc_t _cutl_test_desc_##name = { \
+        #name, #__VA_ARGS__, __FILE__, __LINE__, name, &_cutl_file_suite, NULL \
+    }; \
+    __attribute__((constructor)) static void _cutl_register_##name(void) { \
+        _cutl_file_suite.before_all  = CUTL_BEFORE_ALL; \
+        _cutl_file_suite.after_all   = CUTL_AFTER_ALL; \
+        _cutl_file_suite.before_each = CUTL_BEFORE_EACH; \
+        _cutl_file_suite.after_each  = CUTL_AFTER_EACH; \
+        _CUTL_REGISTER_TEST(&_cutl_test_desc_##name); \
+    } \
+    static void name(void)
+
+
+
+/**
+ * Runs every registered test selected by cutl_args() as if it had been
+ * called with CUTL_TEST_FUNCTION, in the order they were defined, file
+ * after file. Tests from other files than this one run between the
+ * CUTL_BEFORE_ALL and CUTL_AFTER_ALL of their own.
+ */
+#define CUTL_RUN_REGISTERED() \
+    do { \
+        const _cutl_test_desc_t *_cutl_test; \
+        _cutl_suite_t           *_cutl_running_suite = NULL; \
+        \
+        for (_cutl_test = _cutl_registry; _cutl_test != NULL; _cutl_test = _cutl_test->next) { \
+            if (_cutl_test->suite != _cutl_running_suite) { \
+                _CUTL_SUITE_END(_cutl_running_suite); \
+                _cutl_running_suite = _cutl_test->suite; \
+                _CUTL_SUITE_START(_cutl_test, __FILE__); \
+            } \
+            \
+            _CUTL_RUN_TEST_HOOKED(_cutl_running_suite->before_each, _cutl_running_suite->after_each, \
+                _cutl_test->file, _cutl_test->name, "", _cutl_test->tags, _cutl_test->line, 0, \
+                _cutl_test->func()); \
+        } \
+        \
+        _CUTL_SUITE_END(_cutl_running_suite); \
+    } while (0)
+
+
+
+/**
+ * Defines a main() function that runs every registered test, taking the
+ * options described in cutl_args() from the command line
+ */
+#define CUTL_MAIN() \
+    int main(int argc, char **argv) { \
+        cutl_args(argc, argv); \
+        \
+        CUTL_BEGIN_TEST(); \
+        CUTL_RUN_REGISTERED(); \
+        CUTL_END_TEST(); \
+        \
+        return cutl_failed(); \
+    }
+
+
+
+#if _CUTL_IMPLEMENT
+
+/**
+ * Returns the number of failed tests, counting those that the total
+ * timeout left without running
+ */
+__CUTL_UNUSED int cutl_failed() {
+    return _cutl_n_tests_failed + _cutl_n_tests_skipped;
+}
+
+#endif /* _CUTL_IMPLEMENT */
+
+
+// ==========================================================================
+// MEMORY COMPARISON
+// ==========================================================================
+
+
+// Bytes compared by each call to memcmp(), which libc vectorizes. Blocks
+// keep it from going far past the first difference.
+#define _CUTL_MEM_BLOCK     4096
+
+// Elements shown at each side of the first difference, by their size, and
+// the first of them
+#define _CUTL_WINDOW(elem_size) \
+    (((elem_size) == 1) ? 8 : ((elem_size) <= 2) ? 4 : ((elem_size) <= 4) ? 2 : 1)
+#define _CUTL_WINDOW_FIRST(index, elem_size) \
+    (((index) > (size_t)_CUTL_WINDOW(elem_size)) ? (index) - _CUTL_WINDOW(elem_size) : 0)
+
+#define _CUTL_MAX_WINDOW_BYTES  8       // Bytes shown of each element
+
+// How the elements of a window are written: their bytes in hex, or their
+// values as integers, floating point numbers or addresses
+#define _CUTL_VALUE_BYTES       0
+#define _CUTL_VALUE_SIGNED      1
+#define _CUTL_VALUE_UNSIGNED    2
+#define _CUTL_VALUE_FLOAT       3
+#define _CUTL_VALUE_POINTER     4
+
+// Types whose equal values may have different bytes (0.0 and -0.0), or
+// whose equal bytes may not be equal values (NaN). Without a way to tell,
+// every type is compared value by value.
+#if defined(__GNUC__) || defined(__clang__)
+    #define _CUTL_IS_FLOATING(type) \
+        (__builtin_types_compatible_p(type, float) || __builtin_types_compatible_p(type, double) \
+         || __builtin_types_compatible_p(type, long double))
+#else
+    #define _CUTL_IS_FLOATING(type) 1
+#endif
+
+// Without a way to tell floating point types apart, values are shown in hex
+#if defined(__GNUC__) || defined(__clang__)
+    #define _CUTL_VALUE_KIND(type) \
+        (_CUTL_IS_FLOATING(type) ? _CUTL_VALUE_FLOAT \
+         : (__builtin_classify_type((type)0) == 5) ? _CUTL_VALUE_POINTER \
+         : ((type)-1 < (type)1) ? _CUTL_VALUE_SIGNED : _CUTL_VALUE_UNSIGNED)
+#else
+    #define _CUTL_VALUE_KIND(type) _CUTL_VALUE_BYTES
+#endif
+
+
+#if _CUTL_IMPLEMENT
+
+/**
+ * Returns the offset of the first byte that differs between two blocks of
+ * memory, or nbytes if they are equal
+ */
+size_t _CUTL_MEM_MISMATCH(const void *p1, const void *p2, size_t nbytes) {
+    const unsigned char *b1 = (const unsigned char *)p1;
+    const unsigned char *b2 = (const unsigned char *)p2;
+    size_t               offset = 0;
+
+    if (p1 == p2) {
+        return nbytes;
+    }
+
+    while (offset < nbytes) {
+        size_t block = (nbytes - offset < _CUTL_MEM_BLOCK) ? nbytes - offset : _CUTL_MEM_BLOCK;
+
+        if (memcmp(b1 + offset, b2 + offset, block) != 0) {
+            while (b1[offset] == b2[offset]) {
+                offset++;
+            }
+
+            return offset;
+        }
+
+        offset += block;
+    }
+
+    return nbytes;
+}
+
+
+/**
+ * Writes an element as a value of the given kind, or its bytes in memory
+ * order when it is not of a size of that kind
+ */
+static int _cutl_format_value(char *buffer, size_t size, const unsigned char *elem, size_t elem_size, int kind) {
+    size_t shown = (elem_size < _CUTL_MAX_WINDOW_BYTES) ? elem_size : _CUTL_MAX_WINDOW_BYTES;
+    size_t j;
+    int    used;
+
+    if (kind == _CUTL_VALUE_SIGNED || kind == _CUTL_VALUE_UNSIGNED || kind == _CUTL_VALUE_POINTER) {
+        bool      sign = (kind == _CUTL_VALUE_SIGNED);
+        uintmax_t bits = 0;
+
+        if (elem_size == 1 || elem_size == 2 || elem_size == 4 || elem_size == 8) {
+            uint8_t b1; uint16_t b2; uint32_t b4; uint64_t b8;
+
+            switch (elem_size) {
+                case 1:  memcpy(&b1, elem, 1); bits = b1; break;
+                case 2:  memcpy(&b2, elem, 2); bits = b2; break;
+                case 4:  memcpy(&b4, elem, 4); bits = b4; break;
+                default: memcpy(&b8, elem, 8); bits = b8; break;
+            }
+
+            // Sign extension of the lower bits
+            if (sign && elem_size < sizeof(bits) && (bits >> (8 * elem_size - 1)) != 0) {
+                bits |= ~(uintmax_t)0 << (8 * elem_size);
+            }
+
+            return sign ? snprintf(buffer, size, "%jd", (intmax_t)bits)
+                 : snprintf(buffer, size, (kind == _CUTL_VALUE_POINTER) ? "0x%jx" : "%ju", bits);
+        }
+    }
+    else if (kind == _CUTL_VALUE_FLOAT) {
+        if (elem_size == sizeof(float)) {
+            float v;
+
+            memcpy(&v, elem, sizeof(v));
+            return snprintf(buffer, size, "%.9g", (double)v);
+        }
+        else if (elem_size == sizeof(double)) {
+            double v;
+
+            memcpy(&v, elem, sizeof(v));
+            return snprintf(buffer, size, "%.17g", v);
+        }
+        else if (elem_size == sizeof(long double)) {
+            long double v;
+
+            memcpy(&v, elem, sizeof(v));
+            return snprintf(buffer, size, "%.21Lg", v);
+        }
+    }
+
+    for (j = 0, used = 0; j < shown && used >= 0 && (size_t)used < size; j++) {
+        used += snprintf(buffer + used, size - used, "%02x", elem[j]);
+    }
+
+    if (used >= 0 && (size_t)used < size && shown < elem_size) {
+        used += snprintf(buffer + used, size - used, "..");
+    }
+
+    return used;
+}
+
+
+/**
+ * Writes the elements around the given index, with the element at the
+ * index between brackets. p points to the first of them, the one at
+ * _CUTL_WINDOW_FIRST(index, elem_size).
+ */
+int _CUTL_FORMAT_WINDOW(char *buffer, size_t size, const char *name, int width,
+                        const void *p, size_t elem_size, int kind, size_t index, size_t n) {
+    const unsigned char *elems  = (const unsigned char *)p;
+    size_t               window = _CUTL_WINDOW(elem_size);
+    size_t               first  = _CUTL_WINDOW_FIRST(index, elem_size);
+    size_t               last   = (n - index > window) ? index + window : n - 1;
+    size_t               i;
+    int                  used;
+
+    used = snprintf(buffer, size, "\n\t  %-*.*s [%zu]:", width, width, name, first);
+
+    for (i = first; i <= last && used >= 0 && (size_t)used < size; i++) {
+        used += snprintf(buffer + used, size - used, (i == index) ? " [" : " ");
+
+        if ((size_t)used < size) {
+            used += _cutl_format_value(buffer + used, size - used, elems + (i - first) * elem_size, elem_size, kind);
+        }
+
+        if ((size_t)used < size && i == index) {
+            used += snprintf(buffer + used, size - used, "]");
+        }
+    }
+
+    return used;
+}
+
+
+/**
+ * Registers the failure of a comparison of arrays, telling where they
+ * first differ and showing the elements around it in both. p1 and p2 point
+ * to the first elements shown, as in _CUTL_FORMAT_WINDOW.
+ */
+void _CUTL_REGISTER_MISMATCH(int line, const char *assertion, const char *unit,
+                             const char *name1, const void *p1,
+                             const char *name2, const void *p2,
+                             size_t elem_size, int kind, size_t index, size_t n) {
+    char   msg[_CUTL_MAX_LEN_MSG];
+    size_t len1  = strlen(name1);
+    size_t len2  = strlen(name2);
+    int    width = (int)((len1 > len2) ? len1 : len2);
+    int    used;
+
+    width = (width < 24) ? width : 24;
+
+    used = snprintf(msg, sizeof(msg), "%s: first difference at %s %zu of %zu", assertion, unit, index, n);
+
+    if (used >= 0 && (size_t)used < sizeof(msg)) {
+        used += _CUTL_FORMAT_WINDOW(msg + used, sizeof(msg) - used, name1, width, p1, elem_size, kind, index, n);
+    }
+
+    if (used >= 0 && (size_t)used < sizeof(msg)) {
+        _CUTL_FORMAT_WINDOW(msg + used, sizeof(msg) - used, name2, width, p2, elem_size, kind, index, n);
+    }
+
+    _CUTL_REGISTER_TEST_FAILURE(line, msg);
+}
+
+
+
+// ==========================================================================
+// SNAPSHOTS
+// ==========================================================================
+
+
+/**
+ * Writes the line of a snapshot around a position, from a little before
+ * it to the end of the line, escaping what is not printable
+ */
+int _CUTL_FORMAT_SNAPSHOT_LINE(char *buffer, size_t size, const char *label,
+                               const char *data, size_t data_size, size_t from) {
+    size_t i;
+    int    used = snprintf(buffer, size, "\n\t  %s %s", label, (from > 0 && data[from - 1] != '\n') ? "..." : "");
+
+    for (i = from; i < data_size && i < from + _CUTL_SNAPSHOT_SHOWN && used >= 0 && (size_t)used < size; i++) {
+        unsigned char c = (unsigned char)data[i];
+
+        if (c == '\n') {
+            break;
+        }
+        else if (c == '\t' || c == '\\') {
+            used += snprintf(buffer + used, size - used, (c == '\t') ? "\\t" : "\\\\");
+        }
+        else if (c < 0x20 || c >= 0x7f) {
+            used += snprintf(buffer + used, size - used, "\\x%02x", c);
+        }
+        else {
+            buffer[used++] = (char)c;
+            buffer[used]   = '\0';
+        }
+    }
+
+    if (used >= 0 && (size_t)used < size) {
+        used += snprintf(buffer + used, size - used, "%s",
+            (i == data_size) ? "<end>" : (data[i] == '\n') ? "" : "...");
+    }
+
+    return used;
+}
+
+
+/**
+ * Rewrites a golden file through a temporary file, so that it is never
+ * left half written, creating the directories it is in
+ */
+bool _CUTL_WRITE_SNAPSHOT(const char *path, const void *data, size_t size) {
+    char  tmp_path[1024 + 8];
+    FILE *file;
+    bool  written;
+
+#if _CUTL_POSIX
+    {
+        char  dir[1024];
+        char *slash;
+
+        snprintf(dir, sizeof(dir), "%s", path);
+
+        for (slash = strchr(dir + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+            *slash = '\0';
+            mkdir(dir, 0755);
+            *slash = '/';
+        }
+    }
+#endif
+
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+    if ((file = fopen(tmp_path, "wb")) == NULL) {
+        return false;
+    }
+
+    written = (fwrite(data, 1, size, file) == size);
+    written = (fclose(file) == 0) && written;
+
+    if (!written || rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return false;
+    }
+
+    return true;
+}
 
-// Control of test failures
 
-#define _CUTL_MAX_LEN_FUNC_NAME 128
-#define _CUTL_MAX_LEN_MSG       256
+/**
+ * Compares a buffer with its golden file, named relative to the file being
+ * tested, and registers a failure telling the first line where they differ.
+ * Equal sizes are compared with memcmp() block by block, right where the
+ * file is mapped, which is as fast as hashing both and reads them once.
+ * With --update-snapshots, the golden file is rewritten instead, if it
+ * does not match.
+ */
+bool _CUTL_CHECK_SNAPSHOT(int line, const char *assertion, const void *data, size_t size, const char *name) {
+    char        path[1024];
+    char        msg[_CUTL_MAX_LEN_MSG];
+    FILE       *file;
+    const char *golden      = NULL;
+    size_t      golden_size = 0;
+    size_t      offset, from, n_line;
+    bool        binary;
+    int         used;
+
+    if (!_CUTL_SOURCE_PATH(name, path, sizeof(path))) {
+        snprintf(path, sizeof(path), "%s", name);
+    }
 
+    if ((file = fopen(path, "rb")) != NULL) {
+        golden = _CUTL_MAP_FILE(file, &golden_size);
+        fclose(file);
 
-static char *_cutl_current_file = NULL;    // Name of the file being tested
-static char *_cutl_current_func = NULL;    // Name of the function being tested
-static int   _cutl_current_line = -1;      // Line in the file where the function being tested was called
+        if (golden == NULL && golden_size > 0) {
+            snprintf(msg, sizeof(msg), "%s: could not read the snapshot %.256s", assertion, path);
+            _CUTL_REGISTER_TEST_ERROR(line, msg);
+            return false;
+        }
+    }
 
-static unsigned int _cutl_n_tests_passed;   // Number of tests passed
-static unsigned int _cutl_n_tests_failed;   // Number of tests failed
+    offset = _CUTL_MEM_MISMATCH(golden, data, (golden_size < size) ? golden_size : size);
 
-static int  _cutl_test_status;
-static int  _cutl_failure_line;
-static char _cutl_failure_msg[_CUTL_MAX_LEN_MSG];
+    if (file != NULL && golden_size == size && offset == size) {
+        _CUTL_UNMAP_FILE(golden, golden_size);
+        return true;
+    }
 
-// Logging and report settings
-static FILE *_cutl_report_file = NULL;
+    if (_cutl_snapshot_update) {
+        _CUTL_UNMAP_FILE(golden, golden_size);
 
+        if (!_CUTL_WRITE_SNAPSHOT(path, data, size)) {
+            snprintf(msg, sizeof(msg), "%s: could not write the snapshot %.256s", assertion, path);
+            _CUTL_REGISTER_TEST_ERROR(line, msg);
+            return false;
+        }
 
+        _CUTL_REPORT_INFO("Snapshot %s %s (%zu bytes)", path, (file != NULL) ? "updated" : "written", size);
+        return true;
+    }
 
+    if (file == NULL) {
+        snprintf(msg, sizeof(msg), "%s: there is no snapshot %.256s (--update-snapshots writes it)", assertion, path);
+        _CUTL_REGISTER_TEST_FAILURE(line, msg);
+        return false;
+    }
 
-// ==========================================================================
-// Private functions declarations
-// ==========================================================================
+    // Text is shown by lines, from where both are equal up to offset, and
+    // binary data (telling by a NUL close to the difference) by bytes
+    from = (offset > _CUTL_SNAPSHOT_CONTEXT) ? offset - _CUTL_SNAPSHOT_CONTEXT : 0;
+    binary = (golden_size > from && memchr(golden + from, '\0', (golden_size - from < 2 * _CUTL_SNAPSHOT_CONTEXT)
+                                               ? golden_size - from : 2 * _CUTL_SNAPSHOT_CONTEXT) != NULL)
+          || (size > from && memchr((const char *)data + from, '\0', (size - from < 2 * _CUTL_SNAPSHOT_CONTEXT)
+                                               ? size - from : 2 * _CUTL_SNAPSHOT_CONTEXT) != NULL);
+
+    if (binary) {
+        used = snprintf(msg, sizeof(msg), "%s: differs from %.256s at byte %zu (%zu bytes, %zu expected)",
+            assertion, path, offset, size, golden_size);
+
+        if (used >= 0 && (size_t)used < sizeof(msg)) {
+            used += (golden_size > 0)
+                ? _CUTL_FORMAT_WINDOW(msg + used, sizeof(msg) - used, "expected", 8,
+                                      golden + _CUTL_WINDOW_FIRST(offset, 1), 1, _CUTL_VALUE_BYTES, offset, golden_size)
+                : _CUTL_FORMAT_SNAPSHOT_LINE(msg + used, sizeof(msg) - used, "expected", golden, 0, 0);
+        }
+
+        if (used >= 0 && (size_t)used < sizeof(msg)) {
+            used += (size > 0)
+                ? _CUTL_FORMAT_WINDOW(msg + used, sizeof(msg) - used, "actual", 8,
+                                      (const char *)data + _CUTL_WINDOW_FIRST(offset, 1), 1, _CUTL_VALUE_BYTES, offset, size)
+                : _CUTL_FORMAT_SNAPSHOT_LINE(msg + used, sizeof(msg) - used, "actual  ", data, 0, 0);
+        }
+    }
+    else {
+        for (from = 0, n_line = 1; ; ) {
+            const char *newline = (from < offset) ? memchr(golden + from, '\n', offset - from) : NULL;
 
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_SUCCESS(const char *msg, ...));
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_FAILURE(const char *msg, ...));
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_INFO(const char *msg, ...));
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_DEBUG(const char *msg, ...));
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_ERROR(const char *msg, ...));
+            if (newline == NULL) {
+                break;
+            }
 
+            from = (size_t)(newline - golden) + 1;
+            n_line++;
+        }
 
-__CUTL_DECL_UNUSED(static void _CUTL_REGISTER_TEST_FAILURE(const int line, const char *msg));
-__CUTL_DECL_UNUSED(static void _CUTL_REGISTER_TEST_ERROR(const int line, const char *msg));
+        from = (offset - from > _CUTL_SNAPSHOT_CONTEXT) ? offset - _CUTL_SNAPSHOT_CONTEXT : from;
 
-__CUTL_DECL_UNUSED(static void _CUTL_REPORT_TEST_RESULT(void));
+        used = snprintf(msg, sizeof(msg), "%s: differs from %.256s at line %zu, byte %zu (%zu bytes, %zu expected)",
+            assertion, path, n_line, offset, size, golden_size);
 
+        if (used >= 0 && (size_t)used < sizeof(msg)) {
+            used += _CUTL_FORMAT_SNAPSHOT_LINE(msg + used, sizeof(msg) - used, "expected:", golden, golden_size, from);
+        }
 
+        if (used >= 0 && (size_t)used < sizeof(msg)) {
+            _CUTL_FORMAT_SNAPSHOT_LINE(msg + used, sizeof(msg) - used, "actual:  ", (const char *)data, size, from);
+        }
+    }
 
-// ==========================================================================
-// Configs
-// ==========================================================================
+    _CUTL_UNMAP_FILE(golden, golden_size);
+    _CUTL_REGISTER_TEST_FAILURE(line, msg);
 
-/**
- * Sets CuTL configurations. The function receives a series of flags that can
- * be combined with the OR operator. Current available flags are:
- * 
- *   - CUTL_FLAG_STOP_AT_FAIL : If provided, the execution will be aborted
- *         upon test failure.
- */
-static void cutl_config(int flags) {
-    _cutl_stop_at_fail = (bool)(flags & CUTL_FLAG_STOP_AT_FAIL);
+    return false;
 }
 
+#endif /* _CUTL_IMPLEMENT */
+
 
 
 // ==========================================================================
-// REPORTS
+// FLOATING POINT COMPARISON
 // ==========================================================================
 
 
-#define _CUTL_ANSI_RESET "\033[0m"
-#define _CUTL_ANSI_RED   "\033[31m"
-#define _CUTL_ANSI_GREEN "\033[32m"
-#define _CUTL_ANSI_BLUE  "\033[34m"
+// Errors measured by ASSERT_NEAR* and ASSERT_ULP_LE*
+#define _CUTL_NEAR_ABS  0       // |v1 - v2|
+#define _CUTL_NEAR_REL  1       // |v1 - v2| / max(|v1|, |v2|)
+#define _CUTL_NEAR_ULP  2       // Representable values between v1 and v2
 
-#define _CUTL_RGB_SUCCESS _CUTL_ANSI_GREEN
-#define _CUTL_RGB_FAILURE _CUTL_ANSI_RED
-#define _CUTL_RGB_INFO    _CUTL_ANSI_RESET
-#define _CUTL_RGB_DEBUG   _CUTL_ANSI_BLUE
-#define _CUTL_RGB_ERROR   _CUTL_ANSI_RED
+// Histogram of errors: exact ones, one bin per power of two, and NaN or
+// infinite values that do not match
+#define _CUTL_NEAR_MIN_EXP  (-64)
+#define _CUTL_NEAR_MAX_EXP  63
+#define _CUTL_NEAR_BINS     (_CUTL_NEAR_MAX_EXP - _CUTL_NEAR_MIN_EXP + 3)
 
+#define _CUTL_NEAR_BLOCK    1024    // Elements checked at once before looking for the first failure
 
 
+#if _CUTL_IMPLEMENT
+
 /**
- * Reports successfull test
+ * Returns the error between two values, according to the kind of error.
+ * NaN matches NaN and infinities match themselves, with no error, while
+ * any other pair involving them has an infinite error.
  */
-__CUTL_UNUSED void _CUTL_REPORT_SUCCESS(const char *format, ...) {
-    va_list args;
+double _CUTL_NEAR_ERROR(int kind, bool single, double v1, double v2) {
+    double diff, max;
 
-    va_start(args, format);
+    if (isnan(v1) || isnan(v2)) {
+        return (isnan(v1) && isnan(v2)) ? 0 : INFINITY;
+    }
 
-    if (_cutl_report_file == stdout) {
-        fprintf(_cutl_report_file, _CUTL_RGB_SUCCESS "====[PASSED]==== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, _CUTL_ANSI_RESET "\n");
+    if (v1 == v2) {
+        return 0;
     }
-    else {
-        fprintf(_cutl_report_file, "====[PASSED]==== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, "\n");
+
+    if (isinf(v1) || isinf(v2)) {
+        return INFINITY;
     }
 
-    va_end(args);
-}
+    if (kind == _CUTL_NEAR_ULP) {
+        // Bits of IEEE 754 values, once negative ones are mirrored, are
+        // integers in the same order as the values they stand for
+        int64_t i1, i2;
 
+        if (single) {
+            float    f1 = (float)v1, f2 = (float)v2;
+            int32_t  b1, b2;
 
-/**
- * Reports failed test
- */
-__CUTL_UNUSED void _CUTL_REPORT_FAILURE(const char *format, ...) {
-    va_list args;
+            memcpy(&b1, &f1, sizeof(b1));
+            memcpy(&b2, &f2, sizeof(b2));
 
-    va_start(args, format);
+            i1 = (b1 < 0) ? (int64_t)INT32_MIN - b1 : b1;
+            i2 = (b2 < 0) ? (int64_t)INT32_MIN - b2 : b2;
+        }
+        else {
+            memcpy(&i1, &v1, sizeof(i1));
+            memcpy(&i2, &v2, sizeof(i2));
 
-    if (_cutl_report_file == stdout) {
-        fprintf(_cutl_report_file, _CUTL_RGB_FAILURE "====[FAILED]==== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, _CUTL_ANSI_RESET "\n");
+            i1 = (i1 < 0) ? INT64_MIN - i1 : i1;
+            i2 = (i2 < 0) ? INT64_MIN - i2 : i2;
+        }
+
+        return (double)((i1 > i2) ? (uint64_t)i1 - (uint64_t)i2 : (uint64_t)i2 - (uint64_t)i1);
     }
-    else {
-        fprintf(_cutl_report_file, "====[FAILED]==== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, "\n");
+
+    diff = (v1 > v2) ? v1 - v2 : v2 - v1;
+
+    if (kind == _CUTL_NEAR_REL) {
+        max = (v1 < 0) ? -v1 : v1;
+        max = (v2 > max) ? v2 : (-v2 > max) ? -v2 : max;
+
+        diff /= max;
     }
 
-    va_end(args);
+    return diff;
 }
 
 
 /**
- * Reports some information
+ * Returns the error of the element at the given index
  */
-__CUTL_UNUSED void _CUTL_REPORT_INFO(const char *format, ...) {
-    va_list args;
-
-    va_start(args, format);
-
-    if (_cutl_report_file == stdout) {
-        fprintf(_cutl_report_file, _CUTL_RGB_INFO "=====[INFO]===== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, _CUTL_ANSI_RESET "\n");
-    }
-    else {
-        fprintf(_cutl_report_file, "=====[INFO]===== ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, "\n");
+static double _cutl_near_error_at(int kind, bool single, const void *p1, const void *p2, size_t i) {
+    if (single) {
+        return _CUTL_NEAR_ERROR(kind, true, ((const float *)p1)[i], ((const float *)p2)[i]);
     }
 
-    va_end(args);
+    return _CUTL_NEAR_ERROR(kind, false, ((const double *)p1)[i], ((const double *)p2)[i]);
 }
 
 
 /**
- * Reports some debug information
+ * Returns whether every element of a block of _CUTL_NEAR_BLOCK doubles is
+ * within tolerance, by a test with no branches that compilers can
+ * vectorize. It errs on the side of failing: NaN and infinite values, even
+ * matching ones, and ulps between values of different signs are left to
+ * _CUTL_NEAR_ERROR. ulps is the tolerance of _CUTL_NEAR_ULP, rounded down.
  */
-__CUTL_UNUSED void _CUTL_REPORT_DEBUG(const char *format, ...) {
-    va_list args;
-
-    va_start(args, format);
+static bool _cutl_near_block_double(int kind, const double *a, const double *b, double tol, uint64_t ulps) {
+    int    bad = 0;
+    size_t i;
+
+    if (kind == _CUTL_NEAR_ABS) {
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            bad |= !((a[i] == b[i]) | (fabs(a[i] - b[i]) <= tol));
+        }
+    }
+    else if (kind == _CUTL_NEAR_REL) {
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            double abs1 = fabs(a[i]), abs2 = fabs(b[i]);
 
-    if (_cutl_report_file == stdout) {
-        fprintf(_cutl_report_file, _CUTL_RGB_DEBUG "====[DEBUG]====  ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, _CUTL_ANSI_RESET "\n");
+            bad |= !((a[i] == b[i]) | (fabs(a[i] - b[i]) / ((abs1 > abs2) ? abs1 : abs2) <= tol));
+        }
     }
     else {
-        fprintf(_cutl_report_file, "====[DEBUG]====  ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, "\n");
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            int64_t  i1, i2;
+            uint64_t diff;
+
+            // With the same sign, the distance between the bits is the ulps
+            memcpy(&i1, &a[i], sizeof(i1));
+            memcpy(&i2, &b[i], sizeof(i2));
+
+            diff = (i1 > i2) ? (uint64_t)i1 - (uint64_t)i2 : (uint64_t)i2 - (uint64_t)i1;
+
+            bad |= ((i1 ^ i2) < 0) | (diff > ulps) | !(fabs(a[i]) <= DBL_MAX) | !(fabs(b[i]) <= DBL_MAX);
+        }
     }
 
-    va_end(args);
+    return !bad;
 }
 
 
 /**
- * Reports an unexpected error (not test failure)
+ * The same, for a block of floats
  */
-__CUTL_UNUSED void _CUTL_REPORT_ERROR(const char *format, ...) {
-    va_list args;
-
-    va_start(args, format);
+static bool _cutl_near_block_float(int kind, const float *a, const float *b, double tol, uint64_t ulps) {
+    uint32_t ulps32 = (ulps > UINT32_MAX) ? UINT32_MAX : (uint32_t)ulps;
+    int      bad    = 0;
+    size_t   i;
+
+    // Errors are computed in double, as _CUTL_NEAR_ERROR does
+    if (kind == _CUTL_NEAR_ABS) {
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            double v1 = a[i], v2 = b[i];
+
+            bad |= !((v1 == v2) | (fabs(v1 - v2) <= tol));
+        }
+    }
+    else if (kind == _CUTL_NEAR_REL) {
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            double v1 = a[i], v2 = b[i];
+            double abs1 = fabs(v1), abs2 = fabs(v2);
 
-    if (_cutl_report_file == stdout) {
-        fprintf(_cutl_report_file, _CUTL_RGB_ERROR "====[ERROR]====  ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, _CUTL_ANSI_RESET "\n");
+            bad |= !((v1 == v2) | (fabs(v1 - v2) / ((abs1 > abs2) ? abs1 : abs2) <= tol));
+        }
     }
     else {
-        fprintf(_cutl_report_file, "====[ERROR]====  ");
-        vfprintf(_cutl_report_file, format, args);
-        fprintf(_cutl_report_file, "\n");
-    }
+        for (i = 0; i < _CUTL_NEAR_BLOCK; i++) {
+            int32_t  i1, i2;
+            uint32_t diff;
 
-    va_end(args);
-}
+            memcpy(&i1, &a[i], sizeof(i1));
+            memcpy(&i2, &b[i], sizeof(i2));
 
+            diff = (i1 > i2) ? (uint32_t)i1 - (uint32_t)i2 : (uint32_t)i2 - (uint32_t)i1;
 
+            bad |= ((i1 ^ i2) < 0) | (diff > ulps32) | !(fabsf(a[i]) <= FLT_MAX) | !(fabsf(b[i]) <= FLT_MAX);
+        }
+    }
 
-// ==========================================================================
-// MANAGING TESTS RESULTS
-// ==========================================================================
+    return !bad;
+}
 
 
 /**
- * Registers a test failure, but does not handle it
+ * Returns the index of the first element out of tolerance, or n if there
+ * is none. Whole blocks are checked with the fast test first, and only
+ * those that may fail, and the last partial block, are checked element by
+ * element.
  */
-void _CUTL_REGISTER_TEST_FAILURE(const int line, const char *msg) {
-    _cutl_test_status = _CUTL_FAILURE;
-    _cutl_failure_line = line;
-    strncpy(_cutl_failure_msg, msg, _CUTL_MAX_LEN_MSG);
+static size_t _cutl_near_first(int kind, bool single, const void *p1, const void *p2, size_t n, double tol) {
+    uint64_t ulps = (tol >= 18446744073709551615.0) ? UINT64_MAX : (tol >= 0) ? (uint64_t)tol : 0;
+    size_t   start, end, i;
+
+    for (start = 0; start < n; start = end) {
+        end = (n - start > _CUTL_NEAR_BLOCK) ? start + _CUTL_NEAR_BLOCK : n;
+
+        // Negative and NaN tolerances fail even equal elements
+        if (tol >= 0 && end - start == _CUTL_NEAR_BLOCK &&
+            (single ? _cutl_near_block_float(kind, (const float *)p1 + start, (const float *)p2 + start, tol, ulps)
+                    : _cutl_near_block_double(kind, (const double *)p1 + start, (const double *)p2 + start, tol, ulps))) {
+            continue;
+        }
+
+        for (i = start; i < end; i++) {
+            if (!(_cutl_near_error_at(kind, single, p1, p2, i) <= tol)) {
+                return i;
+            }
+        }
+    }
+
+    return n;
 }
 
 
 /**
- * Registers a test error
+ * Writes an error in the units of its kind
  */
-void _CUTL_REGISTER_TEST_ERROR(const int line, const char *msg) {
-    _cutl_test_status = _CUTL_ERROR;
-    _cutl_failure_line = line;
-    strncpy(_cutl_failure_msg, msg, _CUTL_MAX_LEN_MSG);
+const char *_CUTL_FORMAT_NEAR_ERROR(int kind, double error, char *buffer, size_t size) {
+    if (isinf(error)) {
+        snprintf(buffer, size, "NaN/Inf mismatch");
+    }
+    else if (kind == _CUTL_NEAR_ULP) {
+        snprintf(buffer, size, "%.0f ulp%s", error, (error == 1) ? "" : "s");
+    }
+    else {
+        snprintf(buffer, size, "%.3g%s", error, (kind == _CUTL_NEAR_REL) ? " relative" : "");
+    }
+
+    return buffer;
 }
 
 
 /**
- * Reports whether if the last test run failed or was successful
+ * Checks that two arrays of floats or doubles are equal within the given
+ * tolerance, registering a failure otherwise. Arrays are scanned until
+ * the first element out of tolerance (see _cutl_near_first), and only
+ * then scanned again to report how many are, where the largest error is,
+ * and a histogram of the errors of all the elements.
  */
-void _CUTL_REPORT_TEST_RESULT() {
-    switch (_cutl_test_status) {
-        case _CUTL_SUCCESS:
-            _cutl_n_tests_passed++;
-            _CUTL_REPORT_SUCCESS("%s l:%d (%s)",
-                _cutl_current_file, _cutl_current_line, _cutl_current_func
-            );
-
-            break;
-
-        case _CUTL_FAILURE:
-            _cutl_n_tests_failed++;
-            _CUTL_REPORT_FAILURE("%s l:%d (%s)\n\tFailure in line %d: %s",
-                _cutl_current_file, _cutl_current_line, _cutl_current_func,
-                _cutl_failure_line, _cutl_failure_msg
-            );
-
-            if (_cutl_stop_at_fail) {
-                _CUTL_REPORT_INFO("Ending execution...");
-                exit(EXIT_FAILURE);
-            }
-
-            break;
-
-        case _CUTL_ERROR:
-            _cutl_n_tests_failed++;
-            _CUTL_REPORT_ERROR("%s l:%d (%s)\n\tError in line %d: %s",
-                _cutl_current_file, _cutl_current_line, _cutl_current_func,
-                _cutl_failure_line, _cutl_failure_msg
-            );
-
-            break;
-
-        default:
-            break;
+bool _CUTL_CHECK_NEAR(int line, const char *assertion, int kind, bool single,
+                      const void *p1, const void *p2, size_t n, bool array, double tol) {
+    char   msg[_CUTL_MAX_LEN_MSG];
+    char   error[32];
+    char   entry[64];
+    size_t bins[_CUTL_NEAR_BINS] = { 0 };
+    size_t i, first = n, failed = 0, worst = 0;
+    double max = -1;
+    int    used, len, b;
+
+    if ((first = _cutl_near_first(kind, single, p1, p2, n, tol)) == n) {
+        return true;
     }
-}
-
-
-// Setup errors
-
-#define _REPORT_GLOB_SETUP_ERROR(file, line, func, msg, ...) \
-    do { \
-        _ERROR("%s l:%d (%s)\n\tError during global setup: " msg, file, line, func, ##__VA_ARGS__); \
-        abort(); \
-    } while (0)
 
+    for (i = first; i < n; i++) {
+        double e = _cutl_near_error_at(kind, single, p1, p2, i);
 
-#define _REPORT_FUNC_SETUP_ERROR(file, line, func, msg, ...) \
-    do { \
-        _ERROR("%s l:%d (%s)\n\tError during funtion setup: " msg, file, line, func, ##__VA_ARGS__); \
-        abort(); \
-    } while (0)
-
+        if (!(e <= tol)) {
+            failed++;
+        }
 
+        if (e > max) {
+            max   = e;
+            worst = i;
+        }
+    }
 
+    // Values are printed with just enough digits to tell them apart
+    if (!array) {
+        snprintf(msg, sizeof(msg), "%s: %.*g vs %.*g, error %s", assertion,
+            single ? 9 : 17, single ? ((const float *)p1)[0] : ((const double *)p1)[0],
+            single ? 9 : 17, single ? ((const float *)p2)[0] : ((const double *)p2)[0],
+            _CUTL_FORMAT_NEAR_ERROR(kind, max, error, sizeof(error)));
 
-// ==========================================================================
-// MACROS FOR TESTING
-// ==========================================================================
+        _CUTL_REGISTER_TEST_FAILURE(line, msg);
+        return false;
+    }
 
+    for (i = 0; i < n; i++) {
+        double   e = _cutl_near_error_at(kind, single, p1, p2, i);
+        uint64_t bits;
+        int      exp;
 
-/**
- * Begins the testing mode
- */
-#define CUTL_BEGIN_TEST() \
-    do { \
-        /* Set report file */                   \
-        if (_cutl_report_file == NULL) {        \
-            _cutl_report_file = stdout;         \
-        }                                       \
-        else {                                  \
-            /* TODO : Change */                 \
-            _cutl_report_file = stdout;         \
-        }                                       \
-                                                \
-        /* Begin testing */                     \
-        _cutl_current_file = __FILE__;          \
-        _cutl_n_tests_passed = 0;               \
-        _cutl_n_tests_failed = 0;               \
-                                                \
-        _CUTL_REPORT_INFO("Testing " __FILE__); \
-                                                \
-        CUTL_BEFORE_ALL();                      \
-    } while (0)
+        if (e == 0) {
+            bins[0]++;
+            continue;
+        }
 
+        if (isinf(e)) {
+            bins[_CUTL_NEAR_BINS - 1]++;
+            continue;
+        }
 
+        memcpy(&bits, &e, sizeof(bits));
+        exp = (int)((bits >> 52) & 0x7ff) - 1023;
+        exp = (exp < _CUTL_NEAR_MIN_EXP) ? _CUTL_NEAR_MIN_EXP : (exp > _CUTL_NEAR_MAX_EXP) ? _CUTL_NEAR_MAX_EXP : exp;
 
-/**
- * Ends the testing mode
- */
-#define CUTL_END_TEST() \
-    do { \
-        CUTL_AFTER_ALL(); \
-        _CUTL_REPORT_INFO( \
-            "Tests passed: %u / %u (%s)", \
-            _cutl_n_tests_passed, \
-            _cutl_n_tests_passed + _cutl_n_tests_failed, \
-            cutl_failed() ? "ERR" : "OK" \
-        ); \
-    } while (0)
+        bins[exp - _CUTL_NEAR_MIN_EXP + 1]++;
+    }
 
+    used = snprintf(msg, sizeof(msg), "%s: %zu of %zu out of tolerance, the first at index %zu"
+                                      "\n\t  max error %s at index %zu: %.*g vs %.*g\n\t  errors:",
+        assertion, failed, n, first, _CUTL_FORMAT_NEAR_ERROR(kind, max, error, sizeof(error)), worst,
+        single ? 9 : 17, single ? ((const float *)p1)[worst] : ((const double *)p1)[worst],
+        single ? 9 : 17, single ? ((const float *)p2)[worst] : ((const double *)p2)[worst]);
+
+    for (b = 0; b < _CUTL_NEAR_BINS && used >= 0 && (size_t)used < sizeof(msg); b++) {
+        int exp = b - 1 + _CUTL_NEAR_MIN_EXP;
+
+        if (bins[b] == 0) {
+            continue;
+        }
+
+        if (b == 0) {
+            snprintf(error, sizeof(error), "0");
+        }
+        else if (b == _CUTL_NEAR_BINS - 1) {
+            snprintf(error, sizeof(error), "NaN/Inf");
+        }
+        else if (kind == _CUTL_NEAR_ULP) {
+            uint64_t low = (uint64_t)1 << exp;
+
+            snprintf(error, sizeof(error), (low == 1) ? "1" : "%llu-%llu",
+                (unsigned long long)low, (unsigned long long)(2 * low - 1));
+        }
+        else {
+            // The first bin takes all the errors below the bins after it
+            double low = 1;
+
+            for (; exp < 0; exp++) low /= 2;
+            for (; exp > 0; exp--) low *= 2;
+
+            snprintf(error, sizeof(error), (b == 1) ? "<%.1e" : "%.1e+", (b == 1) ? 2 * low : low);
+        }
+
+        // Bins that do not fit are left out, keeping room to tell
+        len = snprintf(entry, sizeof(entry), "%s %s: %zu", (msg[used - 1] == ':') ? "" : " |", error, bins[b]);
+
+        if ((size_t)(used + len) + 4 >= sizeof(msg)) {
+            snprintf(msg + used, sizeof(msg) - used, " ...");
+            break;
+        }
 
+        memcpy(msg + used, entry, (size_t)len + 1);
+        used += len;
+    }
 
-/**
- * Tests a function and reports its result. The function must not
- * return void, but can receive any amount of params.
- * 
- * If a failure ocurrs while the function is being executed, it will
- * be reported and the executing function will be aborted.
- * 
- * If an error ocurrs while the function is being executed, it will
- * be reported and the program will be aborted.
- */
-#define CUTL_TEST_FUNCTION(func, ...) \
-    do { \
-        _cutl_current_func = #func;         \
-        _cutl_current_line = __LINE__;      \
-                                            \
-        CUTL_BEFORE_EACH();                 \
-                                            \
-        _cutl_test_status = _CUTL_SUCCESS;  \
-                                            \
-        func(__VA_ARGS__);                \
-                                            \
-        _CUTL_REPORT_TEST_RESULT();         \
-                                            \
-        CUTL_AFTER_EACH();                  \
-    } while (0)
+    _CUTL_REGISTER_TEST_FAILURE(line, msg);
 
+    return false;
+}
 
+#endif /* _CUTL_IMPLEMENT */
 
-/**
- * Returns the number of failed tests
- */
-__CUTL_UNUSED int cutl_failed() {
-    return _cutl_n_tests_failed;
-}
 
 
 // ==========================================================================
@@ -514,205 +9697,387 @@ __CUTL_UNUSED int cutl_failed() {
 // ==========================================================================
 
 
+// Every assertion is written once, taking what to do when it fails: the
+// CUTL_ASSERT* ones return from the function, and the CUTL_THREAD_ASSERT*
+// ones leave it through _CUTL_THREAD_EXIT, which works from any thread.
+
+#define _CUTL_ASSERT_RETURN         return
+#define _CUTL_ASSERT_THREAD_EXIT    _CUTL_THREAD_EXIT()
+
+
 // General assertions
 
-#define CUTL_ASSERT(expr) \
+#define _CUTL_ASSERT(expr, bail) \
     do { \
         if (!(expr)) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT( " #expr " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-#define CUTL_ASSERT_EQ(v1, v2) \
+#define _CUTL_ASSERT_EQ(v1, v2, bail) \
     do { \
         if ((v1) != (v2)) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_EQ( " #v1 ", " #v2 " )"); \
-            return; \
+            bail; \
         }  \
     }while (0)
 
-#define CUTL_ASSERT_NEQ(v1, v2) \
+#define _CUTL_ASSERT_NEQ(v1, v2, bail) \
     do { \
         if ((v1) == (v2)) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_NEQ( " #v1 ", " #v2 " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-#define CUTL_ASSERT_NULL(v1) \
+#define _CUTL_ASSERT_NULL(v1, bail) \
     do { \
         if ((v1) != NULL) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_NULL( " #v1 " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-#define CUTL_ASSERT_NOT_NULL(v1) \
+#define _CUTL_ASSERT_NOT_NULL(v1, bail) \
     do { \
         if ((v1) == NULL) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_NOT_NULL( " #v1 " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-#define CUTL_ASSERT_TRUE(expr) \
+#define _CUTL_ASSERT_TRUE(expr, bail) \
     do { \
         if (!(expr)) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_TRUE( " #expr " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-#define CUTL_ASSERT_FALSE(expr) \
+#define _CUTL_ASSERT_FALSE(expr, bail) \
     do { \
         if ((expr)) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_FALSE( " #expr " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
 
 // (Specific type) Assert equal
 
-#define _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, type, macro_name) \
+#define _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, type, macro_name, bail) \
     do { \
         if ( ((type)(v1)) != ((type)(v2)) ) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, macro_name "( " #v1 ", " #v2 " )"); \
-            return; \
+            bail; \
         } \
     } while (0)
 
-
-
-#define CUTL_ASSERT_EQ_UINT(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_EQ_UINT")
-
-
-#define CUTL_ASSERT_EQ_INT(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_EQ_INT")
-
-
-#define CUTL_ASSERT_EQ_FLOAT(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_EQ_FLOAT")
-
-
-#define CUTL_ASSERT_EQ_DOUBLE(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_EQ_DOUBLE")
-
-
-#define CUTL_ASSERT_EQ_BOOL(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_EQ_BOOL")
-
-
-#define CUTL_ASSERT_EQ_CHAR(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_EQ_CHAR")
-
-
-#define CUTL_ASSERT_EQ_STR(v1, v2) \
+#define _CUTL_ASSERT_EQ_STR(v1, v2, bail) \
     do { \
         if (strcmp(v1, v2) != 0) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_EQ_STR( " #v1 ", " #v2 " )"); \
-            return;\
+            bail;\
         } \
     } while (0)
 
-
-#define CUTL_ASSERT_EQ_PTR(v1, v2) \
-    _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_EQ_PTR")
-
-
-#define CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type) \
+// Elements whose bytes are equal are skipped with memcmp() when that
+// implies their values are equal, and the rest are compared as type. The
+// ones around the first difference are shown as values of type.
+#define _CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type, bail) \
     do { \
-        for (int __i = 0; __i < n; __i++) { \
-            if ( (type)a1[__i] != (type)a2[__i]) { \
-                _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_EQ_ARRAY( " #a1 ", " #a2 " )"); \
+        size_t _cutl_n = ((n) > 0) ? (size_t)(n) : 0; \
+        size_t _cutl_i = 0; \
+        bool   _cutl_fast = (sizeof((a1)[0]) == sizeof(type) && sizeof((a2)[0]) == sizeof(type) \
+                             && !_CUTL_IS_FLOATING(type)); \
+        \
+        for (;; _cutl_i++) { \
+            if (_cutl_fast) { \
+                _cutl_i += _CUTL_MEM_MISMATCH(&(a1)[_cutl_i], &(a2)[_cutl_i], \
+                                              (_cutl_n - _cutl_i) * sizeof(type)) / sizeof(type); \
+            } \
+            if (_cutl_i >= _cutl_n || (type)(a1)[_cutl_i] != (type)(a2)[_cutl_i]) { \
+                break; \
+            } \
+        } \
+        \
+        if (_cutl_i < _cutl_n) { \
+            type   _cutl_w1[2 * _CUTL_WINDOW(sizeof(type)) + 1]; \
+            type   _cutl_w2[2 * _CUTL_WINDOW(sizeof(type)) + 1]; \
+            size_t _cutl_first = _CUTL_WINDOW_FIRST(_cutl_i, sizeof(type)); \
+            size_t _cutl_k; \
+            \
+            for (_cutl_k = 0; _cutl_k < sizeof(_cutl_w1) / sizeof(type) && _cutl_first + _cutl_k < _cutl_n; _cutl_k++) { \
+                _cutl_w1[_cutl_k] = (type)(a1)[_cutl_first + _cutl_k]; \
+                _cutl_w2[_cutl_k] = (type)(a2)[_cutl_first + _cutl_k]; \
             } \
+            \
+            _CUTL_REGISTER_MISMATCH(__LINE__, "ASSERT_EQ_ARRAY( " #a1 ", " #a2 " )", "index", #a1, _cutl_w1, \
+                #a2, _cutl_w2, sizeof(type), _CUTL_VALUE_KIND(type), _cutl_i, _cutl_n); \
+            bail; \
         } \
     } while (0)
 
-
-
-// (Specific type) Assert distinct
-
-#define _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, type, macro_name) \
+#define _CUTL_ASSERT_EQ_MEM(p1, p2, nbytes, bail) \
     do { \
-        if ( ((type)(v1)) == ((type)(v2)) ) { \
-            _CUTL_REGISTER_TEST_FAILURE(__LINE__, macro_name "( " #v1 ", " #v2 " )"); \
-            return; \
+        size_t _cutl_n = (size_t)(nbytes); \
+        size_t _cutl_i = _CUTL_MEM_MISMATCH(p1, p2, _cutl_n); \
+        \
+        if (_cutl_i < _cutl_n) { \
+            _CUTL_REGISTER_MISMATCH(__LINE__, "ASSERT_EQ_MEM( " #p1 ", " #p2 " )", "byte", \
+                #p1, (const unsigned char *)(p1) + _CUTL_WINDOW_FIRST(_cutl_i, 1), \
+                #p2, (const unsigned char *)(p2) + _CUTL_WINDOW_FIRST(_cutl_i, 1), 1, _CUTL_VALUE_BYTES, _cutl_i, _cutl_n); \
+            bail; \
         } \
     } while (0)
 
+#define _CUTL_ASSERT_MATCHES_SNAPSHOT(buf, len, name, bail) \
+    do { \
+        if (!_CUTL_CHECK_SNAPSHOT(__LINE__, "ASSERT_MATCHES_SNAPSHOT( " #buf ", " #name " )", \
+                buf, (size_t)(len), name)) { \
+            bail; \
+        } \
+    } while (0)
 
 
-#define CUTL_ASSERT_NEQ_UINT(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_NEQ_UINT")
-
-
-#define CUTL_ASSERT_NEQ_INT(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_NEQ_INT")
-
+// Tolerances, for floats and doubles
 
-#define CUTL_ASSERT_NEQ_FLOAT(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_NEQ_FLOAT")
+#define _CUTL_ASSERT_NEAR(v1, v2, tol, kind, type, assertion, bail) \
+    do { \
+        type _cutl_v1 = (type)(v1); \
+        type _cutl_v2 = (type)(v2); \
+        \
+        if (!_CUTL_CHECK_NEAR(__LINE__, assertion, kind, sizeof(type) == sizeof(float), \
+                &_cutl_v1, &_cutl_v2, 1, false, (double)(tol))) { \
+            bail; \
+        } \
+    } while (0)
 
+#define _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, kind, type, assertion, bail) \
+    do { \
+        const type *_cutl_a1 = (a1); \
+        const type *_cutl_a2 = (a2); \
+        \
+        if (!_CUTL_CHECK_NEAR(__LINE__, assertion, kind, sizeof(type) == sizeof(float), \
+                _cutl_a1, _cutl_a2, ((n) > 0) ? (size_t)(n) : 0, true, (double)(tol))) { \
+            bail; \
+        } \
+    } while (0)
 
-#define CUTL_ASSERT_NEQ_DOUBLE(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_NEQ_DOUBLE")
 
+// Allocation budgets, checked once the block that follows has run
 
-#define CUTL_ASSERT_NEQ_BOOL(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_NEQ_BOOL")
+#define _CUTL_ASSERT_ALLOC(max_count, max_bytes, assertion, bail) \
+    for (_cutl_alloc_scope_t _cutl_scope = _CUTL_ALLOC_SCOPE_START(); ; _cutl_scope.done = true) \
+        if (_cutl_scope.done) { \
+            if (!_CUTL_ALLOC_SCOPE_CHECK(&_cutl_scope, max_count, max_bytes, __LINE__, assertion)) { \
+                bail; \
+            } \
+            break; \
+        } \
+        else
 
 
-#define CUTL_ASSERT_NEQ_CHAR(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_NEQ_CHAR")
+// (Specific type) Assert distinct
 
+#define _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, type, macro_name, bail) \
+    do { \
+        if ( ((type)(v1)) == ((type)(v2)) ) { \
+            _CUTL_REGISTER_TEST_FAILURE(__LINE__, macro_name "( " #v1 ", " #v2 " )"); \
+            bail; \
+        } \
+    } while (0)
 
-#define CUTL_ASSERT_NEQ_STR(v1, v2) \
+#define _CUTL_ASSERT_NEQ_STR(v1, v2, bail) \
     do { \
         if (strcmp(v1, v2) == 0) { \
             _CUTL_REGISTER_TEST_FAILURE(__LINE__, "ASSERT_NEQ_STR( " #v1 ", " #v2 " )"); \
-            return;\
+            bail;\
         } \
     } while (0)
 
 
-#define CUTL_ASSERT_NEQ_PTR(v1, v2) \
-    _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_NEQ_PTR")
-
+// Assertions that return from the test function
+
+#define CUTL_ASSERT(expr)                            _CUTL_ASSERT(expr, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ(v1, v2)                       _CUTL_ASSERT_EQ(v1, v2, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ(v1, v2)                      _CUTL_ASSERT_NEQ(v1, v2, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NULL(v1)                         _CUTL_ASSERT_NULL(v1, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NOT_NULL(v1)                     _CUTL_ASSERT_NOT_NULL(v1, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_TRUE(expr)                       _CUTL_ASSERT_TRUE(expr, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_FALSE(expr)                      _CUTL_ASSERT_FALSE(expr, _CUTL_ASSERT_RETURN)
+
+#define CUTL_ASSERT_EQ_UINT(v1, v2)                  _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_EQ_UINT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_INT(v1, v2)                   _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_EQ_INT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_FLOAT(v1, v2)                 _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_EQ_FLOAT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_DOUBLE(v1, v2)                _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_EQ_DOUBLE", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_BOOL(v1, v2)                  _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_EQ_BOOL", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_CHAR(v1, v2)                  _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_EQ_CHAR", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_STR(v1, v2)                   _CUTL_ASSERT_EQ_STR(v1, v2, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_PTR(v1, v2)                   _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_EQ_PTR", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type)        _CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_EQ_MEM(p1, p2, nbytes)           _CUTL_ASSERT_EQ_MEM(p1, p2, nbytes, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_MATCHES_SNAPSHOT(buf, len, name) _CUTL_ASSERT_MATCHES_SNAPSHOT(buf, len, name, _CUTL_ASSERT_RETURN)
+
+#define CUTL_ASSERT_NEQ_UINT(v1, v2)                 _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_NEQ_UINT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_INT(v1, v2)                  _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_NEQ_INT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_FLOAT(v1, v2)                _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_NEQ_FLOAT", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_DOUBLE(v1, v2)               _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_NEQ_DOUBLE", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_BOOL(v1, v2)                 _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_NEQ_BOOL", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_CHAR(v1, v2)                 _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_NEQ_CHAR", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_STR(v1, v2)                  _CUTL_ASSERT_NEQ_STR(v1, v2, _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEQ_PTR(v1, v2)                  _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_NEQ_PTR", _CUTL_ASSERT_RETURN)
+
+#define CUTL_ASSERT_NEAR(v1, v2, tol)                _CUTL_ASSERT_NEAR(v1, v2, tol, _CUTL_NEAR_ABS, double, "ASSERT_NEAR( " #v1 ", " #v2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEAR_REL(v1, v2, tol)            _CUTL_ASSERT_NEAR(v1, v2, tol, _CUTL_NEAR_REL, double, "ASSERT_NEAR_REL( " #v1 ", " #v2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_ULP_LE(v1, v2, ulps)             _CUTL_ASSERT_NEAR(v1, v2, ulps, _CUTL_NEAR_ULP, double, "ASSERT_ULP_LE( " #v1 ", " #v2 ", " #ulps " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_ULP_LE_FLOAT(v1, v2, ulps)       _CUTL_ASSERT_NEAR(v1, v2, ulps, _CUTL_NEAR_ULP, float, "ASSERT_ULP_LE_FLOAT( " #v1 ", " #v2 ", " #ulps " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol)       _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_ABS, double, "ASSERT_NEAR_ARRAY( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_ABS, float, "ASSERT_NEAR_ARRAY_FLOAT( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol)   _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_REL, double, "ASSERT_NEAR_REL_ARRAY( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_REL, float, "ASSERT_NEAR_REL_ARRAY_FLOAT( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps)    _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, ulps, _CUTL_NEAR_ULP, double, "ASSERT_ULP_LE_ARRAY( " #a1 ", " #a2 ", " #ulps " )", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, ulps, _CUTL_NEAR_ULP, float, "ASSERT_ULP_LE_ARRAY_FLOAT( " #a1 ", " #a2 ", " #ulps " )", _CUTL_ASSERT_RETURN)
+
+#define CUTL_ASSERT_NO_ALLOC                         _CUTL_ASSERT_ALLOC(0, UINT64_MAX, "ASSERT_NO_ALLOC", _CUTL_ASSERT_RETURN)
+#define CUTL_ASSERT_ALLOC_BYTES_LE(n)                _CUTL_ASSERT_ALLOC(UINT64_MAX, n, "ASSERT_ALLOC_BYTES_LE( " #n " )", _CUTL_ASSERT_RETURN)
+
+
+// Assertions that can be used from any thread
+
+#define CUTL_THREAD_ASSERT(expr)                     _CUTL_ASSERT(expr, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ(v1, v2)                _CUTL_ASSERT_EQ(v1, v2, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ(v1, v2)               _CUTL_ASSERT_NEQ(v1, v2, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NULL(v1)                  _CUTL_ASSERT_NULL(v1, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NOT_NULL(v1)              _CUTL_ASSERT_NOT_NULL(v1, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_TRUE(expr)                _CUTL_ASSERT_TRUE(expr, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_FALSE(expr)               _CUTL_ASSERT_FALSE(expr, _CUTL_ASSERT_THREAD_EXIT)
+
+#define CUTL_THREAD_ASSERT_EQ_UINT(v1, v2)           _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_EQ_UINT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_INT(v1, v2)            _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_EQ_INT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_FLOAT(v1, v2)          _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_EQ_FLOAT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_DOUBLE(v1, v2)         _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_EQ_DOUBLE", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_BOOL(v1, v2)           _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_EQ_BOOL", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_CHAR(v1, v2)           _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_EQ_CHAR", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_STR(v1, v2)            _CUTL_ASSERT_EQ_STR(v1, v2, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_PTR(v1, v2)            _CUTL_ASSERT_EQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_EQ_PTR", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_ARRAY(a1, a2, n, type) _CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_EQ_MEM(p1, p2, nbytes)    _CUTL_ASSERT_EQ_MEM(p1, p2, nbytes, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_MATCHES_SNAPSHOT(buf, len, name) _CUTL_ASSERT_MATCHES_SNAPSHOT(buf, len, name, _CUTL_ASSERT_THREAD_EXIT)
+
+#define CUTL_THREAD_ASSERT_NEQ_UINT(v1, v2)          _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, unsigned long long, "ASSERT_NEQ_UINT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_INT(v1, v2)           _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, long long, "ASSERT_NEQ_INT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_FLOAT(v1, v2)         _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, float, "ASSERT_NEQ_FLOAT", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_DOUBLE(v1, v2)        _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, double, "ASSERT_NEQ_DOUBLE", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_BOOL(v1, v2)          _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, bool, "ASSERT_NEQ_BOOL", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_CHAR(v1, v2)          _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, char, "ASSERT_NEQ_CHAR", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_STR(v1, v2)           _CUTL_ASSERT_NEQ_STR(v1, v2, _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEQ_PTR(v1, v2)           _CUTL_ASSERT_NEQ_SPECIFIC_TYPE(v1, v2, void *, "ASSERT_NEQ_PTR", _CUTL_ASSERT_THREAD_EXIT)
+
+#define CUTL_THREAD_ASSERT_NEAR(v1, v2, tol)         _CUTL_ASSERT_NEAR(v1, v2, tol, _CUTL_NEAR_ABS, double, "ASSERT_NEAR( " #v1 ", " #v2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEAR_REL(v1, v2, tol)     _CUTL_ASSERT_NEAR(v1, v2, tol, _CUTL_NEAR_REL, double, "ASSERT_NEAR_REL( " #v1 ", " #v2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_ULP_LE(v1, v2, ulps)      _CUTL_ASSERT_NEAR(v1, v2, ulps, _CUTL_NEAR_ULP, double, "ASSERT_ULP_LE( " #v1 ", " #v2 ", " #ulps " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_ULP_LE_FLOAT(v1, v2, ulps) _CUTL_ASSERT_NEAR(v1, v2, ulps, _CUTL_NEAR_ULP, float, "ASSERT_ULP_LE_FLOAT( " #v1 ", " #v2 ", " #ulps " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEAR_ARRAY(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_ABS, double, "ASSERT_NEAR_ARRAY( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_ABS, float, "ASSERT_NEAR_ARRAY_FLOAT( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_REL, double, "ASSERT_NEAR_REL_ARRAY( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol, _CUTL_NEAR_REL, float, "ASSERT_NEAR_REL_ARRAY_FLOAT( " #a1 ", " #a2 ", " #tol " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, ulps, _CUTL_NEAR_ULP, double, "ASSERT_ULP_LE_ARRAY( " #a1 ", " #a2 ", " #ulps " )", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps) _CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, ulps, _CUTL_NEAR_ULP, float, "ASSERT_ULP_LE_ARRAY_FLOAT( " #a1 ", " #a2 ", " #ulps " )", _CUTL_ASSERT_THREAD_EXIT)
+
+#define CUTL_THREAD_ASSERT_NO_ALLOC                  _CUTL_ASSERT_ALLOC(0, UINT64_MAX, "ASSERT_NO_ALLOC", _CUTL_ASSERT_THREAD_EXIT)
+#define CUTL_THREAD_ASSERT_ALLOC_BYTES_LE(n)         _CUTL_ASSERT_ALLOC(UINT64_MAX, n, "ASSERT_ALLOC_BYTES_LE( " #n " )", _CUTL_ASSERT_THREAD_EXIT)
 
 
 
 #if defined(CUTL_NO_PREFIXED_ASSERTIONS)
 
-    #define ASSERT(expr)                CUTL_ASSERT(expr)
-    #define ASSERT_EQ(v1, v2)           CUTL_ASSERT_EQ(v1, v2)
-    #define ASSERT_NEQ(v1, v2)          CUTL_ASSERT_NEQ(v1, v2)
-    #define ASSERT_NULL(v1)             CUTL_ASSERT_NULL(v1)
-    #define ASSERT_NOT_NULL(v1)         CUTL_ASSERT_NOT_NULL(v1)
-    #define ASSERT_TRUE(expr)           CUTL_ASSERT_TRUE(expr)
-    #define ASSERT_FALSE(expr)          CUTL_ASSERT_FALSE(expr)
-
-    #define ASSERT_EQ_UINT(v1, v2)      CUTL_ASSERT_EQ_UINT(v1, v2)
-    #define ASSERT_EQ_INT(v1, v2)       CUTL_ASSERT_EQ_INT(v1, v2)
-    #define ASSERT_EQ_FLOAT(v1, v2)     CUTL_ASSERT_EQ_FLOAT(v1, v2)
-    #define ASSERT_EQ_DOUBLE(v1, v2)    CUTL_ASSERT_EQ_DOUBLE(v1, v2)
-    #define ASSERT_EQ_BOOL(v1, v2)      CUTL_ASSERT_EQ_BOOL(v1, v2)
-    #define ASSERT_EQ_CHAR(v1, v2)      CUTL_ASSERT_EQ_CHAR(v1, v2)
-    #define ASSERT_EQ_STR(v1, v2)       CUTL_ASSERT_EQ_STR(v1, v2)
-    #define ASSERT_EQ_PTR(v1, v2)       CUTL_ASSERT_EQ_PTR(v1, v2)
-
-    #define ASSERT_EQ_ARRAY(a1, a2, n, type)    CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type)
-
-    #define ASSERT_NEQ_UINT(v1, v2)     CUTL_ASSERT_NEQ_UINT(v1, v2)
-    #define ASSERT_NEQ_INT(v1, v2)      CUTL_ASSERT_NEQ_INT(v1, v2)
-    #define ASSERT_NEQ_FLOAT(v1, v2)    CUTL_ASSERT_NEQ_FLOAT(v1, v2)
-    #define ASSERT_NEQ_DOUBLE(v1, v2)   CUTL_ASSERT_NEQ_DOUBLE(v1, v2)
-    #define ASSERT_NEQ_BOOL(v1, v2)     CUTL_ASSERT_NEQ_BOOL(v1, v2)
-    #define ASSERT_NEQ_CHAR(v1, v2)     CUTL_ASSERT_NEQ_CHAR(v1, v2)
-    #define ASSERT_NEQ_STR(v1, v2)      CUTL_ASSERT_NEQ_STR(v1, v2)
-    #define ASSERT_NEQ_PTR(v1, v2)      CUTL_ASSERT_NEQ_PTR(v1, v2)
+    #define ASSERT(expr)                               CUTL_ASSERT(expr)
+    #define ASSERT_EQ(v1, v2)                          CUTL_ASSERT_EQ(v1, v2)
+    #define ASSERT_NEQ(v1, v2)                         CUTL_ASSERT_NEQ(v1, v2)
+    #define ASSERT_NULL(v1)                            CUTL_ASSERT_NULL(v1)
+    #define ASSERT_NOT_NULL(v1)                        CUTL_ASSERT_NOT_NULL(v1)
+    #define ASSERT_TRUE(expr)                          CUTL_ASSERT_TRUE(expr)
+    #define ASSERT_FALSE(expr)                         CUTL_ASSERT_FALSE(expr)
+
+    #define ASSERT_EQ_UINT(v1, v2)                     CUTL_ASSERT_EQ_UINT(v1, v2)
+    #define ASSERT_EQ_INT(v1, v2)                      CUTL_ASSERT_EQ_INT(v1, v2)
+    #define ASSERT_EQ_FLOAT(v1, v2)                    CUTL_ASSERT_EQ_FLOAT(v1, v2)
+    #define ASSERT_EQ_DOUBLE(v1, v2)                   CUTL_ASSERT_EQ_DOUBLE(v1, v2)
+    #define ASSERT_EQ_BOOL(v1, v2)                     CUTL_ASSERT_EQ_BOOL(v1, v2)
+    #define ASSERT_EQ_CHAR(v1, v2)                     CUTL_ASSERT_EQ_CHAR(v1, v2)
+    #define ASSERT_EQ_STR(v1, v2)                      CUTL_ASSERT_EQ_STR(v1, v2)
+    #define ASSERT_EQ_PTR(v1, v2)                      CUTL_ASSERT_EQ_PTR(v1, v2)
+    #define ASSERT_EQ_ARRAY(a1, a2, n, type)           CUTL_ASSERT_EQ_ARRAY(a1, a2, n, type)
+    #define ASSERT_EQ_MEM(p1, p2, nbytes)              CUTL_ASSERT_EQ_MEM(p1, p2, nbytes)
+    #define ASSERT_MATCHES_SNAPSHOT(buf, len, name)    CUTL_ASSERT_MATCHES_SNAPSHOT(buf, len, name)
+
+    #define ASSERT_NEQ_UINT(v1, v2)                    CUTL_ASSERT_NEQ_UINT(v1, v2)
+    #define ASSERT_NEQ_INT(v1, v2)                     CUTL_ASSERT_NEQ_INT(v1, v2)
+    #define ASSERT_NEQ_FLOAT(v1, v2)                   CUTL_ASSERT_NEQ_FLOAT(v1, v2)
+    #define ASSERT_NEQ_DOUBLE(v1, v2)                  CUTL_ASSERT_NEQ_DOUBLE(v1, v2)
+    #define ASSERT_NEQ_BOOL(v1, v2)                    CUTL_ASSERT_NEQ_BOOL(v1, v2)
+    #define ASSERT_NEQ_CHAR(v1, v2)                    CUTL_ASSERT_NEQ_CHAR(v1, v2)
+    #define ASSERT_NEQ_STR(v1, v2)                     CUTL_ASSERT_NEQ_STR(v1, v2)
+    #define ASSERT_NEQ_PTR(v1, v2)                     CUTL_ASSERT_NEQ_PTR(v1, v2)
+
+    #define ASSERT_NEAR(v1, v2, tol)                   CUTL_ASSERT_NEAR(v1, v2, tol)
+    #define ASSERT_NEAR_REL(v1, v2, tol)               CUTL_ASSERT_NEAR_REL(v1, v2, tol)
+    #define ASSERT_ULP_LE(v1, v2, ulps)                CUTL_ASSERT_ULP_LE(v1, v2, ulps)
+    #define ASSERT_ULP_LE_FLOAT(v1, v2, ulps)          CUTL_ASSERT_ULP_LE_FLOAT(v1, v2, ulps)
+    #define ASSERT_NEAR_ARRAY(a1, a2, n, tol)          CUTL_ASSERT_NEAR_ARRAY(a1, a2, n, tol)
+    #define ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol)    CUTL_ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol)
+    #define ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol)      CUTL_ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol)
+    #define ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol) CUTL_ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol)
+    #define ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps)       CUTL_ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps)
+    #define ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps) CUTL_ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps)
+
+    #define ASSERT_NO_ALLOC                            CUTL_ASSERT_NO_ALLOC
+    #define ASSERT_ALLOC_BYTES_LE(n)                   CUTL_ASSERT_ALLOC_BYTES_LE(n)
+
+    #define THREAD_ASSERT(expr)                        CUTL_THREAD_ASSERT(expr)
+    #define THREAD_ASSERT_EQ(v1, v2)                   CUTL_THREAD_ASSERT_EQ(v1, v2)
+    #define THREAD_ASSERT_NEQ(v1, v2)                  CUTL_THREAD_ASSERT_NEQ(v1, v2)
+    #define THREAD_ASSERT_NULL(v1)                     CUTL_THREAD_ASSERT_NULL(v1)
+    #define THREAD_ASSERT_NOT_NULL(v1)                 CUTL_THREAD_ASSERT_NOT_NULL(v1)
+    #define THREAD_ASSERT_TRUE(expr)                   CUTL_THREAD_ASSERT_TRUE(expr)
+    #define THREAD_ASSERT_FALSE(expr)                  CUTL_THREAD_ASSERT_FALSE(expr)
+
+    #define THREAD_ASSERT_EQ_UINT(v1, v2)              CUTL_THREAD_ASSERT_EQ_UINT(v1, v2)
+    #define THREAD_ASSERT_EQ_INT(v1, v2)               CUTL_THREAD_ASSERT_EQ_INT(v1, v2)
+    #define THREAD_ASSERT_EQ_FLOAT(v1, v2)             CUTL_THREAD_ASSERT_EQ_FLOAT(v1, v2)
+    #define THREAD_ASSERT_EQ_DOUBLE(v1, v2)            CUTL_THREAD_ASSERT_EQ_DOUBLE(v1, v2)
+    #define THREAD_ASSERT_EQ_BOOL(v1, v2)              CUTL_THREAD_ASSERT_EQ_BOOL(v1, v2)
+    #define THREAD_ASSERT_EQ_CHAR(v1, v2)              CUTL_THREAD_ASSERT_EQ_CHAR(v1, v2)
+    #define THREAD_ASSERT_EQ_STR(v1, v2)               CUTL_THREAD_ASSERT_EQ_STR(v1, v2)
+    #define THREAD_ASSERT_EQ_PTR(v1, v2)               CUTL_THREAD_ASSERT_EQ_PTR(v1, v2)
+    #define THREAD_ASSERT_EQ_ARRAY(a1, a2, n, type)    CUTL_THREAD_ASSERT_EQ_ARRAY(a1, a2, n, type)
+    #define THREAD_ASSERT_EQ_MEM(p1, p2, nbytes)       CUTL_THREAD_ASSERT_EQ_MEM(p1, p2, nbytes)
+    #define THREAD_ASSERT_MATCHES_SNAPSHOT(buf, len, name) CUTL_THREAD_ASSERT_MATCHES_SNAPSHOT(buf, len, name)
+
+    #define THREAD_ASSERT_NEQ_UINT(v1, v2)             CUTL_THREAD_ASSERT_NEQ_UINT(v1, v2)
+    #define THREAD_ASSERT_NEQ_INT(v1, v2)              CUTL_THREAD_ASSERT_NEQ_INT(v1, v2)
+    #define THREAD_ASSERT_NEQ_FLOAT(v1, v2)            CUTL_THREAD_ASSERT_NEQ_FLOAT(v1, v2)
+    #define THREAD_ASSERT_NEQ_DOUBLE(v1, v2)           CUTL_THREAD_ASSERT_NEQ_DOUBLE(v1, v2)
+    #define THREAD_ASSERT_NEQ_BOOL(v1, v2)             CUTL_THREAD_ASSERT_NEQ_BOOL(v1, v2)
+    #define THREAD_ASSERT_NEQ_CHAR(v1, v2)             CUTL_THREAD_ASSERT_NEQ_CHAR(v1, v2)
+    #define THREAD_ASSERT_NEQ_STR(v1, v2)              CUTL_THREAD_ASSERT_NEQ_STR(v1, v2)
+    #define THREAD_ASSERT_NEQ_PTR(v1, v2)              CUTL_THREAD_ASSERT_NEQ_PTR(v1, v2)
+
+    #define THREAD_ASSERT_NEAR(v1, v2, tol)            CUTL_THREAD_ASSERT_NEAR(v1, v2, tol)
+    #define THREAD_ASSERT_NEAR_REL(v1, v2, tol)        CUTL_THREAD_ASSERT_NEAR_REL(v1, v2, tol)
+    #define THREAD_ASSERT_ULP_LE(v1, v2, ulps)         CUTL_THREAD_ASSERT_ULP_LE(v1, v2, ulps)
+    #define THREAD_ASSERT_ULP_LE_FLOAT(v1, v2, ulps)   CUTL_THREAD_ASSERT_ULP_LE_FLOAT(v1, v2, ulps)
+    #define THREAD_ASSERT_NEAR_ARRAY(a1, a2, n, tol)   CUTL_THREAD_ASSERT_NEAR_ARRAY(a1, a2, n, tol)
+    #define THREAD_ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol) CUTL_THREAD_ASSERT_NEAR_ARRAY_FLOAT(a1, a2, n, tol)
+    #define THREAD_ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol) CUTL_THREAD_ASSERT_NEAR_REL_ARRAY(a1, a2, n, tol)
+    #define THREAD_ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol) CUTL_THREAD_ASSERT_NEAR_REL_ARRAY_FLOAT(a1, a2, n, tol)
+    #define THREAD_ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps) CUTL_THREAD_ASSERT_ULP_LE_ARRAY(a1, a2, n, ulps)
+    #define THREAD_ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps) CUTL_THREAD_ASSERT_ULP_LE_ARRAY_FLOAT(a1, a2, n, ulps)
+
+    #define THREAD_ASSERT_NO_ALLOC                     CUTL_THREAD_ASSERT_NO_ALLOC
+    #define THREAD_ASSERT_ALLOC_BYTES_LE(n)            CUTL_THREAD_ASSERT_ALLOC_BYTES_LE(n)
 
 #endif /* CUTL_NO_PREFIXED_ASSERTIONS */
 
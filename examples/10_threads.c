@@ -0,0 +1,137 @@
+/**
+ * Check concurrent code with assertions from several threads.
+ *
+ * THREAD_ASSERT* can be used from any thread started by a test.
+ * The first failure is the one reported and the rest are only
+ * counted. When it fails, the thread that made the assertion
+ * ends, so it must be joined as usual.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+#define QUEUE_SIZE  64
+#define N_ITEMS     10000
+
+
+/* A bounded queue shared by a producer and a consumer */
+typedef struct {
+    unsigned int    items[QUEUE_SIZE];
+    unsigned int    head;
+    unsigned int    tail;
+    bool            closed;
+    pthread_mutex_t lock;
+    pthread_cond_t  changed;
+} queue_t;
+
+static queue_t queue;
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+
+void CUTL_BEFORE_EACH() {
+    queue.head = queue.tail = 0;
+    queue.closed = false;
+    pthread_mutex_init(&queue.lock, NULL);
+    pthread_cond_init(&queue.changed, NULL);
+}
+
+void CUTL_AFTER_EACH() {
+    pthread_mutex_destroy(&queue.lock);
+    pthread_cond_destroy(&queue.changed);
+}
+
+
+/* Test functions declaration */
+static void test_queue_order(unsigned int capacity);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_queue_order, QUEUE_SIZE);
+    CUTL_TEST_FUNCTION(test_queue_order, QUEUE_SIZE + 1);  // Overwrites items before they are read
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+static unsigned int capacity;
+
+static void *producer(void *arg) {
+    unsigned int i;
+
+    for (i = 0; i < N_ITEMS; i++) {
+        pthread_mutex_lock(&queue.lock);
+
+        while (queue.tail - queue.head == capacity && !queue.closed) {
+            pthread_cond_wait(&queue.changed, &queue.lock);
+        }
+
+        if (queue.closed) {
+            pthread_mutex_unlock(&queue.lock);
+            break;
+        }
+
+        queue.items[queue.tail++ % QUEUE_SIZE] = i;
+
+        pthread_cond_broadcast(&queue.changed);
+        pthread_mutex_unlock(&queue.lock);
+    }
+
+    return arg;
+}
+
+
+static void *consumer(void *arg) {
+    unsigned int i, item;
+
+    for (i = 0; i < N_ITEMS; i++) {
+        pthread_mutex_lock(&queue.lock);
+
+        while (queue.tail == queue.head) {
+            pthread_cond_wait(&queue.changed, &queue.lock);
+        }
+
+        item = queue.items[queue.head++ % QUEUE_SIZE];
+
+        pthread_cond_broadcast(&queue.changed);
+        pthread_mutex_unlock(&queue.lock);
+
+        // The lock is released first, as the thread ends on failure
+        THREAD_ASSERT_EQ_UINT(item, i);
+    }
+
+    return arg;
+}
+
+
+/**
+ * Items must come out of the queue in the same order they were put in.
+ * If the consumer fails, the producer is unblocked by closing the queue.
+ */
+static void test_queue_order(unsigned int queue_capacity) {
+    pthread_t producer_thread, consumer_thread;
+
+    capacity = queue_capacity;
+
+    pthread_create(&producer_thread, NULL, producer, NULL);
+    pthread_create(&consumer_thread, NULL, consumer, NULL);
+
+    pthread_join(consumer_thread, NULL);
+
+    pthread_mutex_lock(&queue.lock);
+    queue.closed = true;
+    pthread_cond_broadcast(&queue.changed);
+    pthread_mutex_unlock(&queue.lock);
+
+    pthread_join(producer_thread, NULL);
+}
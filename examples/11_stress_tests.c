@@ -0,0 +1,90 @@
+/**
+ * Stress-test code shared by several threads.
+ *
+ * CUTL_STRESS calls a function from a number of threads at
+ * once and reports the throughput. CUTL_STRESS_SWEEP does it
+ * for every number of threads up to the given one, to see
+ * how the code scales.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+#define N_THREADS       4
+#define N_ITERATIONS    100000
+
+
+/* Counters to increment concurrently */
+typedef struct {
+    unsigned long   value;
+    pthread_mutex_t lock;
+} counter_t;
+
+static counter_t counter;
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  { pthread_mutex_init(&counter.lock, NULL); }
+void CUTL_AFTER_ALL()   { pthread_mutex_destroy(&counter.lock); }
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void increment_atomic(void *arg);
+static void increment_locked(void *arg);
+static void test_counter(unsigned long expected);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    counter.value = 0;
+    CUTL_STRESS(increment_atomic, N_THREADS, N_ITERATIONS, &counter);
+    CUTL_TEST_FUNCTION(test_counter, N_THREADS * N_ITERATIONS);
+
+    CUTL_STRESS_SWEEP(increment_locked, N_THREADS, N_ITERATIONS, &counter);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Functions under stress take a single pointer, given as the
+ * last param of the macro
+ */
+static void increment_atomic(void *arg) {
+    counter_t *c = (counter_t *)arg;
+
+    __atomic_fetch_add(&c->value, 1, __ATOMIC_RELAXED);
+}
+
+
+/**
+ * Assertions inside them must be THREAD_ASSERT*, which can be
+ * used from any thread
+ */
+static void increment_locked(void *arg) {
+    counter_t    *c = (counter_t *)arg;
+    unsigned long before;
+
+    pthread_mutex_lock(&c->lock);
+    before = c->value++;
+    pthread_mutex_unlock(&c->lock);
+
+    THREAD_ASSERT_NEQ_UINT(before + 1, 0);
+}
+
+
+/**
+ * No increment must be lost
+ */
+static void test_counter(unsigned long expected) {
+    ASSERT_EQ_UINT(counter.value, expected);
+}
@@ -0,0 +1,109 @@
+/**
+ * Track the memory allocated by each test.
+ *
+ * With CUTL_TRACK_ALLOC defined before including CutL, every
+ * test reports how many allocations it made, how many bytes
+ * it requested and the most it had in use at once. A test
+ * that leaves blocks allocated after CUTL_AFTER_EACH is an
+ * error. ASSERT_NO_ALLOC and ASSERT_ALLOC_BYTES_LE check the
+ * allocations of a block of code.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#define CUTL_TRACK_ALLOC
+#include <cutl.h>
+
+
+/* A growable buffer of ints */
+typedef struct {
+    int    *items;
+    size_t  size;
+    size_t  capacity;
+} vector_t;
+
+static vector_t vector;
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+
+void CUTL_BEFORE_EACH() {
+    vector.capacity = 16;
+    vector.size     = 0;
+    vector.items    = malloc(vector.capacity * sizeof(int));
+}
+
+void CUTL_AFTER_EACH() {
+    free(vector.items);
+}
+
+
+/* Test functions declaration */
+static void test_push_within_capacity(void);
+static void test_push_growing(size_t n);
+static void test_copy(void);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_push_within_capacity);
+    CUTL_TEST_FUNCTION(test_push_growing, 1000);
+    CUTL_TEST_FUNCTION(test_copy);  // Leaks the copy
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+static void push(vector_t *v, int item) {
+    if (v->size == v->capacity) {
+        v->capacity *= 2;
+        v->items = realloc(v->items, v->capacity * sizeof(int));
+    }
+
+    v->items[v->size++] = item;
+}
+
+
+/**
+ * The fast path must not allocate
+ */
+static void test_push_within_capacity(void) {
+    ASSERT_NO_ALLOC {
+        push(&vector, 1);
+        push(&vector, 2);
+    }
+
+    ASSERT_EQ_UINT(vector.size, 2);
+}
+
+
+/**
+ * Growing the buffer is bounded by a budget
+ */
+static void test_push_growing(size_t n) {
+    size_t i;
+
+    ASSERT_ALLOC_BYTES_LE(16 * 1024) {
+        for (i = 0; i < n; i++) {
+            push(&vector, (int)i);
+        }
+    }
+
+    ASSERT_EQ_UINT(vector.size, n);
+}
+
+
+static void test_copy(void) {
+    int *copy = malloc(sizeof(int) * 16);
+
+    memcpy(copy, vector.items, sizeof(int) * 16);
+
+    ASSERT_NOT_NULL(copy);
+}
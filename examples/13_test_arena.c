@@ -0,0 +1,90 @@
+/**
+ * Allocate temporary memory for a test without freeing it.
+ *
+ * Memory from cutl_arena_alloc() lasts until the end of the
+ * test, and it is all freed at once after CUTL_AFTER_EACH.
+ * Failed assertions return early without leaking, and each
+ * allocation costs little more than moving a pointer.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* A singly linked list of words */
+typedef struct node {
+    const char  *word;
+    struct node *next;
+} node_t;
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_split(const char *text, unsigned int expected_words);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_split, "the quick brown fox", 4);
+    CUTL_TEST_FUNCTION(test_split, "  jumps   over ", 2);
+    CUTL_TEST_FUNCTION(test_split, "the lazy dog", 4);     // Fails, leaking nothing
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Splits a text into a list of words, all of them allocated
+ * from the test arena
+ */
+static node_t *split(const char *text) {
+    node_t  *head = NULL;
+    node_t **tail = &head;
+
+    while (*text != '\0') {
+        size_t len = strcspn(text, " ");
+
+        if (len > 0) {
+            char   *word = cutl_arena_alloc(len + 1);
+            node_t *node = cutl_arena_alloc(sizeof(node_t));
+
+            memcpy(word, text, len);
+            word[len] = '\0';
+
+            node->word = word;
+            node->next = NULL;
+
+            *tail = node;
+            tail  = &node->next;
+        }
+
+        text += len + (text[len] == ' ');
+    }
+
+    return head;
+}
+
+
+static void test_split(const char *text, unsigned int expected_words) {
+    node_t      *node;
+    unsigned int n = 0;
+
+    for (node = split(text); node != NULL; node = node->next) {
+        ASSERT_NEQ_CHAR(node->word[0], '\0');
+        n++;
+    }
+
+    ASSERT_EQ_UINT(n, expected_words);
+}
@@ -0,0 +1,96 @@
+/**
+ * Count the CPU events behind the time a test takes.
+ *
+ * With CUTL_FLAG_PERF, each test shows the cycles,
+ * instructions, branch misses and cache misses of its
+ * function, and benchmarks show them per operation. Where
+ * the hardware counters cannot be used, as in most
+ * containers, the task clock and page faults are shown.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+#define N_VALUES (1 << 22)
+
+
+static unsigned int *values;
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL() {
+    unsigned int i;
+
+    values = malloc(N_VALUES * sizeof(unsigned int));
+
+    for (i = 0; i < N_VALUES; i++) {
+        values[i] = i;
+    }
+}
+
+void CUTL_AFTER_ALL() {
+    free(values);
+}
+
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_sum(unsigned int stride);
+static void count_odd(unsigned int *count);
+
+
+int main() {
+    unsigned int count = 0;
+
+    cutl_config(CUTL_FLAG_PERF);
+
+    CUTL_BEGIN_TEST();
+
+    // Same sum, but the second one misses the cache on every value
+    CUTL_TEST_FUNCTION(test_sum, 1);
+    CUTL_TEST_FUNCTION(test_sum, 4099);
+
+    CUTL_BENCH(count_odd, &count);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Sums all the values, visiting them in steps of the given
+ * stride, which must be odd to reach all of them
+ */
+static void test_sum(unsigned int stride) {
+    unsigned long long sum = 0;
+    unsigned int       i, j = 0;
+
+    for (i = 0; i < N_VALUES; i++) {
+        sum += values[j];
+        j = (j + stride) & (N_VALUES - 1);
+    }
+
+    ASSERT_EQ_UINT(sum, (unsigned long long)N_VALUES * (N_VALUES - 1) / 2);
+}
+
+
+/**
+ * Counts the odd values among the first thousand, with a
+ * branch that is hard to predict
+ */
+static void count_odd(unsigned int *count) {
+    unsigned int i;
+
+    for (i = 0; i < 1000; i++) {
+        if ((values[(i * 2654435761u) & (N_VALUES - 1)] & 1) != 0) {
+            (*count)++;
+        }
+    }
+}
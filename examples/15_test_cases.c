@@ -0,0 +1,77 @@
+/**
+ * Run a test function on every record of a case file.
+ *
+ * The file is mapped into memory and each record is handed
+ * over where it is, without copies. Records of .tsv files are
+ * lines with fields separated by tabs; any other file holds
+ * records prefixed by their size (32-bit little-endian).
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_parse_hex(const cutl_case_t *record);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    // Found next to this file; one of its cases fails
+    CUTL_TEST_CASES(test_parse_hex, "15_test_cases.tsv");
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Parses a hexadecimal number of the given length, which does
+ * not need to end in '\0'. Returns -1 if it is not valid.
+ */
+static int parse_hex(const char *text, size_t len) {
+    int    value = 0;
+    size_t i;
+
+    if (len == 0) {
+        return -1;
+    }
+
+    for (i = 0; i < len; i++) {
+        char c = text[i];
+
+        if (c >= '0' && c <= '9') {
+            value = value * 16 + (c - '0');
+        }
+        else if (c >= 'a' && c <= 'f') {
+            value = value * 16 + (c - 'a' + 10);
+        }
+        else {
+            return -1;
+        }
+    }
+
+    return value;
+}
+
+
+static void test_parse_hex(const cutl_case_t *record) {
+    size_t      text_len, expected_len;
+    const char *text     = cutl_case_field(record, 0, &text_len);
+    const char *expected = cutl_case_field(record, 1, &expected_len);
+
+    ASSERT_NOT_NULL(expected);
+    ASSERT_EQ_INT(parse_hex(text, text_len), atoi(expected));
+}
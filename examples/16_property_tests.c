@@ -0,0 +1,80 @@
+/**
+ * Test properties that hold for any input, on random ones.
+ *
+ * CUTL_PROPERTY calls a test function with thousands of
+ * arguments made by generators. Once a case fails, it is
+ * shrunk to the simplest one that still fails, which is
+ * reported along with the seed that replays it (CUTL_SEED).
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_reverse_twice(const char *text);
+static void test_midpoint(unsigned int a, unsigned int b);
+
+
+int main() {
+    CUTL_BEGIN_TEST();
+
+    CUTL_PROPERTY(test_reverse_twice, cutl_gen_string(32));
+    CUTL_PROPERTY(test_midpoint, cutl_gen_int(0, UINT32_MAX), cutl_gen_int(0, UINT32_MAX));    // Fails
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Reverses a string in place
+ */
+static void reverse(char *text) {
+    size_t i, len = strlen(text);
+
+    for (i = 0; i < len / 2; i++) {
+        char c = text[i];
+
+        text[i] = text[len - 1 - i];
+        text[len - 1 - i] = c;
+    }
+}
+
+
+/**
+ * Returns the number halfway between a and b, or so it seems
+ */
+static unsigned int midpoint(unsigned int a, unsigned int b) {
+    return (a + b) / 2;     // Wraps around when a + b does not fit
+}
+
+
+static void test_reverse_twice(const char *text) {
+    char copy[64];
+
+    strcpy(copy, text);
+    reverse(copy);
+    reverse(copy);
+
+    ASSERT_EQ_STR(copy, text);
+}
+
+
+static void test_midpoint(unsigned int a, unsigned int b) {
+    unsigned int mid = midpoint(a, b);
+
+    ASSERT(mid >= (a < b ? a : b));
+    ASSERT(mid <= (a < b ? b : a));
+}
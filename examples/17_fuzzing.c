@@ -0,0 +1,79 @@
+/**
+ * Fuzz a test function that takes any bytes as input.
+ *
+ * Normal runs replay the inputs of the corpus directory.
+ * Run with --fuzz=SECONDS to mutate them in search of one
+ * that fails, which is saved there for later runs to replay.
+ * The Makefile builds this example with coverage feedback
+ * (-fsanitize-coverage=trace-pc), which guides mutations
+ * towards inputs that take new paths through the code.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_decode(const uint8_t *data, size_t size);
+
+
+int main(int argc, char **argv) {
+    cutl_args(argc, argv);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_FUZZ(test_decode, "17_fuzzing_corpus");
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Decodes run-length encoded text, such as "3a2b" for "aaabb".
+ * Returns the length decoded, or -1 if the text is malformed or
+ * does not fit.
+ */
+static int decode(const uint8_t *text, size_t len, char *out, size_t size) {
+    size_t i = 0, used = 0;
+
+    while (i < len) {
+        size_t count = 0;
+
+        while (i < len && text[i] >= '0' && text[i] <= '9' && count < size) {
+            count = 10 * count + (text[i++] - '0');
+        }
+
+        if (i == len || count == 0 || count > size - used) {
+            return -1;
+        }
+
+        memset(out + used, text[i++], count);
+        used += count;
+    }
+
+    return (int)used;
+}
+
+
+static void test_decode(const uint8_t *data, size_t size) {
+    char out[64];
+    int  len = decode(data, size, out, sizeof(out));
+
+    ASSERT(len >= -1 && len <= (int)sizeof(out));
+
+    if (len >= 0) {
+        ASSERT(size == 0 || len > 0);
+    }
+}
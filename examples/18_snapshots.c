@@ -0,0 +1,105 @@
+/**
+ * Compare generated output with golden files kept next to the tests.
+ *
+ * ASSERT_MATCHES_SNAPSHOT(buf, len, name) fails when the bytes given are
+ * not those of the file name, relative to the directory of the file being
+ * tested. The failure tells the first line where they differ:
+ *
+ *     ASSERT_MATCHES_SNAPSHOT( ... ): differs from examples/18_snapshots/receipt.txt at line 3, ...
+ *       expected: Tea              2 x   1.50 =   3.00
+ *       actual:   Tea              2 x   1.50 =   3.10
+ *
+ * Run with --update-snapshots (or CUTL_SNAPSHOT_UPDATE=1) to write the
+ * files of the snapshots that do not match, then review them with git.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_receipt();
+static void test_histogram();
+
+
+int main(int argc, char **argv) {
+    cutl_args(argc, argv);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_receipt);
+    CUTL_TEST_FUNCTION(test_histogram);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+typedef struct item {
+    const char *name;
+    int         quantity;
+    int         cents;
+} item_t;
+
+
+/**
+ * Writes a receipt for the given items into text. Returns its length.
+ */
+static size_t render_receipt(const item_t *items, int n, char *text, size_t size) {
+    size_t used  = 0;
+    int    total = 0;
+    int    i;
+
+    used += snprintf(text + used, size - used, "%-16s %3s   %6s   %6s\n", "Item", "Qty", "Price", "Amount");
+
+    for (i = 0; i < n; i++) {
+        int amount = items[i].quantity * items[i].cents;
+
+        used += snprintf(text + used, size - used, "%-16s %3d x %3d.%02d = %3d.%02d\n", items[i].name,
+            items[i].quantity, items[i].cents / 100, items[i].cents % 100, amount / 100, amount % 100);
+        total += amount;
+    }
+
+    used += snprintf(text + used, size - used, "%-34s %3d.%02d\n", "Total", total / 100, total % 100);
+
+    return used;
+}
+
+
+static void test_receipt() {
+    const item_t items[] = {
+        { "Coffee", 3, 120 },
+        { "Tea",    2, 150 },
+        { "Cake",   1, 325 },
+    };
+    char   text[512];
+    size_t len = render_receipt(items, 3, text, sizeof(text));
+
+    ASSERT_MATCHES_SNAPSHOT(text, len, "18_snapshots/receipt.txt");
+}
+
+
+/* Snapshots are compared byte by byte, so they can hold binary data too */
+static void test_histogram() {
+    uint32_t counts[256] = { 0 };
+    uint32_t seed = 1;
+    int      i;
+
+    for (i = 0; i < 100000; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        counts[seed >> 24]++;
+    }
+
+    ASSERT_MATCHES_SNAPSHOT(counts, sizeof(counts), "18_snapshots/histogram.bin");
+}
@@ -0,0 +1,78 @@
+/**
+ * Run the tests on several machines. One process, the coordinator,
+ * hands the tests out to the workers that connect to it, and reports
+ * their results as if it had run them:
+ *
+ *   ./19_distributed --coordinator=:7357                (on one machine)
+ *   ./19_distributed --worker=coordinator-host:7357     (on every other)
+ *
+ * Workers can also run on the same machine, through a Unix socket:
+ *
+ *   ./19_distributed --coordinator=unix:/tmp/19.sock &
+ *   ./19_distributed --worker=unix:/tmp/19.sock &
+ *   ./19_distributed --worker=unix:/tmp/19.sock
+ *
+ * Without options, the tests run in this process as usual.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called. Every worker runs its own CUTL_BEFORE_ALL and
+ * CUTL_AFTER_ALL */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_count_primes(unsigned int limit, unsigned int expected);
+
+
+int main(int argc, char **argv) {
+    cutl_args(argc, argv);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_count_primes, 10, 4);
+    CUTL_TEST_FUNCTION(test_count_primes, 100, 25);
+    CUTL_TEST_FUNCTION(test_count_primes, 1000, 168);
+    CUTL_TEST_FUNCTION(test_count_primes, 10000, 1229);
+    CUTL_TEST_FUNCTION(test_count_primes, 100000, 9592);
+    CUTL_TEST_FUNCTION(test_count_primes, 1000000, 78498);
+    CUTL_TEST_FUNCTION(test_count_primes, 2000000, 148933);
+    CUTL_TEST_FUNCTION(test_count_primes, 4000000, 283146);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Counts the primes up to limit by trial division, slow enough for
+ * the work to be worth spreading
+ */
+static void test_count_primes(unsigned int limit, unsigned int expected) {
+    unsigned int count = 0;
+
+    for (unsigned int n = 2; n <= limit; n++) {
+        bool prime = true;
+
+        for (unsigned int d = 2; d * d <= n; d++) {
+            if (n % d == 0) {
+                prime = false;
+                break;
+            }
+        }
+
+        count += prime;
+    }
+
+    ASSERT_EQ_UINT(count, expected);
+}
@@ -0,0 +1,9 @@
+/**
+ * The only copy of CutL, shared by the rest of the files of the
+ * suite. It holds no tests.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_IMPLEMENTATION
+#include <cutl.h>
@@ -0,0 +1,29 @@
+/**
+ * Run the tests of several files from a single program. Every
+ * file is built with CUTL_SPLIT defined, and cutl.c holds the
+ * only copy of CutL, which the rest share:
+ *
+ *   gcc -DCUTL_SPLIT -o 20_suites cutl.c main.c stack.c strings.c -I ../..
+ *
+ * The tests registered in stack.c and strings.c run from the
+ * CUTL_MAIN() of this file. Each file is a suite, with special
+ * functions of its own, and its results are summed up on their
+ * own before the total.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#include <stdio.h>
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions of the whole run. Those of each file run
+ * around its own tests */
+void CUTL_BEFORE_ALL()  { printf("Inside CUTL_BEFORE_ALL of main.c\n"); }
+void CUTL_AFTER_ALL()   { printf("Inside CUTL_AFTER_ALL of main.c\n");  }
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+CUTL_MAIN()
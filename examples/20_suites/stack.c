@@ -0,0 +1,53 @@
+/**
+ * A suite of tests of a stack, run by main.c
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#include <stdio.h>
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+typedef struct {
+    int    *items;
+    size_t  size;
+} int_stack_t;
+
+static int_stack_t stack;
+
+
+/* Only run around the tests of this file */
+void CUTL_BEFORE_ALL() {
+    printf("Inside CUTL_BEFORE_ALL of stack.c\n");
+    stack.items = malloc(64 * sizeof(int));
+}
+
+void CUTL_AFTER_ALL() {
+    printf("Inside CUTL_AFTER_ALL of stack.c\n");
+    free(stack.items);
+}
+
+void CUTL_BEFORE_EACH() { stack.size = 0; }
+void CUTL_AFTER_EACH()  {}
+
+
+static void push(int item) { stack.items[stack.size++] = item; }
+static int  pop(void)      { return stack.items[--stack.size]; }
+
+
+CUTL_TEST(test_push) {
+    push(1);
+    push(2);
+
+    ASSERT_EQ_UINT(stack.size, 2);
+}
+
+CUTL_TEST(test_pop) {
+    push(1);
+    push(2);
+
+    ASSERT_EQ_INT(pop(), 2);
+    ASSERT_EQ_INT(pop(), 1);
+    ASSERT_EQ_UINT(stack.size, 0);
+}
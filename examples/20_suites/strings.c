@@ -0,0 +1,25 @@
+/**
+ * A suite of tests of strings, run by main.c
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#include <stdio.h>
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Only run around the tests of this file */
+void CUTL_BEFORE_ALL()  { printf("Inside CUTL_BEFORE_ALL of strings.c\n"); }
+void CUTL_AFTER_ALL()   { printf("Inside CUTL_AFTER_ALL of strings.c\n");  }
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+CUTL_TEST(test_strlen, fast) {
+    ASSERT_EQ_UINT(strlen("CutL"), 4);
+}
+
+CUTL_TEST(test_strcmp, fast) {
+    ASSERT_EQ_STR("CutL", "cutl");  // Fails
+}
@@ -0,0 +1,50 @@
+/**
+ * Do not run again the tests that passed in a previous run of
+ * the same program. Their keys are kept in a cache file:
+ *
+ *   ./21_result_cache --cache=/tmp/21.cache     (runs them all)
+ *   ./21_result_cache --cache=/tmp/21.cache     (runs the failed)
+ *
+ * Every call of a test is told apart, even those made in a loop
+ * with the same params as written, so a failed one always runs
+ * again. Rebuilding the program clears the cache.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_is_even(int n);
+
+
+int main(int argc, char **argv) {
+    int i;
+
+    cutl_args(argc, argv);
+
+    CUTL_BEGIN_TEST();
+
+    for (i = 0; i < 4; i++) {
+        CUTL_TEST_FUNCTION(test_is_even, i);    // Fails for 1 and 3
+    }
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+void test_is_even(int n) {
+    ASSERT_EQ_INT(n % 2, 0);
+}
@@ -21,6 +21,7 @@ static void test_general_assertions_success();
 static void test_typed_assertions_success();
 static void test_assertion_failure();
 static void test_assertion_array_eq();
+static void test_assertion_near();
 
 
 int main() {
@@ -30,6 +31,7 @@ int main() {
     CUTL_TEST_FUNCTION(test_typed_assertions_success);
     CUTL_TEST_FUNCTION(test_assertion_failure);
     CUTL_TEST_FUNCTION(test_assertion_array_eq);
+    CUTL_TEST_FUNCTION(test_assertion_near);
 
     CUTL_END_TEST();
 
@@ -131,4 +133,23 @@ void test_assertion_array_eq() {
     ASSERT_EQ_ARRAY(array1, array2, n, int);    // Expected to PASS
     ASSERT_EQ_ARRAY(array1, array3, n, int);    // Expected to FAIL
     ASSERT_EQ_ARRAY(array1, array4, n, int);    // Expected to FAIL
-}
\ No newline at end of file
+}
+
+
+/**
+ * Results of floating point operations are rarely exact, so
+ * they are better compared within a tolerance: an absolute
+ * one, one relative to the values, or a number of ULPs (units
+ * in the last place, i.e. representable values in between).
+ */
+void test_assertion_near() {
+    double a[] = { 0.1 + 0.2, 1e10 + 1, 0.0 };
+    double b[] = { 0.3,       1e10,     -0.0 };
+
+    ASSERT_NEAR(a[0], b[0], 1e-12);
+    ASSERT_NEAR_REL(a[1], b[1], 1e-9);
+    ASSERT_ULP_LE(a[0], b[0], 1);
+
+    // Arrays report how many elements are off and by how much
+    ASSERT_NEAR_REL_ARRAY(a, b, 3, 1e-9);
+}
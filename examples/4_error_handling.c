@@ -44,6 +44,7 @@ void test_with_error() {
     int *numbers = failing_malloc();
     if (numbers == NULL) {
         // Free memory and other resources before calling CUTL_REPORT_ERROR
+        // (memory from cutl_arena_alloc() is freed after the test anyway)
         CUTL_REPORT_ERROR("Memory allocation error");
     }
 
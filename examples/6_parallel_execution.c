@@ -0,0 +1,71 @@
+/**
+ * Run the tests on a pool of worker processes. The number of
+ * workers can be set with cutl_config_workers() or with the
+ * CUTL_WORKERS environment variable.
+ *
+ * Results are reported in the same order as the tests are
+ * called, once all of them have finished. A test that crashes
+ * only takes down its worker: it is reported as an error, and
+ * the rest of the tests run in the other workers.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_collatz(unsigned long long n, unsigned int expected_steps);
+static void test_crash(void);
+
+
+int main() {
+    cutl_config(CUTL_FLAG_PARALLEL);
+    cutl_config_workers(4);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_collatz, 27, 111);
+    CUTL_TEST_FUNCTION(test_collatz, 97, 118);
+    CUTL_TEST_FUNCTION(test_collatz, 871, 178);
+    CUTL_TEST_FUNCTION(test_collatz, 6171, 261);
+    CUTL_TEST_FUNCTION(test_crash);  // Error
+    CUTL_TEST_FUNCTION(test_collatz, 77031, 350);
+    CUTL_TEST_FUNCTION(test_collatz, 837799, 524);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Tests are independent from each other, so they can run in
+ * any worker and in any order.
+ */
+void test_collatz(unsigned long long n, unsigned int expected_steps) {
+    unsigned int steps = 0;
+
+    while (n != 1) {
+        n = (n % 2 == 0) ? n / 2 : 3 * n + 1;
+        steps++;
+    }
+
+    ASSERT_EQ_UINT(steps, expected_steps);
+}
+
+
+void test_crash(void) {
+    volatile int *null = NULL;
+
+    *null = 1;
+}
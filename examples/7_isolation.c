@@ -0,0 +1,74 @@
+/**
+ * Run every test in its own copy of the process, taken right
+ * after CUTL_BEFORE_ALL. Tests always start from the same state,
+ * and a crashing test is reported as an error instead of ending
+ * the whole execution.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Data shared by all tests, built only once */
+static int *squares = NULL;
+
+#define N_SQUARES 1000
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL() {
+    squares = malloc(N_SQUARES * sizeof(int));
+
+    for (int i = 0; i < N_SQUARES; i++) {
+        squares[i] = i * i;
+    }
+}
+
+void CUTL_AFTER_ALL()   { free(squares); }
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Test functions declaration */
+static void test_overwrite_data();  // Expected to PASS
+static void test_data_unchanged();  // Expected to PASS
+static void test_crash();           // Expected to ERROR
+
+
+int main() {
+    cutl_config(CUTL_FLAG_ISOLATE);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_overwrite_data);
+    CUTL_TEST_FUNCTION(test_crash);
+    CUTL_TEST_FUNCTION(test_data_unchanged);
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+/**
+ * Changes made by a test are only seen by that test
+ */
+void test_overwrite_data() {
+    memset(squares, 0, N_SQUARES * sizeof(int));
+    ASSERT_EQ_INT(squares[10], 0);
+}
+
+/**
+ * Dereferences a NULL pointer
+ */
+void test_crash() {
+    int *volatile ptr = NULL;
+    ASSERT_EQ_INT(*ptr, 0);
+}
+
+void test_data_unchanged() {
+    ASSERT_EQ_INT(squares[10], 100);
+}
@@ -0,0 +1,62 @@
+/**
+ * Define tests with CUTL_TEST instead of calling each one of them
+ * from main(). Registered tests can be given tags, and the test
+ * program can select which tests to run from the command line:
+ *
+ *   ./8_registered_tests --list
+ *   ./8_registered_tests --filter=test_str*
+ *   ./8_registered_tests --tags=math,-slow
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Tests can have any number of tags, or none at all */
+CUTL_TEST(test_addition, math, fast) {
+    ASSERT_EQ_INT(1 + 2, 3);
+}
+
+CUTL_TEST(test_factorial, math, slow) {
+    unsigned long long factorial = 1;
+
+    for (unsigned int i = 2; i <= 20; i++) {
+        factorial *= i;
+    }
+
+    ASSERT_EQ_UINT(factorial, 2432902008176640000ULL);
+}
+
+CUTL_TEST(test_strlen, strings) {
+    ASSERT_EQ_UINT(strlen("CutL"), 4);
+}
+
+CUTL_TEST(test_strcmp) {
+    ASSERT_EQ_STR("CutL", "CutL");
+}
+
+
+/* Generates a main() function that runs the registered tests. It is
+ * the same as:
+ *
+ *     int main(int argc, char **argv) {
+ *         cutl_args(argc, argv);
+ *
+ *         CUTL_BEGIN_TEST();
+ *         CUTL_RUN_REGISTERED();
+ *         CUTL_END_TEST();
+ *
+ *         return cutl_failed();
+ *     }
+ */
+CUTL_MAIN()
@@ -0,0 +1,73 @@
+/**
+ * Benchmark functions along with the tests. CUTL_BENCH calls the
+ * function repeatedly and reports how long each call takes.
+ *
+ * Compile with optimizations to get meaningful numbers.
+ *
+ * Run it once with CUTL_BASELINE_UPDATE=1 to store the results as
+ * a baseline. Later runs fail the benchmarks that got slower.
+ *
+ * Date:    2026-10-17
+ * Version: 1.0
+ */
+#define CUTL_NO_PREFIXED_ASSERTIONS
+#include <cutl.h>
+
+
+/* Special functions to run before or after the test functions
+ * are called */
+void CUTL_BEFORE_ALL()  {}
+void CUTL_AFTER_ALL()   {}
+void CUTL_BEFORE_EACH() {}
+void CUTL_AFTER_EACH()  {}
+
+
+/* Function to test */
+static uint32_t fnv1a(const char *str) {
+    uint32_t hash = 2166136261u;
+
+    while (*str != '\0') {
+        hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    }
+
+    return hash;
+}
+
+
+/* Test and benchmark functions declaration */
+static void test_fnv1a();
+static void bench_fnv1a(const char *str);
+
+
+int main() {
+    // 20 samples of 5 ms each
+    cutl_config_bench(20, 5);
+
+    // Fail if the median gets more than 10% slower, unless the
+    // difference is within 3 standard errors
+    cutl_config_baseline("9_benchmarks.baseline", 0.10, 3);
+
+    CUTL_BEGIN_TEST();
+
+    CUTL_TEST_FUNCTION(test_fnv1a);
+    CUTL_BENCH(bench_fnv1a, "CutL");
+    CUTL_BENCH(bench_fnv1a, "A simple library for C unit tests");
+
+    CUTL_END_TEST();
+
+    return cutl_failed();
+}
+
+
+void test_fnv1a() {
+    ASSERT_EQ_UINT(fnv1a(""), 2166136261u);
+    ASSERT_EQ_UINT(fnv1a("a"), 0xe40c292cu);
+}
+
+/**
+ * The result must be used somehow, or the compiler could skip
+ * the call altogether
+ */
+void bench_fnv1a(const char *str) {
+    CUTL_DO_NOT_OPTIMIZE(fnv1a(str));
+}